@@ -0,0 +1,10 @@
+uniform sampler2D Texture0;
+
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+void main(void)
+{
+    FragColor = texture(Texture0, TexCoord);
+}
@@ -0,0 +1,25 @@
+// The same filter as compute-blur.comp, fetching every tap from the texture
+uniform highp sampler2D Source;
+
+// (1, 0) to filter along the rows, (0, 1) along the columns
+uniform ivec2 Direction;
+
+const int Radius = $RADIUS$;
+const float Kernel[Radius + 1] = float[Radius + 1]($KERNEL$);
+
+out vec4 FragColor;
+
+void main(void)
+{
+    ivec2 size = textureSize(Source, 0) - 1;
+    ivec2 p = ivec2(gl_FragCoord.xy);
+
+    vec4 sum = texelFetch(Source, p, 0) * Kernel[0];
+    for (int k = 1; k <= Radius; k++) {
+        ivec2 offset = Direction * k;
+        sum += (texelFetch(Source, clamp(p - offset, ivec2(0), size), 0) +
+                texelFetch(Source, clamp(p + offset, ivec2(0), size), 0)) * Kernel[k];
+    }
+
+    FragColor = sum;
+}
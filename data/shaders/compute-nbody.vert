@@ -0,0 +1,14 @@
+in vec4 position;
+
+uniform mat4 ViewProjectionMatrix;
+
+out vec3 Color;
+
+void main(void)
+{
+    // Fade the particles with their distance from the center
+    float r = clamp(length(position.xyz), 0.0, 1.0);
+    Color = mix(vec3(1.0, 0.9, 0.6), vec3(0.3, 0.5, 1.0), r);
+    gl_PointSize = 2.0;
+    gl_Position = ViewProjectionMatrix * vec4(position.xyz, 1.0);
+}
@@ -0,0 +1,16 @@
+
+uniform vec3 AmbientColor;
+
+out vec4 FragColor;
+
+void main(void)
+{
+    vec2 uv = gl_FragCoord.xy * InverseViewport;
+    if (texture(GBufferDepth, uv).r == 1.0) {
+        FragColor = vec4(AmbientColor, 1.0);
+        return;
+    }
+
+    Surface s = read_gbuffer();
+    FragColor = vec4(AmbientColor * s.albedo.rgb * (0.6 + 0.4 * s.normal.y), 1.0);
+}
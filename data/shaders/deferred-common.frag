@@ -0,0 +1,40 @@
+uniform sampler2D GBufferAlbedo;
+uniform sampler2D GBufferNormal;
+uniform highp sampler2D GBufferDepth;
+uniform mat4 InverseProjectionMatrix;
+uniform vec2 InverseViewport;
+
+struct Surface {
+    vec3 position;
+    vec3 normal;
+    vec4 albedo;
+};
+
+Surface read_gbuffer(void)
+{
+    vec2 uv = gl_FragCoord.xy * InverseViewport;
+    float depth = texture(GBufferDepth, uv).r;
+    vec4 p = InverseProjectionMatrix * vec4(2.0 * vec3(uv, depth) - 1.0, 1.0);
+
+    Surface s;
+    s.position = p.xyz / p.w;
+    s.normal = normalize(2.0 * texture(GBufferNormal, uv).xyz - 1.0);
+    s.albedo = texture(GBufferAlbedo, uv);
+    return s;
+}
+
+// Blinn-Phong with a smooth falloff to zero at the light radius
+vec3 shade(Surface s, vec4 light_position, vec3 light_color)
+{
+    vec3 L = light_position.xyz - s.position;
+    float dist = length(L);
+    float falloff = max(1.0 - dist / light_position.w, 0.0);
+    falloff *= falloff;
+
+    L /= max(dist, 0.0001);
+    vec3 H = normalize(L - normalize(s.position));
+    float diffuse = max(dot(s.normal, L), 0.0);
+    float specular = s.albedo.a * pow(max(dot(s.normal, H), 0.0), 32.0);
+
+    return falloff * light_color * (diffuse * s.albedo.rgb + specular);
+}
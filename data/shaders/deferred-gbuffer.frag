@@ -0,0 +1,20 @@
+uniform vec4 MaterialColor;
+uniform float Checker;
+
+in vec3 Normal;
+in vec2 FloorCoord;
+
+layout(location = 0) out vec4 Albedo;
+layout(location = 1) out vec4 NormalOut;
+
+void main(void)
+{
+    // Checker the floor, the model has a plain material
+    vec2 cell = floor(4.0 * FloorCoord);
+    float check = mod(cell.x + cell.y, 2.0);
+    vec3 color = MaterialColor.rgb * (1.0 - 0.4 * Checker * check);
+
+    // The alpha holds the specular strength
+    Albedo = vec4(color, MaterialColor.a);
+    NormalOut = vec4(0.5 * normalize(Normal) + 0.5, 1.0);
+}
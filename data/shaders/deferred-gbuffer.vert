@@ -0,0 +1,16 @@
+in vec3 position;
+in vec3 normal;
+
+uniform mat4 ModelViewProjectionMatrix;
+uniform mat4 NormalMatrix;
+uniform mat4 ModelMatrix;
+
+out vec3 Normal;
+out vec2 FloorCoord;
+
+void main(void)
+{
+    Normal = (NormalMatrix * vec4(normal, 0.0)).xyz;
+    FloorCoord = (ModelMatrix * vec4(position, 1.0)).xz;
+    gl_Position = ModelViewProjectionMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,17 @@
+in vec3 position;
+in vec4 light_position;
+in vec4 light_color;
+
+uniform mat4 ProjectionMatrix;
+
+flat out vec4 LightPosition;
+flat out vec4 LightColor;
+
+void main(void)
+{
+    // A cube bounding the sphere of influence of the light, in view space
+    LightPosition = light_position;
+    LightColor = light_color;
+    vec3 pos = light_position.xyz + light_position.w * position;
+    gl_Position = ProjectionMatrix * vec4(pos, 1.0);
+}
@@ -0,0 +1,36 @@
+
+// The lights and the per-tile light lists, built on the CPU every frame
+uniform highp sampler2D LightData;
+uniform highp sampler2D TileHeaders;
+uniform highp sampler2D TileIndices;
+uniform int TileSize;
+
+out vec4 FragColor;
+
+const int DataWidth = $DATA_WIDTH$;
+
+ivec2 data_coord(int texel)
+{
+    return ivec2(texel % DataWidth, texel / DataWidth);
+}
+
+void main(void)
+{
+    Surface s = read_gbuffer();
+    vec3 color = vec3(0.0);
+
+    // x: the offset of the list in the indices, y: the number of lights
+    vec4 header = texelFetch(TileHeaders, ivec2(gl_FragCoord.xy) / TileSize, 0);
+    int offset = int(header.x);
+    int count = int(header.y);
+
+    for (int i = 0; i < count; i++) {
+        int n = offset + i;
+        int light = int(texelFetch(TileIndices, data_coord(n / 4), 0)[n % 4]);
+        vec4 position = texelFetch(LightData, data_coord(2 * light), 0);
+        vec4 light_color = texelFetch(LightData, data_coord(2 * light + 1), 0);
+        color += shade(s, position, light_color.rgb);
+    }
+
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,11 @@
+
+flat in vec4 LightPosition;
+flat in vec4 LightColor;
+
+out vec4 FragColor;
+
+void main(void)
+{
+    Surface s = read_gbuffer();
+    FragColor = vec4(shade(s, LightPosition, LightColor.rgb), 1.0);
+}
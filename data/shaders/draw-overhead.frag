@@ -0,0 +1,9 @@
+uniform sampler2D Texture0;
+uniform vec4 Color;
+
+varying vec2 TextureCoord;
+
+void main(void)
+{
+    gl_FragColor = Color * texture2D(Texture0, TextureCoord);
+}
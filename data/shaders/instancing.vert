@@ -0,0 +1,34 @@
+in vec3 position;
+in vec3 normal;
+
+$INSTANCE_INPUT$
+
+uniform mat4 ViewProjectionMatrix;
+uniform float Time;
+
+out vec3 Color;
+
+void main(void)
+{
+    // The model matrix of the instance: its scale, orientation and position
+    mat4 model = $INSTANCE_DATA$;
+    float phase = dot(model[3].xy, vec2(0.37, 1.91));
+
+    // Spin each cube around its own y axis
+    float angle = Time + phase;
+    float c = cos(angle);
+    float s = sin(angle);
+    mat3 rotation = mat3(c, 0.0, -s,
+                         0.0, 1.0, 0.0,
+                         s, 0.0, c);
+
+    vec4 pos = model * vec4(rotation * position, 1.0);
+    vec3 N = normalize(mat3(model) * (rotation * normal));
+
+    const vec3 L = vec3(0.267, 0.535, 0.802);
+    float diffuse = max(dot(N, L), 0.0);
+    vec3 base = 0.5 + 0.5 * cos(vec3(0.0, 2.0, 4.0) + phase);
+
+    Color = (0.3 + 0.7 * diffuse) * base;
+    gl_Position = ViewProjectionMatrix * pos;
+}
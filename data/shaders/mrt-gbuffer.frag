@@ -0,0 +1,17 @@
+uniform float Time;
+
+in vec2 TexCoord;
+
+layout(location = 0) out vec4 Target[$NUM_TARGETS$];
+
+void main(void)
+{
+    // A rippling surface, stored the way a deferred renderer would store it
+    vec2 p = 8.0 * TexCoord + vec2(Time, -0.5 * Time);
+    float height = sin(p.x) * cos(p.y);
+    vec3 normal = normalize(vec3(-cos(p.x) * cos(p.y), sin(p.x) * sin(p.y), 2.0));
+    vec3 albedo = 0.5 + 0.5 * cos(vec3(0.0, 2.0, 4.0) + 3.0 * TexCoord.xyx);
+    vec2 velocity = 0.5 + 0.5 * vec2(cos(p.x), -sin(p.y));
+
+$TARGET_WRITES$
+}
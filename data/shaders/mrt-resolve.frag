@@ -0,0 +1,25 @@
+uniform sampler2D GBuffer[$NUM_TARGETS$];
+
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+void main(void)
+{
+    vec3 albedo = vec3(0.8);
+    vec3 normal = vec3(0.0, 0.0, 1.0);
+    vec4 material = vec4(1.0, 0.5, 0.0, 1.0);
+    vec3 extra = vec3(0.0);
+
+$GBUFFER_READS$
+
+    const vec3 L = vec3(0.267, 0.535, 0.802);
+    const vec3 H = vec3(0.139, 0.279, 0.950);
+    vec3 N = normalize(normal);
+    float diffuse = max(dot(N, L), 0.0);
+    float specular = pow(max(dot(N, H), 0.0), 8.0 + 56.0 * material.y);
+
+    vec3 color = albedo * (0.2 + 0.8 * diffuse) * material.x +
+                 0.3 * specular + 0.05 * extra;
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,7 @@
+// Nothing is rasterized while the particles are updated
+out vec4 FragColor;
+
+void main(void)
+{
+    FragColor = vec4(0.0);
+}
@@ -0,0 +1,55 @@
+// Advances a particle by one time step, respawning it at the emitter
+// when its life is over. The new state is captured with transform feedback.
+in vec4 position;   // xyz: the position, w: the remaining life
+in vec4 velocity;
+
+uniform int Frame;
+uniform float TimeStep;
+
+out vec4 NewPosition;
+out vec4 NewVelocity;
+
+const float Gravity = 2.5;
+const float Restitution = 0.6;
+
+uint hash(uint x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float random(inout uint seed)
+{
+    seed = hash(seed);
+    return float(seed >> 8) * (1.0 / 16777216.0);
+}
+
+void main(void)
+{
+    vec3 p = position.xyz;
+    vec3 v = velocity.xyz;
+    float life = position.w - TimeStep;
+
+    v.y -= Gravity * TimeStep;
+    p += v * TimeStep;
+
+    // Bounce off the floor
+    if (p.y < 0.0) {
+        p.y = -p.y;
+        v.y = -Restitution * v.y;
+    }
+
+    if (life <= 0.0) {
+        uint seed = uint(gl_VertexID) ^ hash(uint(Frame));
+        life = 1.5 + 1.5 * random(seed);
+        p = vec3(0.0);
+        v = vec3(random(seed) - 0.5, 2.5 + random(seed), random(seed) - 0.5);
+    }
+
+    NewPosition = vec4(p, life);
+    NewVelocity = vec4(v, 0.0);
+}
@@ -0,0 +1,14 @@
+in vec4 position;   // xyz: the position, w: the remaining life
+
+uniform mat4 ViewProjectionMatrix;
+
+out vec4 Color;
+
+void main(void)
+{
+    // Cool down from white to red as the particle ages
+    float heat = clamp(position.w / 3.0, 0.0, 1.0);
+    Color = vec4(1.0, 0.3 + 0.7 * heat, 0.1 + 0.9 * heat * heat, 1.0);
+    gl_PointSize = 2.0;
+    gl_Position = ViewProjectionMatrix * vec4(position.xyz, 1.0);
+}
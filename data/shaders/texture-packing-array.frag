@@ -0,0 +1,14 @@
+#ifdef GL_ES
+precision mediump sampler2DArray;
+#endif
+
+uniform sampler2DArray Texture0;
+
+in vec3 TextureCoord;
+
+out vec4 FragColor;
+
+void main(void)
+{
+    FragColor = texture(Texture0, TextureCoord);
+}
@@ -0,0 +1,11 @@
+in vec3 position;
+in vec3 texcoord;
+
+out vec3 TextureCoord;
+
+void main(void)
+{
+    gl_Position = vec4(position, 1.0);
+
+    TextureCoord = texcoord;
+}
@@ -0,0 +1,11 @@
+attribute vec3 position;
+attribute vec3 texcoord;
+
+varying vec2 TextureCoord;
+
+void main(void)
+{
+    gl_Position = vec4(position, 1.0);
+
+    TextureCoord = texcoord.xy;
+}
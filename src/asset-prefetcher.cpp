@@ -0,0 +1,206 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "asset-prefetcher.h"
+#include "benchmark.h"
+#include "model.h"
+#include "options.h"
+#include "texture.h"
+#include "util.h"
+
+#include <istream>
+#include <memory>
+#include <mutex>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <time.h>
+#endif
+
+namespace
+{
+
+/*
+ * The CPU time of all the prefetching threads so far, as published by the
+ * threads themselves after each asset.
+ */
+std::mutex prefetch_mutex;
+double prefetch_user_time = 0.0;
+double prefetch_system_time = 0.0;
+
+#ifndef _WIN32
+/*
+ * The CPU clock of the running prefetching thread, and its reading when
+ * the thread last published its times, so that the time the thread has
+ * used while preparing an asset can be sampled from other threads too.
+ */
+bool prefetch_running = false;
+clockid_t prefetch_clock;
+double prefetch_clock_published = 0.0;
+
+double
+clock_seconds(clockid_t clock)
+{
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0)
+        return -1.0;
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+#endif
+
+/**
+ * Adds the CPU time the calling thread has used since the tracker was
+ * created to the prefetching totals.
+ */
+class CpuTimeTracker
+{
+public:
+    CpuTimeTracker()
+    {
+        std::lock_guard<std::mutex> lock(prefetch_mutex);
+        user_base_ = prefetch_user_time;
+        system_base_ = prefetch_system_time;
+        Util::get_thread_times(&user_start_, &system_start_);
+#ifndef _WIN32
+        if (pthread_getcpuclockid(pthread_self(), &prefetch_clock) == 0) {
+            prefetch_running = true;
+            prefetch_clock_published = clock_seconds(prefetch_clock);
+        }
+#endif
+    }
+
+    ~CpuTimeTracker()
+    {
+        update();
+#ifndef _WIN32
+        std::lock_guard<std::mutex> lock(prefetch_mutex);
+        prefetch_running = false;
+#endif
+    }
+
+    void update()
+    {
+        double user, system;
+        Util::get_thread_times(&user, &system);
+
+        std::lock_guard<std::mutex> lock(prefetch_mutex);
+        prefetch_user_time = user_base_ + user - user_start_;
+        prefetch_system_time = system_base_ + system - system_start_;
+#ifndef _WIN32
+        if (prefetch_running)
+            prefetch_clock_published = clock_seconds(prefetch_clock);
+#endif
+    }
+
+private:
+    double user_base_;
+    double system_base_;
+    double user_start_;
+    double system_start_;
+};
+
+void
+read_file(const std::string &path)
+{
+    const std::unique_ptr<std::istream> is_ptr(Util::get_resource(path));
+    std::istream &is(*is_ptr);
+    char buf[65536];
+
+    while (is.read(buf, sizeof(buf)) || is.gcount() > 0)
+        ;
+}
+
+}
+
+void
+AssetPrefetcher::start(const Benchmark &benchmark)
+{
+    wait();
+
+    Model::clear_prefetched();
+    Texture::clear_prefetched();
+
+    Scene::Assets assets;
+    benchmark.scene().assets(benchmark.option_values(), assets);
+
+    if (!shaders_read_) {
+        std::vector<std::filesystem::path> shaders;
+        Util::list_files(Options::data_path + "/shaders", shaders);
+        for (const auto &shader : shaders)
+            assets.files.push_back(shader.string());
+        shaders_read_ = true;
+    }
+
+    if (assets.models.empty() && assets.textures.empty() && assets.files.empty())
+        return;
+
+    /* The collections are built lazily, so build them before the thread uses them */
+    Model::find_models();
+    Texture::find_textures();
+
+    thread_ = std::thread(run, assets);
+}
+
+void
+AssetPrefetcher::wait()
+{
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void
+AssetPrefetcher::cpu_times(double *user_sec, double *system_sec)
+{
+    std::lock_guard<std::mutex> lock(prefetch_mutex);
+    *user_sec = prefetch_user_time;
+    *system_sec = prefetch_system_time;
+
+#ifndef _WIN32
+    /*
+     * Add the time a running thread has used since it last published its
+     * times, as user time since the split is not known, so that the time
+     * of an asset that is still being prepared is left out too.
+     */
+    if (prefetch_running) {
+        double now = clock_seconds(prefetch_clock);
+        if (now > prefetch_clock_published)
+            *user_sec += now - prefetch_clock_published;
+    }
+#endif
+}
+
+void
+AssetPrefetcher::run(const Scene::Assets &assets)
+{
+    CpuTimeTracker tracker;
+
+    for (const std::string &file : assets.files) {
+        read_file(file);
+        tracker.update();
+    }
+
+    for (const std::string &model : assets.models) {
+        Model::prefetch(model);
+        tracker.update();
+    }
+
+    for (const std::string &texture : assets.textures) {
+        Texture::prefetch(texture);
+        tracker.update();
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_ASSET_PREFETCHER_H_
+#define GLMARK2_ASSET_PREFETCHER_H_
+
+#include "scene.h"
+
+#include <thread>
+
+class Benchmark;
+
+/**
+ * Prepares the CPU side assets of a benchmark in a background thread.
+ *
+ * The models and textures that the benchmark's scene reports with
+ * Scene::assets() are loaded and decoded with Model::prefetch() and
+ * Texture::prefetch(), so that the scene's setup only has to upload them.
+ * Other data files, and the shader sources the first time, are just read,
+ * so that they are in the page cache when the scene needs them.
+ *
+ * The CPU time of the background thread is tracked separately, so that it
+ * can be left out of the CPU results of the benchmark running meanwhile.
+ */
+class AssetPrefetcher
+{
+public:
+    AssetPrefetcher() : shaders_read_(false) {}
+    ~AssetPrefetcher() { wait(); }
+
+    /**
+     * Starts preparing the assets of a benchmark.
+     *
+     * This waits for the assets that are being prepared, and drops the
+     * ones that were prepared before. It must be called from the thread
+     * that runs the benchmarks.
+     *
+     * @param benchmark the benchmark to prepare the assets of
+     */
+    void start(const Benchmark &benchmark);
+
+    /**
+     * Waits until the assets being prepared are ready.
+     */
+    void wait();
+
+    /**
+     * Gets the CPU time that has been used to prepare assets, including
+     * the time used so far by the asset being prepared.
+     *
+     * @param user_sec the user time, in seconds
+     * @param system_sec the system time, in seconds
+     */
+    static void cpu_times(double *user_sec, double *system_sec);
+
+private:
+    static void run(const Scene::Assets &assets);
+
+    std::thread thread_;
+    bool shaders_read_;
+};
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "async-readback.h"
+#include "canvas.h"
+#include "gl-state.h"
+#include "log.h"
+#include "util.h"
+
+#include <cstring>
+
+AsyncReadback::AsyncReadback(Canvas &canvas) :
+    canvas_(canvas), width_(0), height_(0), head_(0), pending_(0),
+    completed_(0), bytes_(0), total_latency_(0)
+{
+}
+
+AsyncReadback::~AsyncReadback()
+{
+    release();
+}
+
+bool
+AsyncReadback::supported()
+{
+#if GLMARK2_USE_GLESv2
+    /* GL_OES_mapbuffer only allows write access, so we need GLES 3.0 */
+    return GLExtensions::MapBufferRange && GLExtensions::version_at_least(3, 0);
+#else
+    return GLExtensions::MapBuffer &&
+           (GLExtensions::version_at_least(2, 1) ||
+            GLExtensions::support("GL_ARB_pixel_buffer_object"));
+#endif
+}
+
+bool
+AsyncReadback::init(int width, int height, unsigned int depth)
+{
+    release();
+
+    if (!supported() || width <= 0 || height <= 0 || depth == 0)
+        return false;
+
+    width_ = width;
+    height_ = height;
+
+    slots_.resize(depth);
+    for (Slot &slot : slots_) {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size(), 0, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR) {
+        Log::debug("AsyncReadback: Failed to allocate %u pixel pack buffers of %zu bytes\n",
+                   depth, size());
+        release();
+        return false;
+    }
+
+    return true;
+}
+
+void
+AsyncReadback::release()
+{
+    for (Slot &slot : slots_) {
+        if (slot.pbo)
+            glDeleteBuffers(1, &slot.pbo);
+    }
+
+    slots_.clear();
+    width_ = 0;
+    height_ = 0;
+    head_ = 0;
+    pending_ = 0;
+    completed_ = 0;
+    bytes_ = 0;
+    total_latency_ = 0;
+}
+
+void
+AsyncReadback::start()
+{
+    if (slots_.empty())
+        return;
+
+    if (pending_ == slots_.size())
+        finish(nullptr);
+
+    Slot &slot = slots_[(head_ + pending_) % slots_.size()];
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.sync = canvas_.sync();
+    slot.start_time = Util::get_timestamp_us();
+
+    /* Make sure the GPU starts working on the read */
+    glFlush();
+
+    pending_++;
+}
+
+bool
+AsyncReadback::finish(std::vector<uint8_t> *pixels)
+{
+    if (pending_ == 0)
+        return false;
+
+    Slot &slot = slots_[head_];
+
+    if (slot.sync) {
+        slot.sync->wait();
+        slot.sync.reset();
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+
+    void *data;
+#if GLMARK2_USE_GLESv2
+    data = GLExtensions::MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size(),
+                                        GL_MAP_READ_BIT);
+#else
+    if (GLExtensions::MapBufferRange && GLExtensions::version_at_least(3, 0))
+        data = GLExtensions::MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size(),
+                                            GL_MAP_READ_BIT);
+    else
+        data = GLExtensions::MapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+#endif
+
+    if (data) {
+        total_latency_ += Util::get_timestamp_us() - slot.start_time;
+
+        if (pixels) {
+            pixels->resize(size());
+            memcpy(pixels->data(), data, size());
+            bytes_ += size();
+        }
+
+        GLExtensions::UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else {
+        Log::debug("AsyncReadback: Failed to map pixel pack buffer\n");
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    head_ = (head_ + 1) % slots_.size();
+    pending_--;
+
+    if (!data)
+        return false;
+
+    completed_++;
+
+    return true;
+}
+
+bool
+AsyncReadback::flush(std::vector<uint8_t> *pixels)
+{
+    bool ret = false;
+
+    while (pending_ > 0)
+        ret = finish(pending_ == 1 ? pixels : nullptr) || ret;
+
+    return ret;
+}
+
+double
+AsyncReadback::average_latency()
+{
+    if (completed_ == 0)
+        return 0.0;
+
+    return total_latency_ / (1000000.0 * completed_);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_ASYNC_READBACK_H_
+#define GLMARK2_ASYNC_READBACK_H_
+
+#include "gl-headers.h"
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+class Canvas;
+class GLStateSync;
+
+/**
+ * Reads back framebuffer contents without stalling the GL pipeline.
+ *
+ * Reads are issued into a ring of pixel pack buffers, and each read is
+ * followed by a sync object (if the canvas supports them). A read is
+ * completed (mapped and copied out) only when it is the oldest one in the
+ * ring, by which point the GPU has normally finished with it.
+ *
+ * Pixels are always read as RGBA, 8 bits per component, starting from the
+ * lower left corner.
+ */
+class AsyncReadback
+{
+public:
+    AsyncReadback(Canvas &canvas);
+    ~AsyncReadback();
+
+    /**
+     * Whether asynchronous readback is supported by the current context.
+     *
+     * @return whether asynchronous readback is supported
+     */
+    static bool supported();
+
+    /**
+     * Allocates the buffer ring.
+     *
+     * @param width the width of the region to read
+     * @param height the height of the region to read
+     * @param depth the number of reads that may be in flight
+     *
+     * @return whether initialization succeeded
+     */
+    bool init(int width, int height, unsigned int depth);
+
+    /**
+     * Releases all GL resources, dropping any pending reads.
+     */
+    void release();
+
+    /**
+     * Starts reading back the (0, 0, width, height) region of the current
+     * read framebuffer.
+     *
+     * If the ring is full, the oldest read is completed first and its
+     * contents are dropped.
+     */
+    void start();
+
+    /**
+     * Completes the oldest pending read, waiting for it if needed.
+     *
+     * @param pixels where to store the pixels, may be nullptr to just
+     *               retire the read
+     *
+     * @return whether a read was completed
+     */
+    bool finish(std::vector<uint8_t> *pixels);
+
+    /**
+     * Completes all pending reads, keeping the contents of the newest one.
+     *
+     * @param pixels where to store the pixels, may be nullptr
+     *
+     * @return whether any read was completed
+     */
+    bool flush(std::vector<uint8_t> *pixels);
+
+    /**
+     * Gets the number of reads that have been started but not completed.
+     */
+    unsigned int pending() { return pending_; }
+
+    /**
+     * Gets the maximum number of reads that may be in flight.
+     */
+    unsigned int depth() { return slots_.size(); }
+
+    /**
+     * Gets the number of reads completed since init().
+     */
+    unsigned int completed() { return completed_; }
+
+    /**
+     * Gets the number of bytes copied out since init().
+     */
+    uint64_t bytes() { return bytes_; }
+
+    /**
+     * Gets the average time, in seconds, from the start of a read to the
+     * moment its contents became available to the CPU.
+     */
+    double average_latency();
+
+    /**
+     * Gets the size in bytes of a single read.
+     */
+    size_t size() { return static_cast<size_t>(width_) * height_ * 4; }
+
+private:
+    struct Slot {
+        Slot() : pbo(0), start_time(0) {}
+        GLuint pbo;
+        std::unique_ptr<GLStateSync> sync;
+        uint64_t start_time;
+    };
+
+    Canvas &canvas_;
+    std::vector<Slot> slots_;
+    int width_;
+    int height_;
+    unsigned int head_;
+    unsigned int pending_;
+    unsigned int completed_;
+    uint64_t bytes_;
+    uint64_t total_latency_;
+};
+
+#endif
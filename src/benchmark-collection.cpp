@@ -19,13 +19,86 @@
  * Authors:
  *  Alexandros Frantzis
  */
+#include <cmath>
 #include <fstream>
+#include <stdexcept>
 #include "benchmark-collection.h"
 #include "default-benchmarks.h"
 #include "options.h"
 #include "log.h"
 #include "util.h"
 
+namespace
+{
+
+/* The most benchmarks a single description may be expanded to */
+const size_t max_sweep_points = 10000;
+
+/**
+ * Expands a swept option value to its values.
+ *
+ * @param value the option value
+ * @param values the expanded values
+ *
+ * @return whether the value is a list or range, in which case the
+ *         expanded values are added to @a values
+ */
+bool
+expand_value(const std::string &value, std::vector<std::string> &values)
+{
+    if (value.size() >= 2 && value.front() == '{' && value.back() == '}') {
+        Util::split(value.substr(1, value.size() - 2), ',', values,
+                    Util::SplitModeNormal);
+        if (values.empty())
+            throw std::runtime_error("empty list '" + value + "'");
+        return true;
+    }
+
+    static const std::string range_prefix("range(");
+    if (value.compare(0, range_prefix.size(), range_prefix) != 0 || value.back() != ')')
+        return false;
+
+    std::vector<std::string> args;
+    Util::split(value.substr(range_prefix.size(),
+                             value.size() - range_prefix.size() - 1),
+                ',', args, Util::SplitModeNormal);
+    if (args.size() != 2 && args.size() != 3)
+        throw std::runtime_error("invalid range '" + value + "'");
+
+    double start, stop, step = 1.0;
+    try {
+        start = std::stod(args[0]);
+        stop = std::stod(args[1]);
+        if (args.size() == 3)
+            step = std::stod(args[2]);
+    }
+    catch (...) {
+        throw std::runtime_error("invalid range '" + value + "'");
+    }
+
+    if (step == 0.0 || (stop - start) / step < 0.0)
+        throw std::runtime_error("empty range '" + value + "'");
+
+    /* Allow for rounding errors, so that the end is included when reached */
+    double count = std::floor((stop - start) / step + 1e-9) + 1;
+    if (count > max_sweep_points)
+        throw std::runtime_error("too many values in range '" + value + "'");
+
+    bool integral = start == std::floor(start) && step == std::floor(step);
+
+    for (unsigned int i = 0; i < count; i++) {
+        double v = start + i * step;
+        if (integral)
+            values.push_back(Util::toString(std::llround(v)));
+        else
+            values.push_back(Util::toString(v));
+    }
+
+    return true;
+}
+
+}
+
 BenchmarkCollection::~BenchmarkCollection()
 {
     Util::dispose_pointer_vector(benchmarks_);
@@ -38,7 +111,7 @@ BenchmarkCollection::add(const std::vector<std::string> &benchmarks)
          iter != benchmarks.end();
          iter++)
     {
-        benchmarks_.push_back(new Benchmark(*iter));
+        add_benchmark(*iter);
     }
 }
 
@@ -77,6 +150,87 @@ BenchmarkCollection::needs_decoration()
 }
 
 
+/**
+ * Adds the benchmark of a description, or all the benchmarks of a sweep
+ * if it has any lists or ranges of option values.
+ */
+void
+BenchmarkCollection::add_benchmark(const std::string &description)
+{
+    std::vector<std::string> elems;
+    Util::split(description, ':', elems, Util::SplitModeNormal);
+
+    /* The option values of each element, more than one for swept options */
+    std::vector<std::vector<std::string> > values(elems.size());
+    std::shared_ptr<Benchmark::Sweep> sweep(new Benchmark::Sweep());
+    std::vector<size_t> swept;
+    size_t points = 1;
+
+    for (size_t i = 0; i < elems.size(); i++) {
+        size_t eq = elems[i].find('=');
+        std::vector<std::string> &elem_values(values[i]);
+
+        try {
+            /* Option-setting descriptions, without a scene, are not swept */
+            if (i > 0 && !elems[0].empty() && eq != std::string::npos &&
+                expand_value(elems[i].substr(eq + 1), elem_values))
+            {
+                sweep->axes.push_back(elems[i].substr(0, eq));
+                swept.push_back(i);
+                points *= elem_values.size();
+                if (points > max_sweep_points)
+                    throw std::runtime_error("too many combinations");
+                continue;
+            }
+        }
+        catch (const std::exception &e) {
+            Log::error("Ignoring benchmark '%s': %s\n", description.c_str(), e.what());
+            return;
+        }
+
+        elem_values.push_back(eq != std::string::npos ? elems[i].substr(eq + 1) : "");
+    }
+
+    if (swept.empty()) {
+        benchmarks_.push_back(new Benchmark(description));
+        return;
+    }
+
+    sweep->description = description;
+    sweep->points = points;
+
+    /* Go through all combinations, varying the last swept option fastest */
+    std::vector<size_t> index(elems.size(), 0);
+
+    for (size_t point = 0; point < points; point++) {
+        std::string point_description(elems[0]);
+        std::vector<std::string> point_values;
+
+        for (size_t i = 1; i < elems.size(); i++) {
+            size_t eq = elems[i].find('=');
+            if (eq == std::string::npos) {
+                point_description += ":" + elems[i];
+                continue;
+            }
+            point_description += ":" + elems[i].substr(0, eq + 1) + values[i][index[i]];
+        }
+
+        for (size_t i : swept)
+            point_values.push_back(values[i][index[i]]);
+
+        Benchmark *benchmark = new Benchmark(point_description);
+        benchmark->sweep(sweep, point_values);
+        benchmarks_.push_back(benchmark);
+
+        for (size_t s = swept.size(); s-- > 0;) {
+            size_t i = swept[s];
+            if (++index[i] < values[i].size())
+                break;
+            index[i] = 0;
+        }
+    }
+}
+
 void
 BenchmarkCollection::add_benchmarks_from_files()
 {
@@ -91,7 +245,7 @@ BenchmarkCollection::add_benchmarks_from_files()
 
             while (getline(ifs, line)) {
                 if (!line.empty())
-                    benchmarks_.push_back(new Benchmark(line));
+                    add_benchmark(line);
             }
         }
         else {
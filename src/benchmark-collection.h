@@ -34,6 +34,11 @@ public:
 
     /*
      * Adds benchmarks to the collection.
+     *
+     * An option value in a description may also be a list of values, like
+     * {50,100,200}, or a range of numbers, like range(0.1,1.0,0.1), which
+     * includes the end if it is reached. Such descriptions are expanded to
+     * a benchmark for each combination of the values, which form a sweep.
      */
     void add(const std::vector<std::string> &benchmarks);
 
@@ -50,6 +55,7 @@ public:
     const std::vector<Benchmark *>& benchmarks() { return benchmarks_; }
 
 private:
+    void add_benchmark(const std::string &description);
     void add_benchmarks_from_files();
     bool benchmarks_contain_normal_scenes();
 
@@ -118,6 +118,29 @@ Benchmark::teardown_scene()
     scene_.finish();
 }
 
+map<string, string>
+Benchmark::option_values() const
+{
+    map<string, string> values;
+
+    for (map<string, Scene::Option>::const_iterator iter = scene_.options().begin();
+         iter != scene_.options().end();
+         iter++)
+    {
+        values[iter->first] = iter->second.default_value;
+    }
+
+    for (vector<OptionPair>::const_iterator iter = options_.begin();
+         iter != options_.end();
+         iter++)
+    {
+        if (values.find(iter->first) != values.end())
+            values[iter->first] = iter->second;
+    }
+
+    return values;
+}
+
 bool
 Benchmark::needs_decoration() const
 {
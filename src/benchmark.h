@@ -25,6 +25,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 
 #include "scene.h"
 
@@ -38,6 +39,19 @@ class Benchmark
 public:
     typedef std::pair<std::string, std::string> OptionPair;
 
+    /**
+     * A parameter sweep, which a description with lists or ranges of
+     * values is expanded to (see BenchmarkCollection::add()).
+     */
+    struct Sweep {
+        /** The description with the lists and ranges */
+        std::string description;
+        /** The names of the swept options */
+        std::vector<std::string> axes;
+        /** The number of benchmarks in the sweep */
+        size_t points;
+    };
+
     /**
      * Creates a benchmark using a scene object reference.
      *
@@ -90,11 +104,45 @@ public:
      */
     void teardown_scene();
 
+    /**
+     * Gets the option values the Scene is set up with by this benchmark.
+     *
+     * These are the default option values of the Scene, overridden by the
+     * options of the benchmark. The Scene itself is not changed.
+     *
+     * @return the option values
+     */
+    std::map<std::string, std::string> option_values() const;
+
     /**
      * Whether the benchmark needs extra decoration.
      */
     bool needs_decoration() const;
 
+    /**
+     * Sets the sweep this benchmark is a point of.
+     *
+     * @param sweep the sweep
+     * @param values the values of the swept options for this benchmark
+     */
+    void sweep(const std::shared_ptr<const Sweep> &sweep,
+               const std::vector<std::string> &values)
+    {
+        sweep_ = sweep;
+        sweep_values_ = values;
+    }
+
+    /**
+     * Gets the sweep this benchmark is a point of, or nullptr if it isn't
+     * part of a sweep.
+     */
+    const Sweep *sweep() const { return sweep_.get(); }
+
+    /**
+     * Gets the values of the swept options for this benchmark.
+     */
+    const std::vector<std::string> &sweep_values() const { return sweep_values_; }
+
     /**
      * Registers a Scene, so that it becomes accessible by name.
      */
@@ -117,6 +165,8 @@ public:
 private:
     Scene &scene_;
     std::vector<OptionPair> options_;
+    std::shared_ptr<const Sweep> sweep_;
+    std::vector<std::string> sweep_values_;
 
     void load_options();
 
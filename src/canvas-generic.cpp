@@ -27,7 +27,9 @@
 #include "options.h"
 #include "util.h"
 #include "results-file.h"
+#include "image-writer.h"
 
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 
@@ -54,6 +56,7 @@ CanvasGeneric::init()
 bool
 CanvasGeneric::reset()
 {
+    readback_.reset();
     release_fbo();
 
     if (!gl_state_.reset())
@@ -134,12 +137,19 @@ CanvasGeneric::update()
         case Options::FrameEndReadPixels:
             read_pixel(width_ / 2, height_ / 2);
             break;
+        case Options::FrameEndAsyncReadback:
+            async_readback();
+            break;
         case Options::FrameEndNone:
         default:
             break;
     }
 
-    if (offscreen_) {
+    /*
+     * When validating, keep rendering to the same FBO, so that the frame
+     * can still be read back after it has ended.
+     */
+    if (offscreen_ && !Options::validate) {
         current_fbo_index_ = (current_fbo_index_ + 1) % fbos_.size();
         if (fbo_syncs_[current_fbo_index_]) {
             fbo_syncs_[current_fbo_index_]->wait();
@@ -204,20 +214,31 @@ CanvasGeneric::read_pixel(int x, int y)
     return Canvas::Pixel(pixel[0], pixel[1], pixel[2], pixel[3]);
 }
 
+void
+CanvasGeneric::read_pixels(std::vector<uint8_t> &pixels)
+{
+    pixels.resize(static_cast<size_t>(width_) * height_ * 4);
+    glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+}
+
 void
 CanvasGeneric::write_to_file(std::string &filename)
 {
-    char *pixels = new char[width_ * height_ * 4];
+    const size_t stride = width_ * 4;
+    std::vector<uint8_t> pixels;
+
+    read_pixels(pixels);
 
-    for (int i = 0; i < height_; i++) {
-        glReadPixels(0, i, width_, 1, GL_RGBA, GL_UNSIGNED_BYTE,
-                     &pixels[(height_ - i - 1) * width_ * 4]);
+    if (std::filesystem::path(filename).extension() == ".png") {
+        if (!PNGWriter::write(filename, width_, height_, pixels.data(), true))
+            Log::error("Failed to write canvas contents to %s\n", filename.c_str());
+        return;
     }
 
+    /* GL rows are stored bottom to top, but the file is top to bottom */
     std::ofstream output (filename.c_str(), std::ios::out | std::ios::binary);
-    output.write(pixels, 4 * width_ * height_);
-
-    delete [] pixels;
+    for (int i = height_ - 1; i >= 0; i--)
+        output.write(reinterpret_cast<const char *>(&pixels[i * stride]), stride);
 }
 
 bool
@@ -239,6 +260,44 @@ CanvasGeneric::fbo()
     return fbos_.empty() ? 0 : fbos_[current_fbo_index_].fbo;
 }
 
+bool
+CanvasGeneric::supports_sync()
+{
+    return gl_state_.supports_sync();
+}
+
+std::unique_ptr<GLStateSync>
+CanvasGeneric::sync()
+{
+    if (!supports_sync())
+        return nullptr;
+
+    return gl_state_.sync();
+}
+
+std::unique_ptr<Canvas>
+CanvasGeneric::create_context_canvas(bool shared)
+{
+    if (!GLExtensions::GenFramebuffers) {
+        Log::error("Additional contexts require GL framebuffer support\n");
+        return nullptr;
+    }
+
+    if (!ensure_gl_formats())
+        return nullptr;
+
+    std::unique_ptr<GLStateContext> context(gl_state_.create_context(shared));
+    if (!context)
+        return nullptr;
+
+    /* Pipeline the frames as deeply as an off-screen canvas does by default */
+    return std::make_unique<CanvasGenericContext>(std::move(context), gl_state_,
+                                                  width_, height_,
+                                                  gl_color_format_,
+                                                  gl_depth_format_,
+                                                  offscreen_ ? offscreen_ : 3);
+}
+
 
 /*******************
  * Private methods *
@@ -309,6 +368,9 @@ CanvasGeneric::resize_no_viewport(int width, int height)
     width_ = cur_properties.width;
     height_ = cur_properties.height;
 
+    // The readback buffers are recreated (if needed) with the correct size
+    readback_.reset();
+
     if (!fbos_.empty())
     {
         // Clear FBOs so that they are recreated (if needed) with the correct size
@@ -478,6 +540,39 @@ CanvasGeneric::release_fbo()
     current_fbo_index_ = 0;
 }
 
+void
+CanvasGeneric::async_readback()
+{
+    static const unsigned int readback_depth = 3;
+
+    if (!readback_) {
+        readback_.reset(new AsyncReadback(*this));
+        if (!readback_->init(width_, height_, readback_depth)) {
+            static bool warned = false;
+            if (!warned) {
+                Log::warning("Asynchronous readback not supported, falling back to glReadPixels\n");
+                warned = true;
+            }
+        }
+    }
+
+    if (readback_->size() == 0) {
+        readback_pixels_.resize(static_cast<size_t>(width_) * height_ * 4);
+        glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE,
+                     readback_pixels_.data());
+        return;
+    }
+
+    /*
+     * Retire the oldest read before it gets dropped by start(), so that
+     * the copy to CPU memory is always part of the measured work.
+     */
+    if (readback_->pending() == readback_->depth())
+        readback_->finish(&readback_pixels_);
+
+    readback_->start();
+}
+
 const char *
 CanvasGeneric::get_gl_format_str(GLenum f)
 {
@@ -531,3 +626,173 @@ CanvasGeneric::FBO::~FBO()
     if (depth_renderbuffer)
         GLExtensions::DeleteRenderbuffers(1, &depth_renderbuffer);
 }
+
+/************************
+ * CanvasGenericContext *
+ ************************/
+
+CanvasGenericContext::CanvasGenericContext(std::unique_ptr<GLStateContext> context,
+                                           GLState &gl_state, int width, int height,
+                                           GLenum color_format, GLenum depth_format,
+                                           unsigned int fbo_count)
+    : Canvas(width, height), context_(std::move(context)), gl_state_(gl_state),
+      gl_color_format_(color_format), gl_depth_format_(depth_format),
+      fbo_count_(fbo_count), current_fbo_index_(0), gl_sync_supported_(false),
+      current_(false)
+{
+    projection_ = LibMatrix::Mat4::perspective(60.0, width_ / static_cast<float>(height_),
+                                               1.0, 1024.0);
+}
+
+CanvasGenericContext::~CanvasGenericContext()
+{
+    if (current_) {
+        readback_.reset();
+        fbo_syncs_.clear();
+        fbos_.clear();
+        context_->release();
+    }
+}
+
+bool
+CanvasGenericContext::init()
+{
+    if (!context_->make_current())
+        return false;
+
+    current_ = true;
+    gl_sync_supported_ = gl_state_.supports_sync();
+
+    for (unsigned int i = 0; i < fbo_count_; i++) {
+        fbos_.emplace_back(new CanvasGeneric::FBO(width_, height_, gl_color_format_,
+                                                  gl_depth_format_));
+        if (GLExtensions::CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            Log::error("The framebuffer of an additional context is incomplete\n");
+            return false;
+        }
+    }
+    fbo_syncs_.resize(fbo_count_);
+
+    current_fbo_index_ = 0;
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, fbos_[current_fbo_index_]->fbo);
+
+    glViewport(0, 0, width_, height_);
+
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LEQUAL);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+
+    clear();
+
+    return true;
+}
+
+void
+CanvasGenericContext::clear()
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+#if GLMARK2_USE_GL
+    glClearDepth(1.0f);
+#elif GLMARK2_USE_GLESv2
+    glClearDepthf(1.0f);
+#endif
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void
+CanvasGenericContext::update()
+{
+    Options::FrameEnd m = Options::frame_end;
+
+    /* There is nothing to swap, so end the frame as off-screen rendering does */
+    if (m == Options::FrameEndDefault || m == Options::FrameEndSwap) {
+        if (gl_sync_supported_) {
+            fbo_syncs_[current_fbo_index_] = gl_state_.sync();
+            m = Options::FrameEndNone;
+        } else {
+            m = Options::FrameEndFinish;
+        }
+    }
+
+    switch(m) {
+        case Options::FrameEndFinish:
+            glFinish();
+            break;
+        case Options::FrameEndReadPixels:
+            read_pixel(width_ / 2, height_ / 2);
+            break;
+        case Options::FrameEndAsyncReadback:
+            async_readback();
+            break;
+        case Options::FrameEndNone:
+        default:
+            break;
+    }
+
+    current_fbo_index_ = (current_fbo_index_ + 1) % fbos_.size();
+    if (fbo_syncs_[current_fbo_index_]) {
+        fbo_syncs_[current_fbo_index_]->wait();
+        fbo_syncs_[current_fbo_index_].reset();
+    }
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, fbos_[current_fbo_index_]->fbo);
+}
+
+Canvas::Pixel
+CanvasGenericContext::read_pixel(int x, int y)
+{
+    uint8_t pixel[4];
+
+    glReadPixels(x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+    return Canvas::Pixel(pixel[0], pixel[1], pixel[2], pixel[3]);
+}
+
+void
+CanvasGenericContext::read_pixels(std::vector<uint8_t> &pixels)
+{
+    pixels.resize(static_cast<size_t>(width_) * height_ * 4);
+    glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+}
+
+unsigned int
+CanvasGenericContext::fbo()
+{
+    return fbos_.empty() ? 0 : fbos_[current_fbo_index_]->fbo;
+}
+
+bool
+CanvasGenericContext::supports_sync()
+{
+    return gl_sync_supported_;
+}
+
+std::unique_ptr<GLStateSync>
+CanvasGenericContext::sync()
+{
+    if (!gl_sync_supported_)
+        return nullptr;
+
+    return gl_state_.sync();
+}
+
+void
+CanvasGenericContext::async_readback()
+{
+    static const unsigned int readback_depth = 3;
+
+    if (!readback_) {
+        readback_.reset(new AsyncReadback(*this));
+        readback_->init(width_, height_, readback_depth);
+    }
+
+    if (readback_->size() == 0) {
+        read_pixels(readback_pixels_);
+        return;
+    }
+
+    if (readback_->pending() == readback_->depth())
+        readback_->finish(&readback_pixels_);
+
+    readback_->start();
+}
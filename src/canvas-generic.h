@@ -24,6 +24,7 @@
 #define GLMARK2_CANVAS_GENERIC_H_
 
 #include "canvas.h"
+#include "async-readback.h"
 
 #include <vector>
 #include <memory>
@@ -53,18 +54,25 @@ public:
     void update();
     void print_info();
     Pixel read_pixel(int x, int y);
+    void read_pixels(std::vector<uint8_t> &pixels);
     void write_to_file(std::string &filename);
     bool should_quit();
     void resize(int width, int height);
     unsigned int fbo();
+    bool supports_sync();
+    std::unique_ptr<GLStateSync> sync();
+    std::unique_ptr<Canvas> create_context_canvas(bool shared);
 
 private:
+    friend class CanvasGenericContext;
+
     bool supports_gl2();
     bool resize_no_viewport(int width, int height);
     bool do_make_current();
     bool ensure_gl_formats();
     bool ensure_fbo();
     void release_fbo();
+    void async_readback();
     const char *get_gl_format_str(GLenum f);
 
     struct FBO {
@@ -82,9 +90,53 @@ private:
     GLenum gl_depth_format_;
     std::vector<FBO> fbos_;
     std::vector<std::unique_ptr<GLStateSync>> fbo_syncs_;
+    std::unique_ptr<AsyncReadback> readback_;
+    std::vector<uint8_t> readback_pixels_;
     int current_fbo_index_;
     bool gl_sync_supported_;
     bool window_initialized_;
 };
 
+/**
+ * A canvas that renders with an additional context of a CanvasGeneric into
+ * framebuffer objects, see Canvas::create_context_canvas().
+ *
+ * Frames end like those of an off-screen CanvasGeneric, cycling through
+ * the same number of FBOs, so that both are pipelined the same way.
+ */
+class CanvasGenericContext : public Canvas
+{
+public:
+    CanvasGenericContext(std::unique_ptr<GLStateContext> context,
+                         GLState &gl_state, int width, int height,
+                         GLenum color_format, GLenum depth_format,
+                         unsigned int fbo_count);
+    ~CanvasGenericContext();
+
+    bool init();
+    void clear();
+    void update();
+    Pixel read_pixel(int x, int y);
+    void read_pixels(std::vector<uint8_t> &pixels);
+    unsigned int fbo();
+    bool supports_sync();
+    std::unique_ptr<GLStateSync> sync();
+
+private:
+    void async_readback();
+
+    std::unique_ptr<GLStateContext> context_;
+    GLState &gl_state_;
+    GLenum gl_color_format_;
+    GLenum gl_depth_format_;
+    unsigned int fbo_count_;
+    std::vector<std::unique_ptr<CanvasGeneric::FBO>> fbos_;
+    std::vector<std::unique_ptr<GLStateSync>> fbo_syncs_;
+    std::unique_ptr<AsyncReadback> readback_;
+    std::vector<uint8_t> readback_pixels_;
+    unsigned int current_fbo_index_;
+    bool gl_sync_supported_;
+    bool current_;
+};
+
 #endif /* GLMARK2_CANVAS_GENERIC_H_ */
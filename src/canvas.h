@@ -26,11 +26,14 @@
 #define GLMARK2_CANVAS_H_
 
 #include "gl-headers.h"
+#include "gl-state.h"
 #include "mat.h"
 #include "gl-visual-config.h"
 
 #include <stdint.h>
+#include <memory>
 #include <string>
+#include <vector>
 #include <stdio.h>
 #include <cmath>
 
@@ -159,11 +162,25 @@ public:
         return Pixel();
     }
 
+    /**
+     * Reads the whole canvas contents.
+     *
+     * The pixels are stored from the lower left corner to the upper right
+     * corner. Each pixel value is stored as four consecutive bytes R,G,B,A.
+     *
+     * This method should be implemented in derived classes.
+     *
+     * @param pixels the vector to store the pixels in
+     */
+    virtual void read_pixels(std::vector<uint8_t> &pixels) { pixels.clear(); }
+
     /**
      * Writes the canvas contents to a file.
      *
      * The pixel save order is  upper left to lower right. Each pixel value
-     * is stored as four consecutive bytes R,G,B,A.
+     * is stored as four consecutive bytes R,G,B,A. Implementations may use
+     * an image format instead, if the file name has a matching extension
+     * (e.g. ".png").
      *
      * This method should be implemented in derived classes.
      *
@@ -199,6 +216,43 @@ public:
      */
     virtual unsigned int fbo() { return 0; }
 
+    /**
+     * Whether sync objects are supported.
+     *
+     * This method should be implemented in derived classes.
+     *
+     * @return whether ::sync() can create sync objects
+     */
+    virtual bool supports_sync() { return false; }
+
+    /**
+     * Creates a sync object for the GL commands issued so far.
+     *
+     * This method should be implemented in derived classes.
+     *
+     * @return the sync object, or nullptr if sync objects are not supported
+     */
+    virtual std::unique_ptr<GLStateSync> sync() { return nullptr; }
+
+    /**
+     * Creates a canvas that renders with an additional GL context into
+     * an off-screen framebuffer of the same size as this canvas.
+     *
+     * The new canvas is meant to be used from another thread. Its init()
+     * must be called in that thread, which must also destroy it.
+     *
+     * @param shared whether the new context shares its objects with the
+     *               context of this canvas
+     *
+     * @return the new canvas, or nullptr if additional contexts are not
+     *         supported
+     */
+    virtual std::unique_ptr<Canvas> create_context_canvas(bool shared)
+    {
+        static_cast<void>(shared);
+        return nullptr;
+    }
+
     /**
      * Gets a dummy canvas object.
      *
@@ -0,0 +1,389 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "frame-capture.h"
+#include "canvas.h"
+#include "image-writer.h"
+#include "log.h"
+#include "options.h"
+#include "util.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+/* The number of reads in flight when reading back asynchronously */
+const unsigned int readback_depth = 3;
+
+/* Favor speed over size, so that the encoders can keep up */
+const int png_compression = 1;
+
+}
+
+std::FILE *FrameCapture::stdout_ = nullptr;
+
+FrameCapture::FrameCapture(Canvas &canvas) :
+    canvas_(canvas), readback_(canvas), async_(false),
+    format_(Options::CaptureFormatPNG), stream_(false), width_(0), height_(0),
+    scene_index_(0), frame_(0), output_(nullptr), stream_header_written_(false),
+    stream_width_(0), stream_height_(0), queue_limit_(1), busy_workers_(0),
+    stopping_(false), frames_written_(0), write_errors_(0)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queue_not_empty_.notify_all();
+
+    for (auto &t : workers_)
+        t.join();
+
+    if (output_ && output_ != stdout_)
+        std::fclose(output_);
+    else if (output_)
+        std::fflush(output_);
+}
+
+bool
+FrameCapture::reserve_stdout()
+{
+    if (stdout_)
+        return true;
+
+    std::cout.flush();
+    std::fflush(stdout);
+
+#ifdef _WIN32
+    int fd = _dup(_fileno(stdout));
+    if (fd < 0 || _dup2(_fileno(stderr), _fileno(stdout)) < 0)
+        return false;
+    _setmode(fd, _O_BINARY);
+    stdout_ = _fdopen(fd, "wb");
+#else
+    int fd = dup(fileno(stdout));
+    if (fd < 0 || dup2(fileno(stderr), fileno(stdout)) < 0)
+        return false;
+    stdout_ = fdopen(fd, "wb");
+#endif
+
+    return stdout_ != nullptr;
+}
+
+bool
+FrameCapture::init()
+{
+    const std::string &dest(Options::capture);
+
+    format_ = Options::capture_format;
+    if (format_ == Options::CaptureFormatDefault)
+        format_ = dest == "-" ? Options::CaptureFormatY4M : Options::CaptureFormatPNG;
+
+    stream_ = format_ != Options::CaptureFormatPNG;
+
+    if (dest == "-") {
+        if (!stream_) {
+            Log::error("PNG frame capture requires a destination directory\n");
+            return false;
+        }
+        if (!stdout_) {
+            Log::error("The standard output is not available for frame capture\n");
+            return false;
+        }
+        output_ = stdout_;
+    }
+    else {
+        std::error_code ec;
+        std::filesystem::create_directories(dest, ec);
+        if (ec || !std::filesystem::is_directory(dest)) {
+            Log::error("Cannot use '%s' as the frame capture directory\n",
+                       dest.c_str());
+            return false;
+        }
+
+        if (stream_) {
+            std::filesystem::path path(dest);
+            path /= format_ == Options::CaptureFormatY4M ? "capture.y4m" : "capture.rgba";
+            output_ = std::fopen(path.string().c_str(), "wb");
+            if (!output_) {
+                Log::error("Cannot open '%s' for writing\n", path.string().c_str());
+                return false;
+            }
+        }
+    }
+
+    /*
+     * Streams must be written in order, so they get a single thread. PNG
+     * encoding is much more expensive, so leave it to as many threads as
+     * we can spare next to the rendering thread.
+     */
+    unsigned int nworkers = 1;
+    if (!stream_)
+        nworkers = std::max(1u, Util::get_num_processors() - 1);
+
+    queue_limit_ = 2 * nworkers;
+
+    for (unsigned int i = 0; i < nworkers; i++)
+        workers_.emplace_back(&FrameCapture::worker, this);
+
+    return true;
+}
+
+void
+FrameCapture::begin_scene(const std::string &name)
+{
+    scene_name_ = name;
+    scene_index_++;
+    frame_ = 0;
+    in_flight_.clear();
+    width_ = canvas_.width();
+    height_ = canvas_.height();
+
+    async_ = AsyncReadback::supported() &&
+             readback_.init(width_, height_, readback_depth);
+
+    if (!async_) {
+        static bool warned = false;
+        if (!warned) {
+            Log::debug("Asynchronous readback is not available, capturing"
+                       " frames synchronously\n");
+            warned = true;
+        }
+    }
+}
+
+void
+FrameCapture::capture()
+{
+    unsigned int frame = frame_++;
+
+    if (frame % Options::capture_every != 0)
+        return;
+
+    if (async_) {
+        /* Copy out the oldest read before start() would drop it */
+        if (readback_.pending() == readback_.depth()) {
+            if (readback_.finish(&pixels_))
+                submit(pixels_, in_flight_.front());
+            in_flight_.pop_front();
+        }
+        readback_.start();
+        in_flight_.push_back(frame);
+    }
+    else {
+        canvas_.read_pixels(pixels_);
+        submit(pixels_, frame);
+    }
+}
+
+void
+FrameCapture::end_scene()
+{
+    while (readback_.pending() > 0) {
+        if (readback_.finish(&pixels_))
+            submit(pixels_, in_flight_.front());
+        in_flight_.pop_front();
+    }
+
+    readback_.release();
+}
+
+void
+FrameCapture::finish()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_idle_.wait(lock, [this] { return queue_.empty() && busy_workers_ == 0; });
+
+    if (output_)
+        std::fflush(output_);
+}
+
+unsigned int
+FrameCapture::frames_written()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_written_;
+}
+
+void
+FrameCapture::submit(std::vector<uint8_t> &pixels, unsigned int frame)
+{
+    if (pixels.size() != static_cast<size_t>(width_) * height_ * 4)
+        return;
+
+    Job job;
+    job.pixels.swap(pixels);
+    job.width = width_;
+    job.height = height_;
+
+    if (!stream_) {
+        char name[32];
+        snprintf(name, sizeof(name), "-%06u.png", frame);
+        std::string prefix(Util::toString(scene_index_));
+        prefix.insert(0, prefix.size() < 3 ? 3 - prefix.size() : 0, '0');
+        job.filename = (std::filesystem::path(Options::capture) /
+                        (prefix + "-" + scene_name_ + name)).string();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_not_full_.wait(lock, [this] { return queue_.size() < queue_limit_; });
+    queue_.push_back(std::move(job));
+    lock.unlock();
+
+    queue_not_empty_.notify_one();
+}
+
+void
+FrameCapture::worker()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        queue_not_empty_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty())
+            break;
+
+        Job job(std::move(queue_.front()));
+        queue_.pop_front();
+        busy_workers_++;
+        queue_not_full_.notify_one();
+
+        lock.unlock();
+        bool ok = stream_ ? write_stream(job) : write_png(job);
+        lock.lock();
+
+        busy_workers_--;
+        if (ok) {
+            frames_written_++;
+        }
+        else if (write_errors_++ == 0) {
+            Log::error("Failed to write captured frame%s%s\n",
+                       job.filename.empty() ? "" : " to ",
+                       job.filename.c_str());
+        }
+
+        if (queue_.empty() && busy_workers_ == 0)
+            queue_idle_.notify_all();
+    }
+}
+
+bool
+FrameCapture::write_png(const Job &job)
+{
+    return PNGWriter::write(job.filename, job.width, job.height,
+                            job.pixels.data(), true, png_compression);
+}
+
+bool
+FrameCapture::write_stream(const Job &job)
+{
+    /* Streams can't change their frame size midway */
+    if (!stream_header_written_) {
+        stream_width_ = job.width;
+        stream_height_ = job.height;
+    }
+    else if (job.width != stream_width_ || job.height != stream_height_) {
+        return false;
+    }
+
+    const size_t stride = static_cast<size_t>(job.width) * 4;
+
+    if (format_ == Options::CaptureFormatRGBA) {
+        /* GL rows are stored bottom to top, but the stream is top to bottom */
+        for (int i = job.height - 1; i >= 0; i--) {
+            if (std::fwrite(&job.pixels[i * stride], stride, 1, output_) != 1)
+                return false;
+        }
+        stream_header_written_ = true;
+        return true;
+    }
+
+    if (!stream_header_written_) {
+        /* The frame rate is nominal, frames are not captured at fixed intervals */
+        if (std::fprintf(output_, "YUV4MPEG2 W%d H%d F60:1 Ip A1:1 C420jpeg\n",
+                         job.width, job.height) < 0)
+        {
+            return false;
+        }
+        stream_header_written_ = true;
+    }
+
+    rgba_to_i420(job);
+
+    return std::fputs("FRAME\n", output_) >= 0 &&
+           std::fwrite(yuv_.data(), yuv_.size(), 1, output_) == 1;
+}
+
+/**
+ * Converts a bottom-up RGBA frame to top-down planar YUV 4:2:0, using the
+ * full range BT.601 (JFIF) coefficients and centered chroma samples.
+ */
+void
+FrameCapture::rgba_to_i420(const Job &job)
+{
+    const int w = job.width;
+    const int h = job.height;
+    const int cw = (w + 1) / 2;
+    const int ch = (h + 1) / 2;
+    const size_t stride = static_cast<size_t>(w) * 4;
+
+    yuv_.resize(static_cast<size_t>(w) * h + 2 * static_cast<size_t>(cw) * ch);
+
+    uint8_t *y_plane = yuv_.data();
+    uint8_t *u_plane = y_plane + static_cast<size_t>(w) * h;
+    uint8_t *v_plane = u_plane + static_cast<size_t>(cw) * ch;
+
+    auto row = [&](int y) { return &job.pixels[(h - 1 - y) * stride]; };
+
+    for (int y = 0; y < h; y++) {
+        const uint8_t *src = row(y);
+        uint8_t *dst = y_plane + static_cast<size_t>(y) * w;
+        for (int x = 0; x < w; x++, src += 4)
+            dst[x] = (77 * src[0] + 150 * src[1] + 29 * src[2] + 128) >> 8;
+    }
+
+    for (int y = 0; y < ch; y++) {
+        const uint8_t *r0 = row(2 * y);
+        const uint8_t *r1 = row(std::min(2 * y + 1, h - 1));
+        for (int x = 0; x < cw; x++) {
+            int x0 = 8 * x;
+            int x1 = 4 * std::min(2 * x + 1, w - 1);
+            int r = r0[x0] + r0[x1] + r1[x0] + r1[x1];
+            int g = r0[x0 + 1] + r0[x1 + 1] + r1[x0 + 1] + r1[x1 + 1];
+            int b = r0[x0 + 2] + r0[x1 + 2] + r1[x0 + 2] + r1[x1 + 2];
+            /* The sums are 4x the averages, hence the extra shift by 2 */
+            int u = (-43 * r - 85 * g + 128 * b + 512) >> 10;
+            int v = (128 * r - 107 * g - 21 * b + 512) >> 10;
+            u_plane[static_cast<size_t>(y) * cw + x] = std::clamp(u + 128, 0, 255);
+            v_plane[static_cast<size_t>(y) * cw + x] = std::clamp(v + 128, 0, 255);
+        }
+    }
+}
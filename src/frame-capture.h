@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_FRAME_CAPTURE_H_
+#define GLMARK2_FRAME_CAPTURE_H_
+
+#include "async-readback.h"
+#include "options.h"
+
+#include <stdint.h>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Canvas;
+
+/**
+ * Captures rendered frames to PNG files or to a raw video stream.
+ *
+ * Frames are read back asynchronously (falling back to synchronous reads if
+ * pixel pack buffers are not available) and handed to background threads
+ * through a bounded queue for encoding and writing. PNG files are encoded by
+ * several threads in parallel, while streams are written by a single thread
+ * to preserve the order of the frames.
+ */
+class FrameCapture
+{
+public:
+    FrameCapture(Canvas &canvas);
+    ~FrameCapture();
+
+    /**
+     * Moves the standard output out of the way of the capture stream.
+     *
+     * After this call anything written to the standard output ends up in
+     * the standard error, and the original standard output is used only for
+     * the captured frames. It should be called as early as possible, before
+     * any messages have been printed.
+     *
+     * @return whether the standard output was reserved successfully
+     */
+    static bool reserve_stdout();
+
+    /**
+     * Prepares the capture destination and starts the encoding threads,
+     * according to the capture options.
+     *
+     * @return whether initialization succeeded
+     */
+    bool init();
+
+    /**
+     * Starts capturing the frames of a scene.
+     *
+     * This must be called while the scene's GL context is current.
+     *
+     * @param name the name of the scene, used in the file names
+     */
+    void begin_scene(const std::string &name);
+
+    /**
+     * Captures the current contents of the canvas, if the current frame is
+     * one that should be captured.
+     *
+     * This should be called after all drawing for the frame has been
+     * done, but before the canvas is updated.
+     */
+    void capture();
+
+    /**
+     * Completes the pending reads of the current scene and releases the
+     * associated GL resources.
+     *
+     * This must be called before the scene's GL context goes away.
+     */
+    void end_scene();
+
+    /**
+     * Waits until all queued frames have been written.
+     */
+    void finish();
+
+    /**
+     * Gets the number of frames that have been written.
+     */
+    unsigned int frames_written();
+
+private:
+    struct Job {
+        std::vector<uint8_t> pixels;
+        int width;
+        int height;
+        std::string filename;
+    };
+
+    void submit(std::vector<uint8_t> &pixels, unsigned int frame);
+    void worker();
+    bool write_png(const Job &job);
+    bool write_stream(const Job &job);
+    void rgba_to_i420(const Job &job);
+
+    Canvas &canvas_;
+    AsyncReadback readback_;
+    bool async_;
+    Options::CaptureFormat format_;
+    bool stream_;
+    int width_;
+    int height_;
+    std::string scene_name_;
+    unsigned int scene_index_;
+    unsigned int frame_;
+    std::deque<unsigned int> in_flight_;
+    std::vector<uint8_t> pixels_;
+
+    std::FILE *output_;
+    bool stream_header_written_;
+    int stream_width_;
+    int stream_height_;
+    std::vector<uint8_t> yuv_;
+
+    std::deque<Job> queue_;
+    size_t queue_limit_;
+    std::mutex mutex_;
+    std::condition_variable queue_not_empty_;
+    std::condition_variable queue_not_full_;
+    std::condition_variable queue_idle_;
+    unsigned int busy_workers_;
+    bool stopping_;
+    unsigned int frames_written_;
+    unsigned int write_errors_;
+    std::vector<std::thread> workers_;
+
+    static std::FILE *stdout_;
+};
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "frame-pacer.h"
+#include "canvas.h"
+#include "gl-headers.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+
+#if defined(_WIN32) || defined(__APPLE__)
+#include <chrono>
+#include <thread>
+#else
+#include <time.h>
+#endif
+
+FramePacer::FramePacer(Canvas &canvas, double target_fps) :
+    canvas_(canvas), period_(1.0 / target_fps)
+{
+    start();
+}
+
+void
+FramePacer::start()
+{
+    deadline_ = 0.0;
+    frame_start_ = 0.0;
+    missed_ = 0;
+    latencies_.clear();
+    cpu_time_ = 0.0;
+    gpu_time_ = 0.0;
+}
+
+void
+FramePacer::begin_frame()
+{
+    if (deadline_ == 0.0)
+        deadline_ = now();
+
+    sleep_until(deadline_);
+
+    frame_start_ = now();
+}
+
+void
+FramePacer::end_frame()
+{
+    double submitted = now();
+
+    std::unique_ptr<GLStateSync> sync(canvas_.sync());
+    if (sync)
+        sync->wait();
+    else
+        glFinish();
+
+    double completed = now();
+
+    cpu_time_ += submitted - frame_start_;
+    gpu_time_ += completed - submitted;
+    latencies_.push_back(completed - frame_start_);
+
+    deadline_ += period_;
+
+    /* Start over from now, instead of trying to catch up with late frames */
+    if (completed > deadline_) {
+        missed_++;
+        deadline_ = completed;
+    }
+}
+
+FramePacer::Stats
+FramePacer::stats() const
+{
+    Stats stats = Stats();
+
+    stats.frames = latencies_.size();
+    stats.missed = missed_;
+
+    if (latencies_.empty())
+        return stats;
+
+    std::vector<double> sorted(latencies_);
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (double latency : sorted)
+        sum += latency;
+
+    size_t p99 = std::min(sorted.size() - 1,
+                          static_cast<size_t>(std::ceil(0.99 * sorted.size())) - 1);
+
+    stats.average_latency = sum / sorted.size();
+    stats.p99_latency = sorted[p99];
+    stats.average_cpu_time = cpu_time_ / sorted.size();
+    stats.average_gpu_time = gpu_time_ / sorted.size();
+    stats.average_headroom = 1.0 - stats.average_latency / period_;
+    stats.p99_headroom = 1.0 - stats.p99_latency / period_;
+
+    return stats;
+}
+
+#if defined(_WIN32) || defined(__APPLE__)
+
+double
+FramePacer::now()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void
+FramePacer::sleep_until(double time)
+{
+    std::this_thread::sleep_until(
+        std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(time))));
+}
+
+#else
+
+double
+FramePacer::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+void
+FramePacer::sleep_until(double time)
+{
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(time);
+    ts.tv_nsec = static_cast<long>((time - ts.tv_sec) * 1000000000.0);
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+
+    /* An absolute deadline doesn't drift when the sleep is interrupted */
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+        ;
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_FRAME_PACER_H_
+#define GLMARK2_FRAME_PACER_H_
+
+#include <vector>
+
+class Canvas;
+
+/**
+ * Paces frames to a target frame rate and measures how well it is held.
+ *
+ * Each frame starts at an absolute deadline, one frame period after the
+ * previous one. After the frame has been submitted, the pacer waits for a
+ * fence (or glFinish() if fences are not supported) to find out when the
+ * GPU completed it. A frame that completes after the start of the next one
+ * misses its deadline, and the next frames are then scheduled from the time
+ * it completed.
+ */
+class FramePacer
+{
+public:
+    struct Stats {
+        unsigned int frames;
+        unsigned int missed;
+        /* From the start of a frame to the completion of its GPU work */
+        double average_latency;
+        double p99_latency;
+        /* The CPU time to submit a frame, and the time the GPU took after that */
+        double average_cpu_time;
+        double average_gpu_time;
+        /* The fraction of the frame period left unused */
+        double average_headroom;
+        double p99_headroom;
+    };
+
+    FramePacer(Canvas &canvas, double target_fps);
+
+    /**
+     * Starts pacing the frames of a new benchmark.
+     */
+    void start();
+
+    /**
+     * Waits until the deadline of the next frame.
+     */
+    void begin_frame();
+
+    /**
+     * Waits for the frame to complete and records its timings.
+     */
+    void end_frame();
+
+    /**
+     * Gets the statistics of the frames since ::start().
+     */
+    Stats stats() const;
+
+    double target_fps() const { return 1.0 / period_; }
+
+private:
+    static double now();
+    static void sleep_until(double time);
+
+    Canvas &canvas_;
+    double period_;
+    double deadline_;
+    double frame_start_;
+    unsigned int missed_;
+    std::vector<double> latencies_;
+    double cpu_time_;
+    double gpu_time_;
+};
+
+#endif
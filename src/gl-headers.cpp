@@ -21,8 +21,11 @@
  */
 #include "gl-headers.h"
 
+#include <cstdio>
+
 void* (GLAD_API_PTR *GLExtensions::MapBuffer) (GLenum target, GLenum access) = 0;
 GLboolean (GLAD_API_PTR *GLExtensions::UnmapBuffer) (GLenum target) = 0;
+void* (GLAD_API_PTR *GLExtensions::MapBufferRange) (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) = 0;
 
 void (GLAD_API_PTR *GLExtensions::GenFramebuffers)(GLsizei n, GLuint *framebuffers) = 0;
 void (GLAD_API_PTR *GLExtensions::DeleteFramebuffers)(GLsizei n, const GLuint * framebuffers) = 0;
@@ -38,6 +41,39 @@ void (GLAD_API_PTR *GLExtensions::RenderbufferStorage)(GLenum target, GLenum int
 
 void (GLAD_API_PTR *GLExtensions::GenerateMipmap)(GLenum target) = 0;
 
+void (GLAD_API_PTR *GLExtensions::DrawBuffers)(GLsizei n, const GLenum *bufs) = 0;
+
+void (GLAD_API_PTR *GLExtensions::TexImage3D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels) = 0;
+
+void (GLAD_API_PTR *GLExtensions::GenVertexArrays)(GLsizei n, GLuint *arrays) = 0;
+void (GLAD_API_PTR *GLExtensions::DeleteVertexArrays)(GLsizei n, const GLuint *arrays) = 0;
+void (GLAD_API_PTR *GLExtensions::BindVertexArray)(GLuint array) = 0;
+
+void (GLAD_API_PTR *GLExtensions::DrawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) = 0;
+void (GLAD_API_PTR *GLExtensions::DrawElementsInstanced)(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount) = 0;
+void (GLAD_API_PTR *GLExtensions::VertexAttribDivisor)(GLuint index, GLuint divisor) = 0;
+
+GLuint (GLAD_API_PTR *GLExtensions::GetUniformBlockIndex)(GLuint program, const GLchar *uniformBlockName) = 0;
+void (GLAD_API_PTR *GLExtensions::UniformBlockBinding)(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) = 0;
+void (GLAD_API_PTR *GLExtensions::BindBufferRange)(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) = 0;
+void (GLAD_API_PTR *GLExtensions::BufferStorage)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags) = 0;
+
+void (GLAD_API_PTR *GLExtensions::GetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary) = 0;
+void (GLAD_API_PTR *GLExtensions::ProgramBinary)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length) = 0;
+void (GLAD_API_PTR *GLExtensions::ProgramParameteri)(GLuint program, GLenum pname, GLint value) = 0;
+
+void (GLAD_API_PTR *GLExtensions::MaxShaderCompilerThreads)(GLuint count) = 0;
+
+void (GLAD_API_PTR *GLExtensions::BeginTransformFeedback)(GLenum primitiveMode) = 0;
+void (GLAD_API_PTR *GLExtensions::EndTransformFeedback)(void) = 0;
+void (GLAD_API_PTR *GLExtensions::TransformFeedbackVaryings)(GLuint program, GLsizei count, const GLchar *const *varyings, GLenum bufferMode) = 0;
+
+void (GLAD_API_PTR *GLExtensions::BindBufferBase)(GLenum target, GLuint index, GLuint buffer) = 0;
+void (GLAD_API_PTR *GLExtensions::TexStorage2D)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height) = 0;
+void (GLAD_API_PTR *GLExtensions::DispatchCompute)(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z) = 0;
+void (GLAD_API_PTR *GLExtensions::MemoryBarrierGL)(GLbitfield barriers) = 0;
+void (GLAD_API_PTR *GLExtensions::BindImageTexture)(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format) = 0;
+
 bool
 GLExtensions::support(const std::string &ext)
 {
@@ -112,3 +148,75 @@ GLExtensions::is_core_profile()
     return false;
 #endif
 }
+
+bool
+GLExtensions::version_at_least(int major, int minor)
+{
+    const char* ver = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (!ver)
+        return false;
+
+    /* Skip any prefix, e.g., "OpenGL ES " or "OpenGL ES-CM " */
+    while (*ver && (*ver < '0' || *ver > '9'))
+        ver++;
+
+    int ctx_major = 0;
+    int ctx_minor = 0;
+    if (sscanf(ver, "%d.%d", &ctx_major, &ctx_minor) != 2)
+        return false;
+
+    return ctx_major > major || (ctx_major == major && ctx_minor >= minor);
+}
+
+template<typename T> static void
+load_entry_point(T &entry_point, GLADuserptrloadfunc load, void *userptr,
+                 const char *name)
+{
+    entry_point = reinterpret_cast<T>(load(userptr, name));
+}
+
+void
+GLExtensions::load_core_entry_points(GLADuserptrloadfunc load, void *userptr)
+{
+    load_entry_point(MapBufferRange, load, userptr, "glMapBufferRange");
+    load_entry_point(TexImage3D, load, userptr, "glTexImage3D");
+    load_entry_point(DrawBuffers, load, userptr, "glDrawBuffers");
+
+    load_entry_point(GenVertexArrays, load, userptr, "glGenVertexArrays");
+    load_entry_point(DeleteVertexArrays, load, userptr, "glDeleteVertexArrays");
+    load_entry_point(BindVertexArray, load, userptr, "glBindVertexArray");
+
+    load_entry_point(DrawArraysInstanced, load, userptr, "glDrawArraysInstanced");
+    load_entry_point(DrawElementsInstanced, load, userptr, "glDrawElementsInstanced");
+    load_entry_point(VertexAttribDivisor, load, userptr, "glVertexAttribDivisor");
+
+    load_entry_point(GetUniformBlockIndex, load, userptr, "glGetUniformBlockIndex");
+    load_entry_point(UniformBlockBinding, load, userptr, "glUniformBlockBinding");
+    load_entry_point(BindBufferRange, load, userptr, "glBindBufferRange");
+
+    load_entry_point(BufferStorage, load, userptr, "glBufferStorage");
+    if (!BufferStorage)
+        load_entry_point(BufferStorage, load, userptr, "glBufferStorageEXT");
+
+    load_entry_point(GetProgramBinary, load, userptr, "glGetProgramBinary");
+    load_entry_point(ProgramBinary, load, userptr, "glProgramBinary");
+    if (!GetProgramBinary || !ProgramBinary) {
+        load_entry_point(GetProgramBinary, load, userptr, "glGetProgramBinaryOES");
+        load_entry_point(ProgramBinary, load, userptr, "glProgramBinaryOES");
+    }
+    load_entry_point(ProgramParameteri, load, userptr, "glProgramParameteri");
+
+    load_entry_point(MaxShaderCompilerThreads, load, userptr, "glMaxShaderCompilerThreadsKHR");
+    if (!MaxShaderCompilerThreads)
+        load_entry_point(MaxShaderCompilerThreads, load, userptr, "glMaxShaderCompilerThreadsARB");
+
+    load_entry_point(BeginTransformFeedback, load, userptr, "glBeginTransformFeedback");
+    load_entry_point(EndTransformFeedback, load, userptr, "glEndTransformFeedback");
+    load_entry_point(TransformFeedbackVaryings, load, userptr, "glTransformFeedbackVaryings");
+
+    load_entry_point(BindBufferBase, load, userptr, "glBindBufferBase");
+    load_entry_point(TexStorage2D, load, userptr, "glTexStorage2D");
+    load_entry_point(DispatchCompute, load, userptr, "glDispatchCompute");
+    load_entry_point(MemoryBarrierGL, load, userptr, "glMemoryBarrier");
+    load_entry_point(BindImageTexture, load, userptr, "glBindImageTexture");
+}
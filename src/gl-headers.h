@@ -87,6 +87,147 @@
 #endif
 #endif
 
+/*
+ * Tokens for functionality that is core in GL 3.0 / GLES 3.0 and is
+ * therefore missing from the generated GL 2.1 / GLES 2.0 headers.
+ */
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+#ifndef GL_TEXTURE_2D_ARRAY
+#define GL_TEXTURE_2D_ARRAY 0x8C1A
+#endif
+#ifndef GL_MAX_ARRAY_TEXTURE_LAYERS
+#define GL_MAX_ARRAY_TEXTURE_LAYERS 0x88FF
+#endif
+#ifndef GL_RGBA32F
+#define GL_RGBA32F 0x8814
+#endif
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER 0x8A11
+#endif
+#ifndef GL_MAX_UNIFORM_BLOCK_SIZE
+#define GL_MAX_UNIFORM_BLOCK_SIZE 0x8A30
+#endif
+#ifndef GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
+#endif
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX 0xFFFFFFFFu
+#endif
+#ifndef GL_MAX_DRAW_BUFFERS
+#define GL_MAX_DRAW_BUFFERS 0x8824
+#endif
+#ifndef GL_MAX_COLOR_ATTACHMENTS
+#define GL_MAX_COLOR_ATTACHMENTS 0x8CDF
+#endif
+#ifndef GL_COLOR_ATTACHMENT1
+#define GL_COLOR_ATTACHMENT1 0x8CE1
+#endif
+#ifndef GL_RGB10_A2
+#define GL_RGB10_A2 0x8059
+#endif
+#ifndef GL_RGBA16F
+#define GL_RGBA16F 0x881A
+#endif
+#ifndef GL_R11F_G11F_B10F
+#define GL_R11F_G11F_B10F 0x8C3A
+#endif
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif
+#ifndef GL_UNSIGNED_INT_2_10_10_10_REV
+#define GL_UNSIGNED_INT_2_10_10_10_REV 0x8368
+#endif
+#ifndef GL_UNSIGNED_INT_10F_11F_11F_REV
+#define GL_UNSIGNED_INT_10F_11F_11F_REV 0x8C3B
+#endif
+
+/* Tokens for buffer storage (GL 4.4, GL_ARB/EXT_buffer_storage) */
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+/* Tokens for program binaries (GL 4.1, GLES 3.0, GL_ARB/OES_get_program_binary) */
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+/* Tokens for parallel shader compilation (GL_KHR/ARB_parallel_shader_compile) */
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+/* Tokens for transform feedback (GL 3.0, GLES 3.0) */
+#ifndef GL_TRANSFORM_FEEDBACK_BUFFER
+#define GL_TRANSFORM_FEEDBACK_BUFFER 0x8C8E
+#endif
+#ifndef GL_INTERLEAVED_ATTRIBS
+#define GL_INTERLEAVED_ATTRIBS 0x8C8C
+#endif
+#ifndef GL_RASTERIZER_DISCARD
+#define GL_RASTERIZER_DISCARD 0x8C89
+#endif
+
+/* Tokens for compute shaders (GL 4.3, GLES 3.1) */
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DYNAMIC_COPY
+#define GL_DYNAMIC_COPY 0x88EA
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY 0x88B8
+#endif
+#ifndef GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#endif
+#ifndef GL_TEXTURE_FETCH_BARRIER_BIT
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#endif
+#ifndef GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x00000020
+#endif
+#ifndef GL_BUFFER_UPDATE_BARRIER_BIT
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_PROGRAM_POINT_SIZE
+#define GL_PROGRAM_POINT_SIZE 0x8642
+#endif
+
 #include <string>
 
 /**
@@ -108,8 +249,33 @@ struct GLExtensions {
      */
     static bool is_core_profile();
 
+    /**
+     * Whether the current context version is at least major.minor.
+     *
+     * The version is that of the API in use, i.e., GLES versions for
+     * GLES contexts and desktop GL versions for GL contexts.
+     *
+     * @return true if the context version is at least major.minor
+     */
+    static bool version_at_least(int major, int minor);
+
+    /**
+     * Loads the entry points that are not covered by the generated GL 2.1 /
+     * GLES 2.0 loader, because they only became core in later versions.
+     *
+     * Entry points that the implementation doesn't expose are set to 0.
+     * Since implementations may expose entry points they don't support
+     * in the current context, users should also check the context version
+     * or extensions.
+     *
+     * @param load the function to use for loading entry points
+     * @param userptr the user data to pass to the load function
+     */
+    static void load_core_entry_points(GLADuserptrloadfunc load, void *userptr);
+
     static void* (GLAD_API_PTR *MapBuffer) (GLenum target, GLenum access);
     static GLboolean (GLAD_API_PTR *UnmapBuffer) (GLenum target);
+    static void* (GLAD_API_PTR *MapBufferRange) (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
 
     static void (GLAD_API_PTR *GenFramebuffers)(GLsizei n, GLuint *framebuffers);
     static void (GLAD_API_PTR *DeleteFramebuffers)(GLsizei n, const GLuint * framebuffers);
@@ -124,6 +290,41 @@ struct GLExtensions {
     static void (GLAD_API_PTR *RenderbufferStorage)(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
 
     static void (GLAD_API_PTR *GenerateMipmap)(GLenum target);
+
+    static void (GLAD_API_PTR *DrawBuffers)(GLsizei n, const GLenum *bufs);
+
+    static void (GLAD_API_PTR *TexImage3D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels);
+
+    static void (GLAD_API_PTR *GenVertexArrays)(GLsizei n, GLuint *arrays);
+    static void (GLAD_API_PTR *DeleteVertexArrays)(GLsizei n, const GLuint *arrays);
+    static void (GLAD_API_PTR *BindVertexArray)(GLuint array);
+
+    static void (GLAD_API_PTR *DrawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+    static void (GLAD_API_PTR *DrawElementsInstanced)(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount);
+    static void (GLAD_API_PTR *VertexAttribDivisor)(GLuint index, GLuint divisor);
+
+    static GLuint (GLAD_API_PTR *GetUniformBlockIndex)(GLuint program, const GLchar *uniformBlockName);
+    static void (GLAD_API_PTR *UniformBlockBinding)(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+    static void (GLAD_API_PTR *BindBufferRange)(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    static void (GLAD_API_PTR *BufferStorage)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+    static void (GLAD_API_PTR *GetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+    static void (GLAD_API_PTR *ProgramBinary)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+    static void (GLAD_API_PTR *ProgramParameteri)(GLuint program, GLenum pname, GLint value);
+
+    static void (GLAD_API_PTR *MaxShaderCompilerThreads)(GLuint count);
+
+    static void (GLAD_API_PTR *BeginTransformFeedback)(GLenum primitiveMode);
+    static void (GLAD_API_PTR *EndTransformFeedback)(void);
+    static void (GLAD_API_PTR *TransformFeedbackVaryings)(GLuint program, GLsizei count, const GLchar *const *varyings, GLenum bufferMode);
+
+    static void (GLAD_API_PTR *BindBufferBase)(GLenum target, GLuint index, GLuint buffer);
+    static void (GLAD_API_PTR *TexStorage2D)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+    static void (GLAD_API_PTR *DispatchCompute)(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+    /* Not named MemoryBarrier, which is a macro in windows.h */
+    static void (GLAD_API_PTR *MemoryBarrierGL)(GLbitfield barriers);
+    static void (GLAD_API_PTR *BindImageTexture)(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format);
 };
 
 #endif
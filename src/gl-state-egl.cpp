@@ -396,6 +396,9 @@ GLStateEGL::init_gl_extensions()
 
     GLExtensions::GenerateMipmap = glGenerateMipmapEXT;
 #endif
+
+    GLExtensions::load_core_entry_points(load_proc, &gl_lib_);
+
     return true;
 }
 
@@ -538,6 +541,62 @@ GLStateEGL::sync()
     return std::make_unique<GLStateSyncEGL>(egl_display_);
 }
 
+struct GLStateContextEGL : public GLStateContext
+{
+    GLStateContextEGL(EGLDisplay display, EGLContext context)
+        : display(display), context(context)
+    {
+    }
+    ~GLStateContextEGL() override { eglDestroyContext(display, context); }
+    bool make_current() override
+    {
+        if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            Log::error("eglMakeCurrent failed with error: 0x%x\n", eglGetError());
+            return false;
+        }
+        return true;
+    }
+    void release() override
+    {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (eglReleaseThread)
+            eglReleaseThread();
+    }
+    EGLDisplay display;
+    EGLContext context;
+};
+
+std::unique_ptr<GLStateContext>
+GLStateEGL::create_context(bool shared)
+{
+    if (!gotValidContext())
+        return nullptr;
+
+    /* The additional contexts render to FBOs only */
+    const char *extensions = eglQueryString(egl_display_, EGL_EXTENSIONS);
+    if (!extensions || !strstr(extensions, "EGL_KHR_surfaceless_context")) {
+        Log::error("Additional contexts require EGL_KHR_surfaceless_context\n");
+        return nullptr;
+    }
+
+    static const EGLint context_attribs[] = {
+#ifdef GLMARK2_USE_GLESv2
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+#endif
+        EGL_NONE
+    };
+
+    EGLContext context = eglCreateContext(egl_display_, egl_config_,
+                                          shared ? egl_context_ : EGL_NO_CONTEXT,
+                                          context_attribs);
+    if (!context) {
+        Log::error("eglCreateContext() failed with error: 0x%x\n", eglGetError());
+        return nullptr;
+    }
+
+    return std::make_unique<GLStateContextEGL>(egl_display_, context);
+}
+
 /******************************
  * GLStateEGL private methods *
  *****************************/
@@ -155,6 +155,7 @@ public:
     void getVisualConfig(GLVisualConfig& vc);
     bool supports_sync();
     std::unique_ptr<GLStateSync> sync();
+    std::unique_ptr<GLStateContext> create_context(bool shared);
 };
 
 #endif // GLMARK2_GL_STATE_EGL_H_
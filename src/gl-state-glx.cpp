@@ -125,6 +125,8 @@ GLStateGLX::init_gl_extensions()
 
     GLExtensions::GenerateMipmap = glGenerateMipmapEXT;
 
+    GLExtensions::load_core_entry_points(load_proc, this);
+
     return true;
 }
 
@@ -106,6 +106,8 @@ bool GLStateMacOS::init_gl_extensions()
     if (!GLExtensions::GenerateMipmap)
         GLExtensions::GenerateMipmap = reinterpret_cast<decltype(GLExtensions::GenerateMipmap)>(load("glGenerateMipmapEXT"));
 
+    GLExtensions::load_core_entry_points(load_proc, this);
+
     return true;
 }
 
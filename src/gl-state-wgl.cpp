@@ -129,6 +129,8 @@ GLStateWGL::init_gl_extensions()
 
     GLExtensions::GenerateMipmap = glGenerateMipmapEXT;
 
+    GLExtensions::load_core_entry_points(load_proc, this);
+
     return true;
 }
 
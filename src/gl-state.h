@@ -35,6 +35,21 @@ public:
     virtual void wait() = 0;
 };
 
+/**
+ * An additional GL context, for rendering from another thread.
+ *
+ * The context has no surface, so it can only render to framebuffer objects.
+ */
+class GLStateContext
+{
+public:
+    virtual ~GLStateContext() = default;
+    /** Makes the context current in the calling thread */
+    virtual bool make_current() = 0;
+    /** Releases the context from the calling thread */
+    virtual void release() = 0;
+};
+
 class GLState
 {
 public:
@@ -50,6 +65,15 @@ public:
     virtual void getVisualConfig(GLVisualConfig& vc) = 0;
     virtual bool supports_sync() = 0;
     virtual std::unique_ptr<GLStateSync> sync() = 0;
+    /**
+     * Creates an additional context, optionally sharing its objects with
+     * the main context. Returns nullptr if this isn't supported.
+     */
+    virtual std::unique_ptr<GLStateContext> create_context(bool shared)
+    {
+        static_cast<void>(shared);
+        return nullptr;
+    }
 };
 
 #endif /* GLMARK2_GL_STATE_H_ */
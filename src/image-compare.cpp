@@ -0,0 +1,277 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "image-compare.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+const unsigned int ssim_block_size = 8;
+
+struct Partial
+{
+    Partial() : max_diff(0), bad_pixels(0), sq_error(0),
+                ssim_sum(0.0), ssim_blocks(0) {}
+
+    unsigned int max_diff;
+    uint64_t bad_pixels;
+    uint64_t sq_error;
+    double ssim_sum;
+    uint64_t ssim_blocks;
+};
+
+void
+compare_pixels_scalar(const uint8_t *a, const uint8_t *b, unsigned int npixels,
+                      unsigned int tolerance, Partial &p)
+{
+    for (unsigned int i = 0; i < npixels; i++) {
+        unsigned int pixel_max = 0;
+        for (unsigned int c = 0; c < 3; c++) {
+            int d = std::abs(a[4 * i + c] - b[4 * i + c]);
+            pixel_max = std::max(pixel_max, static_cast<unsigned int>(d));
+            p.sq_error += d * d;
+        }
+        p.max_diff = std::max(p.max_diff, pixel_max);
+        if (pixel_max > tolerance)
+            p.bad_pixels++;
+    }
+}
+
+#if defined(__SSE2__)
+/*
+ * Processes four pixels per iteration. The per-lane 32-bit squared error
+ * sums can take at most 4096 iterations before they risk overflowing, so
+ * they are folded into the 64-bit total in chunks.
+ */
+void
+compare_pixels(const uint8_t *a, const uint8_t *b, unsigned int npixels,
+               unsigned int tolerance, Partial &p)
+{
+    static const int bits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+    static const unsigned int chunk = 4 * 4096;
+
+    const __m128i rgb_mask = _mm_set1_epi32(0x00ffffff);
+    const __m128i tol = _mm_set1_epi8(static_cast<char>(std::min(tolerance, 255u)));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vmax = zero;
+    unsigned int i = 0;
+
+    while (i + 4 <= npixels) {
+        unsigned int end = std::min(npixels & ~3u, i + chunk);
+        __m128i vsq = zero;
+
+        for (; i < end; i += 4) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 4 * i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 4 * i));
+            __m128i d = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+            d = _mm_and_si128(d, rgb_mask);
+
+            vmax = _mm_max_epu8(vmax, d);
+
+            __m128i over = _mm_subs_epu8(d, tol);
+            int good = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(over, zero)));
+            p.bad_pixels += 4 - bits[good];
+
+            __m128i lo = _mm_unpacklo_epi8(d, zero);
+            __m128i hi = _mm_unpackhi_epi8(d, zero);
+            vsq = _mm_add_epi32(vsq, _mm_add_epi32(_mm_madd_epi16(lo, lo),
+                                                   _mm_madd_epi16(hi, hi)));
+        }
+
+        uint32_t sq[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sq), vsq);
+        p.sq_error += static_cast<uint64_t>(sq[0]) + sq[1] + sq[2] + sq[3];
+    }
+
+    uint8_t max[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(max), vmax);
+    for (unsigned int c = 0; c < 16; c++)
+        p.max_diff = std::max(p.max_diff, static_cast<unsigned int>(max[c]));
+
+    compare_pixels_scalar(a + 4 * i, b + 4 * i, npixels - i, tolerance, p);
+}
+#else
+void
+compare_pixels(const uint8_t *a, const uint8_t *b, unsigned int npixels,
+               unsigned int tolerance, Partial &p)
+{
+    compare_pixels_scalar(a, b, npixels, tolerance, p);
+}
+#endif
+
+inline double
+luma(const uint8_t *p)
+{
+    return (77 * p[0] + 150 * p[1] + 29 * p[2]) / 256.0;
+}
+
+/**
+ * Calculates the SSIM of the luma of a block of pixels.
+ */
+double
+block_ssim(const uint8_t *a, const uint8_t *b, unsigned int stride)
+{
+    static const double c1 = (0.01 * 255) * (0.01 * 255);
+    static const double c2 = (0.03 * 255) * (0.03 * 255);
+    static const double n = ssim_block_size * ssim_block_size;
+
+    double sum_a = 0.0, sum_b = 0.0;
+    double sum_aa = 0.0, sum_bb = 0.0, sum_ab = 0.0;
+
+    for (unsigned int y = 0; y < ssim_block_size; y++) {
+        const uint8_t *ra = a + y * stride;
+        const uint8_t *rb = b + y * stride;
+        for (unsigned int x = 0; x < ssim_block_size; x++) {
+            double la = luma(ra + 4 * x);
+            double lb = luma(rb + 4 * x);
+            sum_a += la;
+            sum_b += lb;
+            sum_aa += la * la;
+            sum_bb += lb * lb;
+            sum_ab += la * lb;
+        }
+    }
+
+    double mean_a = sum_a / n;
+    double mean_b = sum_b / n;
+    double var_a = sum_aa / n - mean_a * mean_a;
+    double var_b = sum_bb / n - mean_b * mean_b;
+    double cov = sum_ab / n - mean_a * mean_b;
+
+    return ((2 * mean_a * mean_b + c1) * (2 * cov + c2)) /
+           ((mean_a * mean_a + mean_b * mean_b + c1) * (var_a + var_b + c2));
+}
+
+/**
+ * Compares the rows [row_start, row_end) of two images.
+ *
+ * The SSIM is calculated for the blocks whose top row is in the range
+ * and fit completely in the image.
+ */
+void
+compare_band(const uint8_t *a, const uint8_t *b, unsigned int width,
+             unsigned int height, unsigned int row_start, unsigned int row_end,
+             unsigned int tolerance, Partial &p)
+{
+    const size_t stride = static_cast<size_t>(width) * 4;
+
+    for (unsigned int y = row_start; y < row_end; y++)
+        compare_pixels(a + y * stride, b + y * stride, width, tolerance, p);
+
+    for (unsigned int y = row_start; y < row_end; y += ssim_block_size) {
+        if (y + ssim_block_size > height)
+            break;
+        for (unsigned int x = 0; x + ssim_block_size <= width; x += ssim_block_size) {
+            p.ssim_sum += block_ssim(a + y * stride + 4 * x,
+                                     b + y * stride + 4 * x, stride);
+            p.ssim_blocks++;
+        }
+    }
+}
+
+}
+
+ImageCompare::Result
+ImageCompare::compare(const uint8_t *a, const uint8_t *b,
+                      unsigned int width, unsigned int height,
+                      unsigned int tolerance)
+{
+    /* Keep the bands reasonably large, and aligned to the SSIM blocks */
+    static const unsigned int min_band_rows = 64;
+
+    unsigned int nbands = std::max(1u, Util::get_num_processors());
+    nbands = std::max(1u, std::min(nbands, height / min_band_rows));
+
+    unsigned int band_rows = (height / nbands) & ~(ssim_block_size - 1);
+    std::vector<Partial> partials(nbands);
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 1; i < nbands; i++) {
+        unsigned int start = i * band_rows;
+        unsigned int end = (i == nbands - 1) ? height : start + band_rows;
+        threads.emplace_back(compare_band, a, b, width, height, start, end,
+                             tolerance, std::ref(partials[i]));
+    }
+
+    compare_band(a, b, width, height, 0, nbands > 1 ? band_rows : height,
+                 tolerance, partials[0]);
+
+    for (auto &t : threads)
+        t.join();
+
+    Partial total;
+    for (auto const &p : partials) {
+        total.max_diff = std::max(total.max_diff, p.max_diff);
+        total.bad_pixels += p.bad_pixels;
+        total.sq_error += p.sq_error;
+        total.ssim_sum += p.ssim_sum;
+        total.ssim_blocks += p.ssim_blocks;
+    }
+
+    Result result;
+    result.max_diff = total.max_diff;
+    result.bad_pixels = total.bad_pixels;
+
+    double mse = total.sq_error / (3.0 * width * height);
+    if (mse > 0.0)
+        result.psnr = 10.0 * std::log10(255.0 * 255.0 / mse);
+    else
+        result.psnr = std::numeric_limits<double>::infinity();
+
+    result.ssim = total.ssim_blocks ? total.ssim_sum / total.ssim_blocks : 1.0;
+
+    return result;
+}
+
+void
+ImageCompare::diff_image(const uint8_t *a, const uint8_t *b,
+                         unsigned int width, unsigned int height,
+                         unsigned int tolerance, std::vector<uint8_t> &diff)
+{
+    const size_t npixels = static_cast<size_t>(width) * height;
+
+    diff.resize(npixels * 4);
+
+    for (size_t i = 0; i < npixels; i++) {
+        unsigned int d = 0;
+        for (unsigned int c = 0; c < 3; c++)
+            d = std::max(d, static_cast<unsigned int>(std::abs(a[4 * i + c] - b[4 * i + c])));
+
+        uint8_t *p = &diff[4 * i];
+        if (d > tolerance) {
+            p[0] = 0xff;
+            p[1] = 0;
+            p[2] = 0;
+        }
+        else {
+            p[0] = p[1] = p[2] = std::min(255u, d * 16);
+        }
+        p[3] = 0xff;
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_IMAGE_COMPARE_H_
+#define GLMARK2_IMAGE_COMPARE_H_
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Compares RGBA images, 8 bits per component.
+ *
+ * Only the RGB components are compared. The work is split in bands of rows
+ * that are processed in parallel, one per available processor.
+ */
+struct ImageCompare {
+    struct Result {
+        /** The largest difference of any component of any pixel */
+        unsigned int max_diff;
+        /** The number of pixels with a component difference > tolerance */
+        uint64_t bad_pixels;
+        /** The peak signal-to-noise ratio in dB (infinite for equal images) */
+        double psnr;
+        /** The mean structural similarity of the luma, in 8x8 blocks */
+        double ssim;
+    };
+
+    /**
+     * Compares two images of the same size.
+     *
+     * @param a the first image
+     * @param b the second image
+     * @param width the width of the images in pixels
+     * @param height the height of the images in pixels
+     * @param tolerance the largest per-component difference that doesn't
+     *                  make a pixel count as bad
+     *
+     * @return the comparison result
+     */
+    static Result compare(const uint8_t *a, const uint8_t *b,
+                          unsigned int width, unsigned int height,
+                          unsigned int tolerance);
+
+    /**
+     * Creates an image visualizing the differences between two images.
+     *
+     * Pixels that differ by more than the tolerance are shown in red, other
+     * pixels show the (amplified) difference in grayscale.
+     *
+     * @param a the first image
+     * @param b the second image
+     * @param width the width of the images in pixels
+     * @param height the height of the images in pixels
+     * @param tolerance the per-component tolerance
+     * @param diff the resulting RGBA image
+     */
+    static void diff_image(const uint8_t *a, const uint8_t *b,
+                           unsigned int width, unsigned int height,
+                           unsigned int tolerance, std::vector<uint8_t> &diff);
+};
+
+#endif
@@ -21,13 +21,34 @@
  */
 #include <png.h>
 #include <jpeglib.h>
+#include <algorithm>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 #include "image-reader.h"
 #include "log.h"
 #include "util.h"
 
+/**
+ * Clamps the region requested in the decode options to an image.
+ *
+ * @param options the decode options
+ * @param width the width of the image
+ * @param height the height of the image
+ * @param x, y, w, h the resulting region
+ */
+static void
+clamp_region(const ImageDecodeOptions& options,
+             unsigned int width, unsigned int height,
+             unsigned int &x, unsigned int &y, unsigned int &w, unsigned int &h)
+{
+    x = std::min(options.region_x, width);
+    y = std::min(options.region_y, height);
+    w = options.region_width ? std::min(options.region_width, width - x) : width - x;
+    h = options.region_height ? std::min(options.region_height, height - y) : height - y;
+}
+
 /*******
  * PNG *
  *******/
@@ -36,7 +57,8 @@ struct PNGReaderPrivate
 {
     PNGReaderPrivate() :
         png(0), info(0), rows(0), png_error(0),
-        current_row(0), row_stride(0) {}
+        current_row(0), row_stride(0), region_x(0), region_y(0),
+        width(0), height(0) {}
 
     static void png_read_fn(png_structp png_ptr, png_bytep data, png_size_t length)
     {
@@ -50,12 +72,17 @@ struct PNGReaderPrivate
     bool png_error;
     unsigned int current_row;
     unsigned int row_stride;
+    unsigned int region_x;
+    unsigned int region_y;
+    unsigned int width;
+    unsigned int height;
 };
 
-PNGReader::PNGReader(const std::filesystem::path& filename):
+PNGReader::PNGReader(const std::filesystem::path& filename,
+                     const ImageDecodeOptions& options):
     priv_(new PNGReaderPrivate())
 {
-    priv_->png_error = !init(filename);
+    priv_->png_error = !init(filename, options);
 }
 
 PNGReader::~PNGReader()
@@ -76,7 +103,10 @@ PNGReader::nextRow(unsigned char *dst)
     bool ret;
 
     if (priv_->current_row < height()) {
-        memcpy(dst, priv_->rows[priv_->current_row], priv_->row_stride);
+        memcpy(dst,
+               priv_->rows[priv_->region_y + priv_->current_row] +
+               priv_->region_x * pixelBytes(),
+               priv_->row_stride);
         priv_->current_row++;
         ret = true;
     }
@@ -90,13 +120,13 @@ PNGReader::nextRow(unsigned char *dst)
 unsigned int
 PNGReader::width() const
 { 
-    return png_get_image_width(priv_->png, priv_->info);
+    return priv_->width;
 }
 
 unsigned int
 PNGReader::height() const
 { 
-    return png_get_image_height(priv_->png, priv_->info);
+    return priv_->height;
 }
 
 unsigned int
@@ -111,7 +141,8 @@ PNGReader::pixelBytes() const
 
 
 bool
-PNGReader::init(const std::filesystem::path& filename)
+PNGReader::init(const std::filesystem::path& filename,
+                const ImageDecodeOptions& options)
 {
     static const int png_transforms = PNG_TRANSFORM_STRIP_16 |
                                       PNG_TRANSFORM_GRAY_TO_RGB |
@@ -153,6 +184,13 @@ PNGReader::init(const std::filesystem::path& filename)
 
     priv_->rows = png_get_rows(priv_->png, priv_->info);
 
+    /* PNG can't be decoded partially, so just pick the region out */
+    clamp_region(options,
+                 png_get_image_width(priv_->png, priv_->info),
+                 png_get_image_height(priv_->png, priv_->info),
+                 priv_->region_x, priv_->region_y,
+                 priv_->width, priv_->height);
+
     priv_->current_row = 0;
     priv_->row_stride = width() * pixelBytes();
 
@@ -284,19 +322,30 @@ struct JPEGIStreamSourceMgr
 struct JPEGReaderPrivate
 {
     JPEGReaderPrivate(const std::filesystem::path& filename) :
-        source_mgr(filename), jpeg_error(false) {}
+        source_mgr(filename), jpeg_error(false), region_x(0), region_y(0),
+        width(0), height(0), skip_columns(0), skip_rows(0), rows_read(0) {}
 
     struct jpeg_decompress_struct cinfo;
     JPEGErrorMgr error_mgr;
     JPEGIStreamSourceMgr source_mgr;
     bool jpeg_error;
+    unsigned int region_x;
+    unsigned int region_y;
+    unsigned int width;
+    unsigned int height;
+    /* Columns and rows decoded before the region that need to be dropped */
+    unsigned int skip_columns;
+    unsigned int skip_rows;
+    unsigned int rows_read;
+    std::vector<unsigned char> row;
 };
 
 
-JPEGReader::JPEGReader(const std::filesystem::path& filename) :
+JPEGReader::JPEGReader(const std::filesystem::path& filename,
+                       const ImageDecodeOptions& options) :
     priv_(new JPEGReaderPrivate(filename))
 {
-    priv_->jpeg_error = !init(filename);
+    priv_->jpeg_error = !init(filename, options);
 }
 
 JPEGReader::~JPEGReader()
@@ -315,20 +364,37 @@ bool
 JPEGReader::nextRow(unsigned char *dst)
 {
     bool ret = true;
+    bool use_row = priv_->skip_columns > 0 || priv_->skip_rows > 0 ||
+                   priv_->cinfo.output_width != priv_->width;
     unsigned char *buffer[1];
-    buffer[0] = dst;
+    buffer[0] = use_row ? priv_->row.data() : dst;
 
     /* Set up error handling */
     if (setjmp(priv_->error_mgr.jmp_buffer)) {
         return false;
     }
 
+    /* Drop any rows above the region we couldn't skip while decoding */
+    while (priv_->skip_rows > 0) {
+        jpeg_read_scanlines(&priv_->cinfo, buffer, 1);
+        priv_->skip_rows--;
+    }
+
     /* While there are lines left, read next line */
-    if (priv_->cinfo.output_scanline < priv_->cinfo.output_height) {
+    if (priv_->rows_read < priv_->height) {
         jpeg_read_scanlines(&priv_->cinfo, buffer, 1);
+        if (use_row) {
+            memcpy(dst, &priv_->row[priv_->skip_columns * pixelBytes()],
+                   priv_->width * pixelBytes());
+        }
+        priv_->rows_read++;
     }
     else {
-        jpeg_finish_decompress(&priv_->cinfo);
+        /* We may not have read all the scanlines if decoding a region */
+        if (priv_->cinfo.output_scanline < priv_->cinfo.output_height)
+            jpeg_abort_decompress(&priv_->cinfo);
+        else
+            jpeg_finish_decompress(&priv_->cinfo);
         ret = false;
     }
 
@@ -338,13 +404,13 @@ JPEGReader::nextRow(unsigned char *dst)
 unsigned int
 JPEGReader::width() const
 { 
-    return priv_->cinfo.output_width;
+    return priv_->width;
 }
 
 unsigned int
 JPEGReader::height() const
 { 
-    return priv_->cinfo.output_height;
+    return priv_->height;
 }
 
 unsigned int
@@ -354,7 +420,8 @@ JPEGReader::pixelBytes() const
 }
 
 bool
-JPEGReader::init(const std::filesystem::path& filename)
+JPEGReader::init(const std::filesystem::path& filename,
+                 const ImageDecodeOptions& options)
 {
     Log::debug("Reading JPEG file %s\n", filename.c_str());
 
@@ -371,8 +438,40 @@ JPEGReader::init(const std::filesystem::path& filename)
     /* Read header */
     jpeg_read_header(&priv_->cinfo, TRUE);
 
+    /* Let the decoder do the scaling in the DCT domain */
+    priv_->cinfo.scale_num = 1;
+    priv_->cinfo.scale_denom = options.scale_denom;
+    priv_->cinfo.dct_method = options.fast_idct ? JDCT_IFAST : JDCT_ISLOW;
+    priv_->cinfo.do_fancy_upsampling = options.fancy_upsampling ? TRUE : FALSE;
+
     jpeg_start_decompress(&priv_->cinfo);
 
+    clamp_region(options,
+                 priv_->cinfo.output_width, priv_->cinfo.output_height,
+                 priv_->region_x, priv_->region_y,
+                 priv_->width, priv_->height);
+
+    priv_->skip_columns = priv_->region_x;
+    priv_->skip_rows = priv_->region_y;
+
+#ifdef LIBJPEG_TURBO_VERSION
+    /*
+     * libjpeg-turbo can avoid decoding most of the data outside the
+     * region. The horizontal crop is aligned to the iMCU boundaries, so
+     * we may still need to drop a few columns.
+     */
+    if (priv_->width != priv_->cinfo.output_width) {
+        JDIMENSION xoffset = priv_->region_x;
+        JDIMENSION width = priv_->width;
+        jpeg_crop_scanline(&priv_->cinfo, &xoffset, &width);
+        priv_->skip_columns = priv_->region_x - xoffset;
+    }
+    if (priv_->skip_rows > 0)
+        priv_->skip_rows -= jpeg_skip_scanlines(&priv_->cinfo, priv_->skip_rows);
+#endif
+
+    priv_->row.resize(priv_->cinfo.output_width * priv_->cinfo.output_components);
+
     return true;
 }
 
@@ -22,6 +22,31 @@
 #include <string>
 #include <filesystem>
 
+/**
+ * Settings that control how an image is decoded.
+ *
+ * The region is given in the coordinates of the decoded (possibly scaled)
+ * image, and a zero width or height selects the whole image. Scaling, the
+ * IDCT method and the upsampling method only affect JPEG images.
+ */
+struct ImageDecodeOptions
+{
+    ImageDecodeOptions() :
+        scale_denom(1), fast_idct(false), fancy_upsampling(true),
+        region_x(0), region_y(0), region_width(0), region_height(0) {}
+
+    /** Decode at 1/scale_denom of the full size (1, 2, 4 or 8) */
+    unsigned int scale_denom;
+    /** Use the fast, less accurate integer IDCT */
+    bool fast_idct;
+    /** Use smooth (instead of replicating) chroma upsampling */
+    bool fancy_upsampling;
+    unsigned int region_x;
+    unsigned int region_y;
+    unsigned int region_width;
+    unsigned int region_height;
+};
+
 class ImageReader
 {
 public:
@@ -38,7 +63,8 @@ struct PNGReaderPrivate;
 class PNGReader : public ImageReader
 {
 public:
-    PNGReader(const std::filesystem::path& filename);
+    PNGReader(const std::filesystem::path& filename,
+              const ImageDecodeOptions& options = ImageDecodeOptions());
 
     virtual ~PNGReader();
     bool error();
@@ -49,7 +75,8 @@ public:
     unsigned int pixelBytes() const;
 
 private:
-    bool init(const std::filesystem::path& filename);
+    bool init(const std::filesystem::path& filename,
+              const ImageDecodeOptions& options);
     void finish();
 
     PNGReaderPrivate *priv_;
@@ -60,7 +87,8 @@ struct JPEGReaderPrivate;
 class JPEGReader : public ImageReader
 {
 public:
-    JPEGReader(const std::filesystem::path& filename);
+    JPEGReader(const std::filesystem::path& filename,
+               const ImageDecodeOptions& options = ImageDecodeOptions());
 
     virtual ~JPEGReader();
     bool error();
@@ -70,7 +98,8 @@ public:
     unsigned int pixelBytes() const;
 
 private:
-    bool init(const std::filesystem::path& filename);
+    bool init(const std::filesystem::path& filename,
+              const ImageDecodeOptions& options);
     void finish();
 
     JPEGReaderPrivate *priv_;
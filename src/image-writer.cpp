@@ -0,0 +1,96 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <png.h>
+#include <fstream>
+#include <vector>
+
+#include "image-writer.h"
+#include "log.h"
+
+static void
+png_write_fn(png_structp png_ptr, png_bytep data, png_size_t length)
+{
+    std::ostream *os = reinterpret_cast<std::ostream*>(png_get_io_ptr(png_ptr));
+    os->write(reinterpret_cast<const char *>(data), length);
+}
+
+static void
+png_flush_fn(png_structp png_ptr)
+{
+    std::ostream *os = reinterpret_cast<std::ostream*>(png_get_io_ptr(png_ptr));
+    os->flush();
+}
+
+bool
+PNGWriter::write(const std::filesystem::path &filename,
+                 unsigned int width, unsigned int height,
+                 const unsigned char *pixels, bool bottom_up,
+                 int compression)
+{
+    Log::debug("Writing PNG file %s\n", filename.string().c_str());
+
+    std::ofstream os(filename, std::ios::out | std::ios::binary);
+    if (!os) {
+        Log::error("Cannot open file %s for writing!\n", filename.string().c_str());
+        return false;
+    }
+
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+    if (!png) {
+        Log::error("Couldn't create libpng write struct\n");
+        return false;
+    }
+
+    png_infop info = png_create_info_struct(png);
+    if (!info) {
+        Log::error("Couldn't create libpng info struct\n");
+        png_destroy_write_struct(&png, 0);
+        return false;
+    }
+
+    /* The row pointers must outlive a longjmp from libpng */
+    std::vector<png_bytep> rows(height);
+    const size_t stride = static_cast<size_t>(width) * 4;
+    for (unsigned int i = 0; i < height; i++) {
+        unsigned int row = bottom_up ? height - i - 1 : i;
+        rows[i] = const_cast<png_bytep>(pixels + row * stride);
+    }
+
+    /* Set up libpng error handling */
+    if (setjmp(png_jmpbuf(png))) {
+        Log::error("libpng error while writing file %s\n", filename.string().c_str());
+        png_destroy_write_struct(&png, &info);
+        return false;
+    }
+
+    png_set_write_fn(png, reinterpret_cast<void*>(&os), png_write_fn, png_flush_fn);
+
+    png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGB_ALPHA,
+                 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+                 PNG_FILTER_TYPE_DEFAULT);
+    if (compression >= 0)
+        png_set_compression_level(png, compression);
+
+    png_set_rows(png, info, rows.data());
+    png_write_png(png, info, PNG_TRANSFORM_IDENTITY, 0);
+
+    png_destroy_write_struct(&png, &info);
+
+    return static_cast<bool>(os);
+}
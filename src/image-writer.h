@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_IMAGE_WRITER_H_
+#define GLMARK2_IMAGE_WRITER_H_
+
+#include <filesystem>
+
+class PNGWriter
+{
+public:
+    /**
+     * Writes an RGBA image, 8 bits per component, to a PNG file.
+     *
+     * @param filename the name of the file to write to
+     * @param width the width of the image in pixels
+     * @param height the height of the image in pixels
+     * @param pixels the pixel data, four bytes per pixel with no row padding
+     * @param bottom_up whether the first row in @pixels is the bottom row of
+     *                  the image, as is the case for data from glReadPixels()
+     * @param compression the zlib compression level (0-9), or -1 for the
+     *                    libpng default
+     *
+     * @return whether the image was written successfully
+     */
+    static bool write(const std::filesystem::path &filename,
+                      unsigned int width, unsigned int height,
+                      const unsigned char *pixels, bool bottom_up,
+                      int compression = -1);
+};
+
+#endif
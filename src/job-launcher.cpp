@@ -0,0 +1,605 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "job-launcher.h"
+#include "log.h"
+#include "options.h"
+#include "process-tuning.h"
+#include "results-file.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+namespace
+{
+
+/**
+ * The results file of a worker, which sends the results to the launcher.
+ *
+ * Each section of the results is sent as a line with its type, 'info' or
+ * 'benchmark', followed by a line for each field with the name and value
+ * separated by a tab, and an 'end' line.
+ *
+ * After each section, the worker waits for the launcher to release it by
+ * writing a byte to its release pipe, so that all the workers start each
+ * benchmark together.
+ */
+class PipeResultsFile : public ResultsFile
+{
+public:
+    PipeResultsFile(int fd, int release_fd) :
+        file_(fdopen(fd, "w")), release_fd_(release_fd) {}
+    ~PipeResultsFile()
+    {
+        std::fclose(file_);
+        close(release_fd_);
+    }
+
+    static void install(int fd, int release_fd)
+    {
+        singleton = std::make_unique<PipeResultsFile>(fd, release_fd);
+    }
+
+    std::string type() override { return "pipe"; }
+    void begin() override {}
+    void end() override {}
+    void begin_info() override { std::fputs("info\n", file_); }
+    void end_info() override { end_section(); }
+    void begin_benchmark() override { std::fputs("benchmark\n", file_); }
+    void end_benchmark() override { end_section(); }
+
+    void add_field(const std::string &name, const std::string &value) override
+    {
+        std::string line(name + "\t" + value);
+        for (size_t i = name.size() + 1; i < line.size(); i++) {
+            if (line[i] == '\n' || line[i] == '\t')
+                line[i] = ' ';
+        }
+        std::fprintf(file_, "%s\n", line.c_str());
+    }
+
+private:
+    void end_section()
+    {
+        std::fputs("end\n", file_);
+        std::fflush(file_);
+
+        /* If the launcher has gone, the read fails and the worker goes on */
+        char release;
+        while (read(release_fd_, &release, 1) < 0 && errno == EINTR)
+            ;
+    }
+
+    std::FILE *file_;
+    int release_fd_;
+};
+
+typedef std::vector<std::pair<std::string, std::string> > Fields;
+
+std::string
+field(const Fields &fields, const std::string &name)
+{
+    for (const auto &f : fields) {
+        if (f.first == name)
+            return f.second;
+    }
+    return "";
+}
+
+struct Worker
+{
+    Worker() : index(0), pid(-1), fd(-1), release_fd(-1), reported(0), exit_ok(false) {}
+
+    /**
+     * Parses the complete lines that have been received so far.
+     */
+    void parse()
+    {
+        size_t start = 0;
+        size_t end;
+
+        while ((end = buffer.find('\n', start)) != std::string::npos) {
+            std::string line(buffer, start, end - start);
+            start = end + 1;
+
+            if (in_section.empty()) {
+                if (line == "info")
+                    info.clear();
+                else if (line == "benchmark")
+                    benchmarks.emplace_back();
+                else
+                    continue;
+                in_section = line;
+            }
+            else if (line == "end") {
+                in_section.clear();
+                reported++;
+                if (!benchmarks.empty() && !benchmarks.back().empty()) {
+                    Log::debug("Worker %u: %s FPS: %s\n", index,
+                               field(benchmarks.back(), "name").c_str(),
+                               field(benchmarks.back(), "fps").c_str());
+                }
+            }
+            else {
+                size_t tab = line.find('\t');
+                if (tab == std::string::npos)
+                    continue;
+                Fields &fields(in_section == "info" ? info : benchmarks.back());
+                fields.emplace_back(line.substr(0, tab), line.substr(tab + 1));
+            }
+        }
+
+        buffer.erase(0, start);
+    }
+
+    /**
+     * Gets the frame rate of a benchmark, or a negative value if the
+     * worker didn't run it successfully.
+     */
+    double fps(size_t benchmark) const
+    {
+        if (benchmark >= benchmarks.size())
+            return -1.0;
+
+        const Fields &fields(benchmarks[benchmark]);
+        if (field(fields, "status") != "Success")
+            return -1.0;
+
+        std::string fps(field(fields, "fps"));
+        if (!fps.empty())
+            return Util::fromString<double>(fps);
+
+        std::string frame_time(field(fields, "frame_time"));
+        if (!frame_time.empty())
+            return 1000.0 / Util::fromString<double>(frame_time);
+
+        return -1.0;
+    }
+
+    unsigned int index;
+    pid_t pid;
+    int fd;
+    int release_fd;
+    std::string cpus;
+    std::string buffer;
+    std::string in_section;
+    Fields info;
+    std::vector<Fields> benchmarks;
+    size_t reported;
+    bool exit_ok;
+};
+
+/**
+ * Gets Jain's fairness index of a set of rates, which is 1 when all are
+ * equal and 1/n when only one of them is non-zero.
+ */
+double
+fairness(const std::vector<double> &rates)
+{
+    double sum = 0.0;
+    double sum_sq = 0.0;
+
+    for (double rate : rates) {
+        sum += rate;
+        sum_sq += rate * rate;
+    }
+
+    if (sum_sq == 0.0)
+        return 0.0;
+
+    return sum * sum / (rates.size() * sum_sq);
+}
+
+/**
+ * Splits the CPUs the process may run on into a set for each worker.
+ *
+ * If there are fewer CPUs than workers, the workers share them.
+ */
+std::vector<std::vector<int> >
+worker_cpu_sets(unsigned int jobs)
+{
+    std::vector<std::vector<int> > sets(jobs);
+    std::vector<int> cpus(ProcessTuning::allowed_cpus());
+
+    if (cpus.empty())
+        return sets;
+
+    for (unsigned int i = 0; i < jobs; i++) {
+        if (cpus.size() < jobs) {
+            sets[i].push_back(cpus[i % cpus.size()]);
+            continue;
+        }
+        for (size_t c = i * cpus.size() / jobs; c < (i + 1) * cpus.size() / jobs; c++)
+            sets[i].push_back(cpus[c]);
+    }
+
+    return sets;
+}
+
+void
+close_fd(int &fd)
+{
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+/**
+ * Kills and reaps the workers that have been started.
+ */
+void
+kill_workers(std::vector<Worker> &workers)
+{
+    for (Worker &worker : workers) {
+        close_fd(worker.fd);
+        close_fd(worker.release_fd);
+        if (worker.pid > 0)
+            kill(worker.pid, SIGKILL);
+    }
+
+    for (Worker &worker : workers) {
+        if (worker.pid <= 0)
+            continue;
+        while (waitpid(worker.pid, nullptr, 0) < 0 && errno == EINTR)
+            ;
+        worker.pid = -1;
+    }
+}
+
+/**
+ * Releases the workers into their next section once all of the workers
+ * that are still running have reported their current one.
+ *
+ * @param released how many sections the workers have been released from
+ */
+void
+release_workers(std::vector<Worker> &workers, size_t &released)
+{
+    while (true) {
+        bool running = false;
+
+        for (const Worker &worker : workers) {
+            if (worker.fd < 0)
+                continue;
+            if (worker.reported <= released)
+                return;
+            running = true;
+        }
+
+        if (!running)
+            return;
+
+        released++;
+
+        for (Worker &worker : workers) {
+            if (worker.fd < 0)
+                continue;
+            char release = 0;
+            while (write(worker.release_fd, &release, 1) < 0 && errno == EINTR)
+                ;
+        }
+    }
+}
+
+/**
+ * Reads the results of the workers as they arrive, releasing them into
+ * each section together, until all of them have closed their pipes, and
+ * then waits for them to exit.
+ *
+ * @return false if the results could not be read
+ */
+bool
+collect_results(std::vector<Worker> &workers)
+{
+    std::vector<pollfd> fds;
+    for (const Worker &worker : workers)
+        fds.push_back(pollfd{worker.fd, POLLIN, 0});
+
+    size_t open_fds = fds.size();
+    size_t released = 0;
+
+    while (open_fds > 0) {
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            Log::error("Could not wait for the results of the workers\n");
+            kill_workers(workers);
+            return false;
+        }
+
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (fds[i].fd < 0 || !fds[i].revents)
+                continue;
+
+            char buf[4096];
+            ssize_t n = read(fds[i].fd, buf, sizeof(buf));
+            if (n > 0) {
+                workers[i].buffer.append(buf, n);
+                workers[i].parse();
+            }
+            else if (n == 0 || errno != EINTR) {
+                close_fd(workers[i].fd);
+                close_fd(workers[i].release_fd);
+                fds[i].fd = -1;
+                open_fds--;
+            }
+        }
+
+        release_workers(workers, released);
+    }
+
+    for (Worker &worker : workers) {
+        int wstatus = 0;
+        while (waitpid(worker.pid, &wstatus, 0) < 0 && errno == EINTR)
+            ;
+        worker.exit_ok = WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0;
+        worker.pid = -1;
+        if (!worker.exit_ok)
+            Log::error("Worker %u failed\n", worker.index);
+    }
+
+    return true;
+}
+
+std::string
+join_rates(const std::vector<double> &rates)
+{
+    std::string str;
+
+    for (double rate : rates) {
+        if (!str.empty())
+            str += "/";
+        if (rate < 0.0)
+            str += "-";
+        else
+            str += Util::toString(static_cast<unsigned>(ceil(rate)));
+    }
+
+    return str;
+}
+
+void
+report_results(const std::vector<Worker> &workers)
+{
+    static const std::string format_bench(Log::continuation_prefix +
+                                          " FPS: %s Total: %s Fairness: %s\n");
+    static const std::string format_fail(Log::continuation_prefix +
+                                         " FPS: %s Failed\n");
+    ResultsFile &results_file = ResultsFile::get();
+    const Fields &info(workers[0].info);
+    size_t benchmarks = 0;
+
+    for (const Worker &worker : workers)
+        benchmarks = std::max(benchmarks, worker.benchmarks.size());
+
+    Log::info("=======================================================\n");
+    Log::info("    glmark2 %s\n", GLMARK_VERSION);
+    Log::info("=======================================================\n");
+    Log::info("    OpenGL Information\n");
+    Log::info("    GL_VENDOR:      %s\n", field(info, "gl_vendor").c_str());
+    Log::info("    GL_RENDERER:    %s\n", field(info, "gl_renderer").c_str());
+    Log::info("    GL_VERSION:     %s\n", field(info, "gl_version").c_str());
+    Log::info("    Surface Config: %s\n", field(info, "surface_config").c_str());
+    Log::info("    Surface Size:   %s\n", field(info, "surface_size").c_str());
+    Log::info("    Jobs:           %zu\n", workers.size());
+    for (const Worker &worker : workers) {
+        Log::info("    Worker %-2u CPUs: %s\n", worker.index,
+                  worker.cpus.empty() ? "any" : worker.cpus.c_str());
+    }
+    Log::info("=======================================================\n");
+
+    /* The workers ran with the same command line, so use the info of one */
+    results_file.begin();
+    results_file.begin_info();
+    for (const auto &f : info)
+        results_file.add_field(f.first, f.second);
+    results_file.add_field("jobs", Util::toString(workers.size()));
+    results_file.end_info();
+
+    std::vector<double> totals(workers.size(), 0.0);
+    std::vector<unsigned int> runs(workers.size(), 0);
+
+    for (size_t b = 0; b < benchmarks; b++) {
+        std::vector<double> rates;
+        std::string name;
+        bool failed = false;
+        double total = 0.0;
+
+        for (size_t w = 0; w < workers.size(); w++) {
+            double rate = workers[w].fps(b);
+            if (name.empty() && b < workers[w].benchmarks.size())
+                name = field(workers[w].benchmarks[b], "name");
+            if (rate < 0.0) {
+                failed = true;
+            }
+            else {
+                total += rate;
+                totals[w] += rate;
+                runs[w]++;
+            }
+            rates.push_back(rate);
+        }
+
+        Log::info("%s:", name.c_str());
+        results_file.begin_benchmark();
+        results_file.add_field("name", name);
+        results_file.add_field("jobs_fps", join_rates(rates));
+
+        if (failed) {
+            Log::info(format_fail.c_str(), join_rates(rates).c_str());
+            results_file.add_field("status", "Failure");
+        }
+        else {
+            std::string total_fps = Util::toString(static_cast<unsigned>(ceil(total)));
+            std::string fair = Util::toString(fairness(rates), 3);
+
+            Log::info(format_bench.c_str(), join_rates(rates).c_str(),
+                      total_fps.c_str(), fair.c_str());
+            results_file.add_field("fps", total_fps);
+            results_file.add_field("fairness", fair);
+            results_file.add_field("status", "Success");
+        }
+
+        results_file.end_benchmark();
+    }
+
+    /* The score of each worker is computed like the normal score */
+    std::vector<double> scores;
+    unsigned int score = 0;
+    for (size_t w = 0; w < workers.size(); w++) {
+        unsigned int worker_score = runs[w] ? totals[w] / runs[w] : 0;
+        scores.push_back(worker_score);
+        score += worker_score;
+    }
+
+    Log::info("=======================================================\n");
+    Log::info("    Worker Scores: %s Fairness: %s\n", join_rates(scores).c_str(),
+              Util::toString(fairness(scores), 3).c_str());
+    Log::info("                                  glmark2 Score: %u \n", score);
+    Log::info("=======================================================\n");
+
+    results_file.end();
+}
+
+}
+
+bool
+JobLauncher::fork_workers(int &status)
+{
+    const unsigned int jobs = Options::jobs;
+    std::vector<std::vector<int> > cpu_sets(worker_cpu_sets(jobs));
+    std::vector<Worker> workers(jobs);
+
+    /* Don't let the workers inherit any pending output */
+    Log::flush();
+    std::fflush(stdout);
+    std::fflush(stderr);
+
+    for (unsigned int i = 0; i < jobs; i++) {
+        int fds[2];
+        int release_fds[2];
+
+        if (pipe(fds) != 0) {
+            Log::error("Could not create a pipe for worker %u\n", i);
+            kill_workers(workers);
+            status = 1;
+            return false;
+        }
+
+        if (pipe(release_fds) != 0) {
+            Log::error("Could not create a pipe for worker %u\n", i);
+            close(fds[0]);
+            close(fds[1]);
+            kill_workers(workers);
+            status = 1;
+            return false;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            Log::error("Could not start worker %u\n", i);
+            close(fds[0]);
+            close(fds[1]);
+            close(release_fds[0]);
+            close(release_fds[1]);
+            kill_workers(workers);
+            status = 1;
+            return false;
+        }
+
+        if (pid == 0) {
+            for (unsigned int j = 0; j < i; j++) {
+                close(workers[j].fd);
+                close(workers[j].release_fd);
+            }
+            close(fds[0]);
+            close(release_fds[1]);
+
+            if (!cpu_sets[i].empty())
+                ProcessTuning::set_affinity(cpu_sets[i]);
+            /* Memory locks are not inherited */
+            if (Options::mlock)
+                ProcessTuning::lock_memory();
+
+            /* Only the results matter, keep the errors on stderr */
+            int null_fd = open("/dev/null", O_WRONLY);
+            if (null_fd >= 0) {
+                dup2(null_fd, STDOUT_FILENO);
+                close(null_fd);
+            }
+
+            PipeResultsFile::install(fds[1], release_fds[0]);
+            return true;
+        }
+
+        close(fds[1]);
+        close(release_fds[0]);
+        workers[i].index = i;
+        workers[i].pid = pid;
+        workers[i].fd = fds[0];
+        workers[i].release_fd = release_fds[1];
+        workers[i].cpus = ProcessTuning::cpu_list_string(cpu_sets[i]);
+    }
+
+    /* A worker may exit before it is released, so don't die writing to it */
+    signal(SIGPIPE, SIG_IGN);
+
+    if (!collect_results(workers)) {
+        status = 1;
+        return false;
+    }
+
+    report_results(workers);
+
+    status = 0;
+    for (const Worker &worker : workers) {
+        if (!worker.exit_ok)
+            status = 1;
+    }
+
+    return false;
+}
+
+#else
+
+bool
+JobLauncher::fork_workers(int &status)
+{
+    Log::error("--jobs is not supported on this platform\n");
+    status = 1;
+    return false;
+}
+
+#endif
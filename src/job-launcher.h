@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_JOB_LAUNCHER_H_
+#define GLMARK2_JOB_LAUNCHER_H_
+
+/**
+ * Runs the benchmarks in several worker processes at the same time.
+ *
+ * Each worker is pinned to its own share of the CPUs the launcher may run
+ * on, runs all the benchmarks as usual, and sends its results to the
+ * launcher through a pipe instead of printing them. The launcher starts
+ * each benchmark in all the workers together, once all of them have
+ * reported the previous one, and reports the frame rate of each worker,
+ * the total throughput and how fairly it was shared between the workers.
+ */
+class JobLauncher
+{
+public:
+    /**
+     * Forks Options::jobs workers.
+     *
+     * In the workers, this returns true right away, so that they go on to
+     * run the benchmarks. In the launcher, it returns false once all the
+     * workers have exited and their results have been reported.
+     *
+     * @param status the exit status for the launcher
+     *
+     * @return whether the calling process is a worker
+     */
+    static bool fork_workers(int &status);
+};
+
+#endif
@@ -17,6 +17,7 @@
 
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 
 #include "gl-if.h"
 #if GLMARK2_USE_GL
@@ -27,6 +28,9 @@
 namespace
 {
 
+// The number of copies of the data kept by a mapped UniformBuffer
+const unsigned int uniform_buffer_ring_slots = 4;
+
 bool is_ident_char(char c)
 {
     return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
@@ -258,16 +262,18 @@ Program::release()
 
     // Clear out the shader vector so we're ready to reuse it.
     shaders_.clear();
+    feedbackVaryings_.clear();
 
     // Clear out the error string to make sure we don't return anything stale.
     message_.clear();
 
-    // Release all of the symbol map resources.
-    for (std::map<string, Symbol*>::iterator symbolIt = symbols_.begin(); symbolIt != symbols_.end(); symbolIt++)
+    // Release all of the symbol resources.
+    for (std::vector<Symbol*>::iterator symbolIt = symbols_.begin(); symbolIt != symbols_.end(); symbolIt++)
     {
-        delete (*symbolIt).second;
+        delete *symbolIt;
     }
     symbols_.clear();
+    symbolHandles_.clear();
 
     if (handle_)
     {
@@ -331,6 +337,22 @@ Program::build()
         return;
     }
 
+    if (!feedbackVaryings_.empty())
+    {
+        if (!GLExtensions::TransformFeedbackVaryings)
+        {
+            message_ = string("Transform feedback is not supported");
+            return;
+        }
+        std::vector<const GLchar*> names;
+        for (const string& name : feedbackVaryings_)
+        {
+            names.push_back(name.c_str());
+        }
+        GLExtensions::TransformFeedbackVaryings(handle_, names.size(), names.data(),
+                                                GL_INTERLEAVED_ATTRIBS);
+    }
+
     glLinkProgram(handle_);
     GLint param = 1;
     glGetProgramiv(handle_, GL_LINK_STATUS, &param);
@@ -390,7 +412,7 @@ Program::getAttribIndex(const string& name)
 Program::Symbol&
 Program::Symbol::operator=(const mat4& m)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && cache(static_cast<const float*>(m), 16 * sizeof(float)))
     {
         // Our matrix representation is column-major, so transpose is false here.
         glUniformMatrix4fv(location_, 1, GL_FALSE, m);
@@ -401,7 +423,7 @@ Program::Symbol::operator=(const mat4& m)
 Program::Symbol&
 Program::Symbol::operator=(const mat3& m)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && cache(static_cast<const float*>(m), 9 * sizeof(float)))
     {
         // Our matrix representation is column-major, so transpose is false here.
         glUniformMatrix3fv(location_, 1, GL_FALSE, m);
@@ -412,7 +434,7 @@ Program::Symbol::operator=(const mat3& m)
 Program::Symbol&
 Program::Symbol::operator=(const vec2& v)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && cache(static_cast<const float*>(v), 2 * sizeof(float)))
     {
         glUniform2fv(location_, 1, v);
     }
@@ -422,7 +444,7 @@ Program::Symbol::operator=(const vec2& v)
 Program::Symbol&
 Program::Symbol::operator=(const vec3& v)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && cache(static_cast<const float*>(v), 3 * sizeof(float)))
     {
         glUniform3fv(location_, 1, v);
     }
@@ -432,7 +454,7 @@ Program::Symbol::operator=(const vec3& v)
 Program::Symbol&
 Program::Symbol::operator=(const vec4& v)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && cache(static_cast<const float*>(v), 4 * sizeof(float)))
     {
         glUniform4fv(location_, 1, v);
     }
@@ -442,7 +464,7 @@ Program::Symbol::operator=(const vec4& v)
 Program::Symbol&
 Program::Symbol::operator=(const float& f)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && cache(&f, sizeof(f)))
     {
         glUniform1f(location_, f);
     }
@@ -452,18 +474,36 @@ Program::Symbol::operator=(const float& f)
 Program::Symbol&
 Program::Symbol::operator=(const int& i)
 {
-    if (type_ == Uniform)
+    if (type_ == Uniform && cache(&i, sizeof(i)))
     {
         glUniform1i(location_, i);
     }
     return *this;
 }
 
+bool
+Program::Symbol::cache(const void* data, size_t size)
+{
+    if (valueSize_ == size && memcmp(value_, data, size) == 0)
+    {
+        return false;
+    }
+    memcpy(value_, data, size);
+    valueSize_ = size;
+    return true;
+}
+
 Program::Symbol&
 Program::operator[](const std::string& name)
 {
-    std::map<std::string, Symbol*>::iterator mapIt = symbols_.find(name);
-    if (mapIt == symbols_.end())
+    return *symbols_[symbolHandle(name)];
+}
+
+Program::SymbolHandle
+Program::symbolHandle(const std::string& name)
+{
+    std::map<std::string, SymbolHandle>::iterator mapIt = symbolHandles_.find(name);
+    if (mapIt == symbolHandles_.end())
     {
         Program::Symbol::SymbolType type(Program::Symbol::Attribute);
         int location = getAttribIndex(name);
@@ -477,7 +517,219 @@ Program::operator[](const std::string& name)
                 type = Program::Symbol::None;
             }
         }
-        mapIt = symbols_.insert(mapIt, std::make_pair(name, new Symbol(name, location, type)));
+        symbols_.push_back(new Symbol(name, location, type));
+        mapIt = symbolHandles_.insert(mapIt, std::make_pair(name, symbols_.size() - 1));
+    }
+    return (*mapIt).second;
+}
+
+bool
+Program::uniformBlockBinding(const std::string& name, unsigned int binding)
+{
+    if (!GLExtensions::GetUniformBlockIndex || !GLExtensions::UniformBlockBinding)
+    {
+        return false;
+    }
+    GLuint index = GLExtensions::GetUniformBlockIndex(handle_, name.c_str());
+    if (index == GL_INVALID_INDEX)
+    {
+        return false;
+    }
+    GLExtensions::UniformBlockBinding(handle_, index, binding);
+    return true;
+}
+
+bool
+Program::getBinary(unsigned int& format, std::vector<unsigned char>& binary)
+{
+    if (!ready_ || !GLExtensions::GetProgramBinary)
+    {
+        return false;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(handle_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return false;
+    }
+
+    binary.resize(length);
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    GLExtensions::GetProgramBinary(handle_, length, &written, &binaryFormat,
+                                   binary.data());
+    if (written <= 0)
+    {
+        binary.clear();
+        return false;
+    }
+
+    binary.resize(written);
+    format = binaryFormat;
+    return true;
+}
+
+bool
+Program::loadBinary(unsigned int format, const std::vector<unsigned char>& binary)
+{
+    if (!valid_ || ready_ || !GLExtensions::ProgramBinary)
+    {
+        return false;
+    }
+
+    GLExtensions::ProgramBinary(handle_, format, binary.data(), binary.size());
+    GLint param = 0;
+    glGetProgramiv(handle_, GL_LINK_STATUS, &param);
+    if (param == GL_FALSE)
+    {
+        message_ = string("The program binary was rejected");
+        return false;
+    }
+    ready_ = true;
+    return true;
+}
+
+bool
+UniformBuffer::init(const UniformBlockLayout& layout, unsigned int binding,
+                    UpdateMethod method)
+{
+    if (!GLExtensions::BindBufferRange)
+    {
+        return false;
+    }
+    if (method == UpdateMapRing &&
+        (!GLExtensions::MapBufferRange || !GLExtensions::UnmapBuffer))
+    {
+        return false;
+    }
+
+    binding_ = binding;
+    method_ = method;
+    slot_ = 0;
+    data_.assign(layout.size(), 0);
+    dirty_ = true;
+
+    // Ring slots must start at offsets the implementation can bind.
+    unsigned int slots = 1;
+    slotSize_ = data_.size();
+    if (method_ == UpdateMapRing)
+    {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        if (alignment > 0)
+        {
+            slotSize_ = (slotSize_ + alignment - 1) / alignment * alignment;
+        }
+        slots = uniform_buffer_ring_slots;
+    }
+
+    glGenBuffers(1, &handle_);
+    glBindBuffer(GL_UNIFORM_BUFFER, handle_);
+    glBufferData(GL_UNIFORM_BUFFER, slotSize_ * slots, 0, GL_DYNAMIC_DRAW);
+    GLExtensions::BindBufferRange(GL_UNIFORM_BUFFER, binding_, handle_, 0, data_.size());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    return true;
+}
+
+void
+UniformBuffer::release()
+{
+    if (handle_)
+    {
+        glDeleteBuffers(1, &handle_);
+        handle_ = 0;
+    }
+    data_.clear();
+    dirty_ = false;
+}
+
+void
+UniformBuffer::set(size_t offset, const void* data, size_t size)
+{
+    if (memcmp(&data_[offset], data, size) != 0)
+    {
+        memcpy(&data_[offset], data, size);
+        dirty_ = true;
+    }
+}
+
+void
+UniformBuffer::set(size_t offset, const mat4& m)
+{
+    // Our matrix representation is column-major, like std140.
+    set(offset, static_cast<const float*>(m), 16 * sizeof(float));
+}
+
+void
+UniformBuffer::set(size_t offset, const mat3& m)
+{
+    // The columns of a mat3 are each padded to a vec4.
+    const float* f = m;
+    for (unsigned int c = 0; c < 3; c++)
+    {
+        set(offset + 16 * c, f + 3 * c, 3 * sizeof(float));
+    }
+}
+
+void
+UniformBuffer::set(size_t offset, const vec2& v)
+{
+    set(offset, static_cast<const float*>(v), 2 * sizeof(float));
+}
+
+void
+UniformBuffer::set(size_t offset, const vec3& v)
+{
+    set(offset, static_cast<const float*>(v), 3 * sizeof(float));
+}
+
+void
+UniformBuffer::set(size_t offset, const vec4& v)
+{
+    set(offset, static_cast<const float*>(v), 4 * sizeof(float));
+}
+
+void
+UniformBuffer::set(size_t offset, const float& f)
+{
+    set(offset, &f, sizeof(f));
+}
+
+void
+UniformBuffer::set(size_t offset, const int& i)
+{
+    set(offset, &i, sizeof(i));
+}
+
+void
+UniformBuffer::update()
+{
+    if (!dirty_ || !handle_)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, handle_);
+    if (method_ == UpdateMapRing)
+    {
+        slot_ = (slot_ + 1) % uniform_buffer_ring_slots;
+        void* dst = GLExtensions::MapBufferRange(GL_UNIFORM_BUFFER,
+                                                 slot_ * slotSize_, data_.size(),
+                                                 GL_MAP_WRITE_BIT |
+                                                 GL_MAP_INVALIDATE_RANGE_BIT);
+        if (dst)
+        {
+            memcpy(dst, &data_[0], data_.size());
+            GLExtensions::UnmapBuffer(GL_UNIFORM_BUFFER);
+        }
+        GLExtensions::BindBufferRange(GL_UNIFORM_BUFFER, binding_, handle_,
+                                      slot_ * slotSize_, data_.size());
+    }
+    else
+    {
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, data_.size(), &data_[0]);
     }
-    return *(*mapIt).second;
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    dirty_ = false;
 }
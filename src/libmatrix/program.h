@@ -129,10 +129,14 @@ public:
         Symbol(const std::string& name, int location, SymbolType type) :
             type_(type),
             location_(location),
-            name_(name) {}
+            name_(name),
+            valueSize_(0) {}
         int location() const { return location_; }
         // These members cause data to be bound to program variables, so
         // the program must be bound for use for these to be effective.
+        //
+        // The last value loaded into a uniform is cached, and loading the
+        // same value again doesn't result in a GL call.
         Symbol& operator=(const LibMatrix::mat4& m);
         Symbol& operator=(const LibMatrix::mat3& m);
         Symbol& operator=(const LibMatrix::vec2& v);
@@ -142,15 +146,55 @@ public:
         Symbol& operator=(const int& i);
 private:
         Symbol();
+        // Caches a uniform value, returning whether it differs from the
+        // cached one (i.e. whether it needs to be loaded).
+        bool cache(const void* data, size_t size);
         SymbolType type_;
         GLint location_;
         std::string name_;
+        unsigned char value_[16 * sizeof(float)];
+        size_t valueSize_;
     };
     // Get the handle to a named program input (the location in OpenGL
     // vernacular).  Typically used in conjunction with various VertexAttrib
     // interfaces.  Equality operators are used to load uniform data.
     Symbol& operator[](const std::string& name);
 
+    // A handle to a program symbol, which can be used to access the symbol
+    // without looking up its name.  Handles stay valid until the program
+    // is released.
+    typedef unsigned int SymbolHandle;
+
+    // Get the handle to a named program input.  This is best done once,
+    // after the program is built, for symbols that are accessed often
+    // (e.g. uniforms loaded on every draw).
+    SymbolHandle symbolHandle(const std::string& name);
+    Symbol& operator[](SymbolHandle handle) { return *symbols_[handle]; }
+
+    // Bind the named uniform block to a uniform buffer binding point, so
+    // that it sources its data from the UniformBuffer bound there.  Several
+    // programs can share a block (and its data) by binding it to the same
+    // point.  Returns false if the block doesn't exist or uniform buffers
+    // aren't supported.
+    bool uniformBlockBinding(const std::string& name, unsigned int binding);
+
+    // Capture the named vertex shader outputs, interleaved in that order,
+    // in the transform feedback buffer.  This takes effect when the program
+    // is built, so it must be called before build(), and lasts until the
+    // program is released.
+    void feedbackVaryings(const std::vector<std::string>& names) { feedbackVaryings_ = names; }
+    const std::vector<std::string>& feedbackVaryings() const { return feedbackVaryings_; }
+
+    // Get the binary of a built program, in an implementation specific
+    // format.  Returns false if the binary can't be retrieved.
+    bool getBinary(unsigned int& format, std::vector<unsigned char>& binary);
+
+    // Build the program from a binary returned by getBinary(), instead of
+    // from shaders.  Returns false if the binary is rejected (e.g. because
+    // it was produced by a different driver), leaving the program valid
+    // but not ready.
+    bool loadBinary(unsigned int format, const std::vector<unsigned char>& binary);
+
     // If "valid" then the program has successfully been created.
     // If "ready" then the program has successfully been built.
     // If either is false, then additional information can be obtained
@@ -159,15 +203,102 @@ private:
     bool ready() const { return ready_; }
     const std::string& errorMessage() const { return message_; }
 
+    // The GL program object, for interfaces not wrapped by this class
+    // (e.g. uniform blocks).
+    unsigned int handle() const { return handle_; }
+
 private:
     int getAttribIndex(const std::string& name);
     int getUniformLocation(const std::string& name);
     unsigned int handle_;
-    std::map<std::string, Symbol*> symbols_;
+    std::map<std::string, SymbolHandle> symbolHandles_;
+    std::vector<Symbol*> symbols_;
     std::vector<Shader> shaders_;
+    std::vector<std::string> feedbackVaryings_;
     std::string message_;
     bool ready_;
     bool valid_;
 };
 
+// Computes the offsets of the members of a uniform block with the std140
+// layout rules, in the order they are declared in the block.  Each add*()
+// call appends a member and returns its offset in bytes.
+class UniformBlockLayout
+{
+public:
+    UniformBlockLayout() : size_(0) {}
+    size_t addFloat() { return add(4, 4); }
+    size_t addInt() { return add(4, 4); }
+    size_t addVec2() { return add(8, 8); }
+    size_t addVec3() { return add(16, 12); }
+    size_t addVec4() { return add(16, 16); }
+    // Matrices are stored as arrays of vec4 columns.
+    size_t addMat3() { return add(16, 3 * 16); }
+    size_t addMat4() { return add(16, 4 * 16); }
+    // The size of the block, padded to a multiple of the vec4 size.
+    size_t size() const { return (size_ + 15) & ~static_cast<size_t>(15); }
+private:
+    size_t add(size_t alignment, size_t size)
+    {
+        size_t offset = (size_ + alignment - 1) & ~(alignment - 1);
+        size_ = offset + size;
+        return offset;
+    }
+    size_t size_;
+};
+
+// A uniform buffer object holding the data of a std140 uniform block.
+// The data is staged on the client side with set(), and update() loads it
+// into the buffer if it has changed, either with BufferSubData or by
+// mapping the next slot of a small ring of copies (so that a copy possibly
+// still in use by the GPU isn't overwritten).
+class UniformBuffer
+{
+public:
+    enum UpdateMethod
+    {
+        UpdateSubData,
+        UpdateMapRing
+    };
+    UniformBuffer() :
+        handle_(0),
+        binding_(0),
+        method_(UpdateSubData),
+        slotSize_(0),
+        slot_(0),
+        dirty_(false) {}
+    ~UniformBuffer() {}
+
+    // Create the buffer for a block of the given layout and bind it to a
+    // uniform buffer binding point.  Returns false if uniform buffers
+    // aren't supported.
+    bool init(const UniformBlockLayout& layout, unsigned int binding,
+              UpdateMethod method = UpdateSubData);
+    void release();
+
+    // Stage member values at offsets returned by UniformBlockLayout.
+    void set(size_t offset, const LibMatrix::mat4& m);
+    void set(size_t offset, const LibMatrix::mat3& m);
+    void set(size_t offset, const LibMatrix::vec2& v);
+    void set(size_t offset, const LibMatrix::vec3& v);
+    void set(size_t offset, const LibMatrix::vec4& v);
+    void set(size_t offset, const float& f);
+    void set(size_t offset, const int& i);
+
+    // Load the staged data into the buffer, if it has changed since the
+    // last update.
+    void update();
+
+    unsigned int handle() const { return handle_; }
+private:
+    void set(size_t offset, const void* data, size_t size);
+    unsigned int handle_;
+    unsigned int binding_;
+    UpdateMethod method_;
+    size_t slotSize_;
+    unsigned int slot_;
+    bool dirty_;
+    std::vector<unsigned char> data_;
+};
+
 #endif // PROGRAM_H_
@@ -10,6 +10,7 @@
 //     Alexandros Frantzis <alexandros.frantzis@linaro.org>
 //     Jesse Barker <jesse.barker@linaro.org>
 //
+#include <cctype>
 #include <istream>
 #include <memory>
 
@@ -21,6 +22,31 @@
 namespace
 {
 
+bool is_ident_char(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/* Replaces whole-word occurrences of a string */
+void replace_word(std::string &str, const std::string &from, const std::string &to)
+{
+    std::string::size_type pos = 0;
+
+    while ((pos = str.find(from, pos)) != std::string::npos) {
+        std::string::size_type end = pos + from.size();
+
+        if ((pos == 0 || !is_ident_char(str[pos - 1])) &&
+            (end == str.size() || !is_ident_char(str[end])))
+        {
+            str.replace(pos, from.size(), to);
+            pos += to.size();
+        }
+        else {
+            pos = end;
+        }
+    }
+}
+
 bool is_valid_precision_value(ShaderSource::PrecisionValue precision_value)
 {
     switch(precision_value) {
@@ -52,7 +78,7 @@ bool is_valid_shader_type(ShaderSource::ShaderType shader_type)
  * Holds default precision values for all shader types
  * (even the unknown type, which is hardwired to default precision values)
  */
-std::vector<ShaderSource::Precision>
+thread_local std::vector<ShaderSource::Precision>
 ShaderSource::default_precision_(ShaderSource::ShaderTypeUnknown + 1);
 
 /**
@@ -398,6 +424,76 @@ ShaderSource::add_array(const std::string &name, std::vector<float> &array,
     add(decl, decl_function);
 }
 
+/**
+ * Moves uniform declarations into a std140 uniform block.
+ *
+ * The declarations "uniform <member>;" are removed from the source, and a
+ * block containing all the members is added at global scope. Members that
+ * the source doesn't declare are added to the block too, so that all the
+ * shaders sharing a block agree on its layout. Uniform blocks need GLSL
+ * 1.40 or GLSL ES 3.00, see version().
+ *
+ * @param name the name of the block
+ * @param members the member declarations (e.g. "mat4 ModelViewMatrix")
+ */
+void
+ShaderSource::uniform_block(const std::string &name,
+                            const std::vector<std::string> &members)
+{
+    std::stringstream ss;
+    ss << "layout(std140) uniform " << name << " {" << std::endl;
+
+    for (std::vector<std::string>::const_iterator iter = members.begin();
+         iter != members.end();
+         iter++)
+    {
+        replace("uniform " + *iter + ";", "");
+        ss << "    " << *iter << ";" << std::endl;
+    }
+
+    ss << "};" << std::endl;
+
+    add_global(ss.str());
+}
+
+/**
+ * Converts GLSL 1.10/GLSL ES 1.00 constructs to their GLSL 1.40/GLSL ES 3.00
+ * equivalents.
+ *
+ * Attributes and varyings become inputs and outputs, the texture lookup
+ * functions are replaced with texture(), and in fragment shaders
+ * gl_FragColor is replaced with an output variable. This allows the
+ * existing shaders to be used with newer features, together with a
+ * matching version().
+ */
+void
+ShaderSource::modernize()
+{
+    static const std::string frag_color("glmark2_FragColor");
+
+    /* The type may need to be inferred before gl_FragColor is replaced */
+    ShaderType shader_type(type());
+    std::string str(source_.str());
+
+    replace_word(str, "texture2D", "texture");
+    replace_word(str, "textureCube", "texture");
+
+    if (shader_type == ShaderSource::ShaderTypeVertex) {
+        replace_word(str, "attribute", "in");
+        replace_word(str, "varying", "out");
+    }
+    else if (shader_type == ShaderSource::ShaderTypeFragment) {
+        replace_word(str, "varying", "in");
+        replace_word(str, "gl_FragColor", frag_color);
+    }
+
+    source_.clear();
+    source_.str(str);
+
+    if (shader_type == ShaderSource::ShaderTypeFragment)
+        add_global("out vec4 " + frag_color + ";\n");
+}
+
 /**
  * Gets the ShaderType for this ShaderSource.
  *
@@ -517,7 +613,12 @@ ShaderSource::str()
         precision_str.insert(precision_str.size(), "#endif\n");
     }
 
-    return precision_macros_ss.str() + precision_str + source_.str();
+    /* The version directive must come before anything else */
+    std::string version_str;
+    if (!version_.empty())
+        version_str = "#version " + version_ + "\n";
+
+    return version_str + precision_macros_ss.str() + precision_str + source_.str();
 }
 
 /**
@@ -545,6 +646,32 @@ ShaderSource::precision()
     return precision_;
 }
 
+/**
+ * Sets the GLSL version of this shader (e.g. "130" or "300 es").
+ *
+ * The version is emitted as a #version directive at the start of the
+ * shader. An empty version (the default) emits no directive, which means
+ * GLSL 1.10 or GLSL ES 1.00.
+ *
+ * @param version the version to set
+ */
+void
+ShaderSource::version(const std::string& version)
+{
+    version_ = version;
+}
+
+/**
+ * Gets the GLSL version of this shader.
+ *
+ * @return the version, or an empty string if none has been set
+ */
+const std::string&
+ShaderSource::version()
+{
+    return version_;
+}
+
 /**
  * Sets the default precision that will be used for a shaders type.
  *
@@ -58,6 +58,11 @@ public:
                    const std::string &init_function,
                    const std::string &decl_function = "");
 
+    void uniform_block(const std::string &name,
+                       const std::vector<std::string> &members);
+
+    void modernize();
+
     ShaderType type();
     std::string str();
 
@@ -83,6 +88,9 @@ public:
     void precision(const Precision& precision);
     const Precision& precision();
 
+    void version(const std::string& version);
+    const std::string& version();
+
     static void default_precision(const Precision& precision,
                                   ShaderType type = ShaderTypeUnknown);
     static const Precision& default_precision(ShaderType type);
@@ -98,6 +106,8 @@ private:
     Precision precision_;
     bool precision_has_been_set_;
     ShaderType type_;
+    std::string version_;
 
-    static std::vector<Precision> default_precision_;
+    /* Per thread, for scenes that are set up in several threads at once */
+    static thread_local std::vector<Precision> default_precision_;
 };
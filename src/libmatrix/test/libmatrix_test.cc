@@ -19,6 +19,7 @@
 #include "const_vec_test.h"
 #include "shader_source_test.h"
 #include "util_split_test.h"
+#include "uniform_block_layout_test.h"
 
 using std::cerr;
 using std::cout;
@@ -44,8 +45,11 @@ main(int argc, char** argv)
     testVec.push_back(new MatrixTest3x3Transpose());
     testVec.push_back(new MatrixTest4x4Transpose());
     testVec.push_back(new ShaderSourceBasic());
+    testVec.push_back(new ShaderSourceVersion());
+    testVec.push_back(new ShaderSourceUniformBlock());
     testVec.push_back(new UtilSplitTestNormal());
     testVec.push_back(new UtilSplitTestQuoted());
+    testVec.push_back(new UniformBlockLayoutStd140());
 
     for (vector<MatrixTest*>::iterator testIt = testVec.begin();
          testIt != testVec.end();
@@ -10,6 +10,7 @@
 //     Jesse Barker - original implementation.
 //
 #include <string>
+#include <vector>
 #include "libmatrix_test.h"
 #include "shader_source_test.h"
 #include "../shader-source.h"
@@ -47,3 +48,47 @@ ShaderSourceAddConstGlobal::run(const Options& options)
     // Compare the output strings to confirm the results.
     pass_ = (src_shader.str() == result_shader.str());
 }
+
+void
+ShaderSourceVersion::run(const Options& options)
+{
+    static const string vtx_shader_filename("test/basic.vert");
+    static const string version_directive("#version 300 es\n");
+
+    ShaderSource vtx_source(vtx_shader_filename);
+    ShaderSource vtx_source_version(vtx_shader_filename);
+    vtx_source_version.version("300 es");
+
+    // The directive must come first, followed by the unversioned source.
+    pass_ = (vtx_source.str().compare(0, 9, "#version ") != 0 &&
+             vtx_source_version.str() == version_directive + vtx_source.str());
+}
+
+void
+ShaderSourceUniformBlock::run(const Options& options)
+{
+    static const string vtx_shader_filename("test/basic.vert");
+    static const string block("layout(std140) uniform Transform {\n"
+                              "    mat4 modelview;\n"
+                              "    mat4 projection;\n"
+                              "    mat4 normal;\n"
+                              "};\n");
+
+    ShaderSource vtx_source(vtx_shader_filename, ShaderSource::ShaderTypeVertex);
+    std::vector<string> members;
+    members.push_back("mat4 modelview");
+    members.push_back("mat4 projection");
+    members.push_back("mat4 normal");
+    vtx_source.modernize();
+    vtx_source.uniform_block("Transform", members);
+
+    // The block replaces the separate declarations, and the legacy
+    // qualifiers are gone.
+    string str(vtx_source.str());
+    pass_ = (str.find(block) != string::npos &&
+             str.find("uniform mat4") == string::npos &&
+             str.find("in vec3 position;") != string::npos &&
+             str.find("out vec4 color;") != string::npos &&
+             str.find("attribute") == string::npos &&
+             str.find("varying") == string::npos);
+}
@@ -29,4 +29,18 @@ public:
     virtual void run(const Options& options);
 };
 
+class ShaderSourceVersion : public MatrixTest
+{
+public:
+    ShaderSourceVersion() : MatrixTest("ShaderSource::Version") {}
+    virtual void run(const Options& options);
+};
+
+class ShaderSourceUniformBlock : public MatrixTest
+{
+public:
+    ShaderSourceUniformBlock() : MatrixTest("ShaderSource::UniformBlock") {}
+    virtual void run(const Options& options);
+};
+
 #endif // SHADER_SOURCE_TEST_H
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2026 Linaro Limited
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#include <iostream>
+#include "libmatrix_test.h"
+#include "uniform_block_layout_test.h"
+#include "../gl-if.h"
+#include "../program.h"
+
+using std::cout;
+using std::endl;
+
+void
+UniformBlockLayoutStd140::run(const Options& options)
+{
+    // The offsets follow the std140 rules: vec3 and matrix columns are
+    // aligned like vec4, and a float can fill the padding after a vec3.
+    UniformBlockLayout layout;
+    size_t offsets[] = {
+        layout.addFloat(),
+        layout.addVec3(),
+        layout.addFloat(),
+        layout.addVec2(),
+        layout.addMat3(),
+        layout.addInt(),
+        layout.addMat4(),
+        layout.addVec4(),
+    };
+    static const size_t expected[] = {0, 16, 28, 32, 48, 96, 112, 176};
+
+    for (unsigned int i = 0; i < sizeof(expected) / sizeof(*expected); i++)
+    {
+        if (options.beVerbose())
+        {
+            cout << "Member " << i << " offset " << offsets[i]
+                 << " (expected " << expected[i] << ")" << endl;
+        }
+        if (offsets[i] != expected[i])
+        {
+            return;
+        }
+    }
+
+    // The block size is padded to a multiple of the vec4 size.
+    UniformBlockLayout padded;
+    padded.addVec3();
+    padded.addFloat();
+    padded.addFloat();
+
+    pass_ = (layout.size() == 192 && padded.size() == 32);
+}
@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2026 Linaro Limited
+//
+// All rights reserved. This program and the accompanying materials
+// are made available under the terms of the MIT License which accompanies
+// this distribution, and is available at
+// http://www.opensource.org/licenses/mit-license.php
+//
+#ifndef UNIFORM_BLOCK_LAYOUT_TEST_H_
+#define UNIFORM_BLOCK_LAYOUT_TEST_H_
+
+class MatrixTest;
+class Options;
+
+class UniformBlockLayoutStd140 : public MatrixTest
+{
+public:
+    UniformBlockLayoutStd140() : MatrixTest("UniformBlockLayout::std140") {}
+    virtual void run(const Options& options);
+};
+
+#endif // UNIFORM_BLOCK_LAYOUT_TEST_H_
@@ -20,6 +20,7 @@
 #include <windows.h>
 #else
 #include <unistd.h>
+#include <time.h>
 #include <sys/resource.h>
 #endif
 
@@ -360,6 +361,56 @@ Util::get_process_times(double *user_sec, double *system_sec)
 #endif
 }
 
+void
+Util::get_thread_times(double *user_sec, double *system_sec)
+{
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    ULARGE_INTEGER user, kernel;
+
+    GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime);
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    // FILETIME contains the number of 100 nsec intervals.
+    *user_sec = user.QuadPart / 1e7;
+    *system_sec = kernel.QuadPart / 1e7;
+#elif defined(RUSAGE_THREAD)
+    struct rusage usage;
+
+    getrusage(RUSAGE_THREAD, &usage);
+    *user_sec = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+    *system_sec = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+#else
+    *user_sec = get_thread_cpu_time_ns() / 1e9;
+    *system_sec = 0.0;
+#endif
+}
+
+uint64_t
+Util::get_thread_cpu_time_ns()
+{
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    ULARGE_INTEGER user, kernel;
+
+    GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime);
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    // FILETIME contains the number of 100 nsec intervals.
+    return (user.QuadPart + kernel.QuadPart) * 100;
+#else
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
 double
 Util::get_idle_time()
 {
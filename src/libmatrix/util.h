@@ -140,6 +140,17 @@ struct Util {
 
     static unsigned int get_num_processors();
     static void get_process_times(double *user_sec, double *system_sec);
+    /**
+     * get_thread_times() - Gets the user and system CPU time consumed by the
+     * calling thread, in seconds. Where the split isn't available, all of
+     * the time is reported as user time.
+     */
+    static void get_thread_times(double *user_sec, double *system_sec);
+    /**
+     * get_thread_cpu_time_ns() - Returns the CPU time (user and system)
+     * consumed by the calling thread, in nanoseconds
+     */
+    static uint64_t get_thread_cpu_time_ns();
     static double get_idle_time();
 
 #ifdef ANDROID
@@ -24,17 +24,36 @@
 #include "util.h"
 #include "log.h"
 #include "results-file.h"
-
+#include "image-reader.h"
+#include "image-writer.h"
+#include "image-compare.h"
+#include "scene-collection.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
 #include <string>
 #include <sstream>
+#include <thread>
 
 /************
  * MainLoop *
  ************/
 
 MainLoop::MainLoop(Canvas &canvas, const std::vector<Benchmark *> &benchmarks) :
-    canvas_(canvas), benchmarks_(benchmarks)
+    canvas_(canvas), benchmarks_(benchmarks), capture_(0), solo_fps_(0.0),
+    sweep_(0)
 {
+    if (Options::target_fps > 0.0 && !Options::validate)
+        pacer_.reset(new FramePacer(canvas_, Options::target_fps));
+    if (Options::soak_interval > 0.0)
+        soak_.reset(new SoakMonitor());
+
     reset();
 }
 
@@ -44,7 +63,7 @@ MainLoop::reset()
 {
     scene_ = 0;
     scene_setup_status_ = SceneSetupStatusUnknown;
-    score_ = 0;
+    score_ = 0.0;
     benchmarks_run_ = 0;
     bench_iter_ = benchmarks_.begin();
 }
@@ -53,9 +72,9 @@ unsigned int
 MainLoop::score()
 {
     if (benchmarks_run_)
-        return score_ / benchmarks_run_;
+        return static_cast<unsigned int>(score_ / benchmarks_run_);
     else
-        return score_;
+        return 0;
 }
 
 bool
@@ -81,6 +100,8 @@ MainLoop::step()
 
         /* If we have found a valid scene, set it up */
         if (bench_iter_ != benchmarks_.end()) {
+            /* The assets of the scene may still be getting ready */
+            prefetcher_.wait();
             before_scene_setup();
             if (!Options::reuse_context)
                 canvas_.reset();
@@ -94,8 +115,14 @@ MainLoop::step()
             else {
                 scene_setup_status_ = SceneSetupStatusSuccess;
             }
+            if (pacer_)
+                pacer_->start();
             after_scene_setup();
+            if (capture_ && scene_setup_status_ == SceneSetupStatusSuccess)
+                capture_->begin_scene(scene_->name());
             log_scene_info();
+            if (Options::prefetch)
+                prefetch_next_benchmark();
         }
         else {
             /* ... otherwise we are done */
@@ -105,20 +132,43 @@ MainLoop::step()
 
     bool should_quit = canvas_.should_quit();
 
-    if (scene_ ->running() && !should_quit)
+    if (scene_ ->running() && !should_quit) {
+        if (pacer_)
+            pacer_->begin_frame();
         draw();
+        if (pacer_)
+            pacer_->end_frame();
+    }
 
     /*
      * Need to recheck whether the scene is still running, because code
      * in draw() may have changed the state.
      */
     if (!scene_->running() || should_quit) {
+        if (capture_)
+            capture_->end_scene();
         (*bench_iter_)->teardown_scene();
         if (scene_setup_status_ == SceneSetupStatusSuccess) {
             score_ += scene_->average_fps();
             benchmarks_run_++;
         }
+        contexts_fps_.clear();
+        if (Options::contexts > 1 && !Options::validate && !should_quit &&
+            scene_setup_status_ == SceneSetupStatusSuccess)
+        {
+            run_contexts();
+        }
         log_scene_result();
+        if (soak_) {
+            /* An interrupted run would skew the statistics */
+            if (!should_quit) {
+                soak_->add_result(**bench_iter_, scene_->info_string(),
+                                  scene_setup_status_ == SceneSetupStatusSuccess ?
+                                  scene_->average_fps() : -1.0);
+            }
+            if (soak_->summary_due() || should_quit)
+                soak_->log_summary();
+        }
         scene_ = 0;
         next_benchmark();
     }
@@ -134,6 +184,9 @@ MainLoop::draw()
     scene_->draw();
     scene_->update();
 
+    if (capture_)
+        capture_->capture();
+
     canvas_.update();
 }
 
@@ -161,6 +214,19 @@ MainLoop::log_scene_result()
                                         " (User: %s ms, System: %s ms) CpuBusy: %s%%");
     static const std::string format_shader(Log::continuation_prefix +
                                            " ShaderCompTime: %s ms");
+    static const std::string format_shader_cache(Log::continuation_prefix +
+                                                 " ShaderCache: %u hits %u misses (%s ms)");
+    static const std::string format_metric(Log::continuation_prefix +
+                                           " %s: %s %s");
+    static const std::string format_pacing(Log::continuation_prefix +
+                                           " Target: %s FPS Missed: %u (%s%%)"
+                                           " Latency: %s ms (p99: %s ms)"
+                                           " CPU: %s ms GPU: %s ms"
+                                           " Headroom: %s%% (p99: %s%%)");
+    static const std::string format_contexts(Log::continuation_prefix +
+                                             " Contexts: %zu FPS: %s Aggregate: %s Scaling: %s%%");
+    static const std::string format_contexts_fail(Log::continuation_prefix +
+                                                  " Contexts: %zu FPS: %s Failed");
     static const std::string format_unsupported(Log::continuation_prefix +
                                                 " Unsupported\n");
     static const std::string format_fail(Log::continuation_prefix +
@@ -168,9 +234,11 @@ MainLoop::log_scene_result()
     static const std::string format_done(Log::continuation_prefix + " done");
     static const std::string format_newline(Log::continuation_prefix + "\n");
     ResultsFile &results_file = ResultsFile::get();
+    double frame_time_sec = -1.0;
 
     if (scene_setup_status_ == SceneSetupStatusSuccess) {
         Scene::Stats stats = scene_->stats();
+        frame_time_sec = stats.average_frame_time;
 
         if (Options::results & Options::ResultsFps)
         {
@@ -216,9 +284,98 @@ MainLoop::log_scene_result()
 
             Log::info(format_shader.c_str(), shader_time.c_str());
             results_file.add_field("shader_comp_time", shader_time);
+
+            if (!Options::shader_cache.empty())
+            {
+                std::string cache_time =
+                    Util::toString(1000.0 * stats.shader_cache_time, 3);
+
+                Log::info(format_shader_cache.c_str(), stats.shader_cache_hits,
+                          stats.shader_cache_misses, cache_time.c_str());
+                results_file.add_field("shader_cache_hits",
+                                       Util::toString(stats.shader_cache_hits));
+                results_file.add_field("shader_cache_misses",
+                                       Util::toString(stats.shader_cache_misses));
+                results_file.add_field("shader_cache_time", cache_time);
+            }
+        }
+
+        for (auto const& metric : stats.metrics)
+        {
+            Log::info(format_metric.c_str(), metric.name.c_str(),
+                      metric.value.c_str(), metric.unit.c_str());
+            results_file.add_field(metric.field, metric.value);
+        }
+
+        if (pacer_)
+        {
+            FramePacer::Stats pacing = pacer_->stats();
+            std::string target = Util::toString(pacer_->target_fps());
+            std::string missed_percent =
+                Util::toString(pacing.frames ? 100.0 * pacing.missed / pacing.frames : 0.0, 1);
+            std::string latency = Util::toString(1000.0 * pacing.average_latency, 3);
+            std::string latency_p99 = Util::toString(1000.0 * pacing.p99_latency, 3);
+            std::string cpu_time = Util::toString(1000.0 * pacing.average_cpu_time, 3);
+            std::string gpu_time = Util::toString(1000.0 * pacing.average_gpu_time, 3);
+            std::string headroom =
+                Util::toString(static_cast<int>(100.0 * pacing.average_headroom));
+            std::string headroom_p99 =
+                Util::toString(static_cast<int>(100.0 * pacing.p99_headroom));
+
+            Log::info(format_pacing.c_str(), target.c_str(), pacing.missed,
+                      missed_percent.c_str(), latency.c_str(), latency_p99.c_str(),
+                      cpu_time.c_str(), gpu_time.c_str(), headroom.c_str(),
+                      headroom_p99.c_str());
+            results_file.add_field("target_fps", target);
+            results_file.add_field("missed_frames", Util::toString(pacing.missed));
+            results_file.add_field("latency", latency);
+            results_file.add_field("latency_p99", latency_p99);
+            results_file.add_field("cpu_frame_time", cpu_time);
+            results_file.add_field("gpu_frame_time", gpu_time);
+            results_file.add_field("headroom", headroom);
+            results_file.add_field("headroom_p99", headroom_p99);
         }
 
-        if (Options::results == 0)
+        if (!contexts_fps_.empty())
+        {
+            std::string fps;
+            double aggregate = 0.0;
+            bool failed = false;
+
+            for (double context_fps : contexts_fps_) {
+                if (!fps.empty())
+                    fps += "/";
+                if (context_fps < 0.0) {
+                    fps += "-";
+                    failed = true;
+                }
+                else {
+                    fps += Util::toString(static_cast<unsigned>(ceil(context_fps)));
+                    aggregate += context_fps;
+                }
+            }
+
+            results_file.add_field("contexts", Util::toString(contexts_fps_.size()));
+            results_file.add_field("contexts_fps", fps);
+
+            if (failed) {
+                Log::info(format_contexts_fail.c_str(), contexts_fps_.size(), fps.c_str());
+            }
+            else {
+                std::string aggregate_fps =
+                    Util::toString(static_cast<unsigned>(ceil(aggregate)));
+                std::string scaling =
+                    Util::toString(static_cast<int>(100.0 * aggregate /
+                                                    (contexts_fps_.size() * solo_fps_)));
+
+                Log::info(format_contexts.c_str(), contexts_fps_.size(), fps.c_str(),
+                          aggregate_fps.c_str(), scaling.c_str());
+                results_file.add_field("contexts_aggregate_fps", aggregate_fps);
+                results_file.add_field("contexts_scaling", scaling);
+            }
+        }
+
+        if (Options::results == 0 && stats.metrics.empty())
         {
             Log::info(format_done.c_str());
         }
@@ -236,6 +393,70 @@ MainLoop::log_scene_result()
     }
 
     results_file.end_benchmark();
+
+    /* Collect the results of a sweep, and show them together at its end */
+    const Benchmark::Sweep *sweep = (*bench_iter_)->sweep();
+    if (sweep) {
+        if (sweep != sweep_) {
+            sweep_results_.clear();
+            sweep_ = sweep;
+        }
+
+        sweep_results_.push_back(SweepResult{(*bench_iter_)->sweep_values(), frame_time_sec});
+
+        if (sweep_results_.size() == sweep->points) {
+            log_sweep_table(*sweep);
+            sweep_results_.clear();
+            sweep_ = 0;
+        }
+    }
+}
+
+/**
+ * Shows the results of a sweep as a table, with a row for each benchmark
+ * that has the values of the swept options and the results.
+ */
+void
+MainLoop::log_sweep_table(const Benchmark::Sweep &sweep)
+{
+    std::vector<std::vector<std::string> > rows;
+
+    std::vector<std::string> header(sweep.axes);
+    header.push_back("FPS");
+    header.push_back("FrameTime(ms)");
+    rows.push_back(header);
+
+    for (const auto &result : sweep_results_) {
+        std::vector<std::string> row(result.values);
+        if (result.frame_time < 0.0) {
+            row.push_back("-");
+            row.push_back("-");
+        }
+        else {
+            row.push_back(Util::toString(static_cast<unsigned>(ceil(1.0 / result.frame_time))));
+            row.push_back(Util::toString(1000.0 * result.frame_time, 3));
+        }
+        rows.push_back(row);
+    }
+
+    std::vector<size_t> widths(header.size(), 0);
+    for (const auto &row : rows) {
+        for (size_t i = 0; i < row.size(); i++)
+            widths[i] = std::max(widths[i], row[i].size());
+    }
+
+    Log::info("=======================================================\n");
+    Log::info("    Sweep: %s\n", sweep.description.c_str());
+
+    for (const auto &row : rows) {
+        std::string line("   ");
+        for (size_t i = 0; i < row.size(); i++)
+            line += " " + row[i] + std::string(widths[i] - row[i].size() + 1, ' ');
+        line.erase(line.find_last_not_of(' ') + 1);
+        Log::info("%s\n", line.c_str());
+    }
+
+    Log::info("=======================================================\n");
 }
 
 void
@@ -246,6 +467,125 @@ MainLoop::next_benchmark()
         bench_iter_ = benchmarks_.begin();
 }
 
+/**
+ * Starts preparing the assets of the next normal benchmark, while the
+ * current one runs.
+ */
+void
+MainLoop::prefetch_next_benchmark()
+{
+    std::vector<Benchmark *>::const_iterator iter = bench_iter_;
+
+    do {
+        iter++;
+        if (iter == benchmarks_.end() && Options::run_forever)
+            iter = benchmarks_.begin();
+    } while (iter != benchmarks_.end() && (*iter)->scene().name().empty());
+
+    if (iter != benchmarks_.end())
+        prefetcher_.start(**iter);
+}
+
+/**
+ * Runs the current benchmark again in Options::contexts additional
+ * contexts at the same time, each in its own thread, and stores the frame
+ * rate of each one in contexts_fps_, or -1 for the ones that failed.
+ *
+ * The threads first set up their own instance of the scene, and then all
+ * start drawing together for the duration of the benchmark. The frame
+ * rate of the benchmark running alone is kept for computing the scaling.
+ */
+void
+MainLoop::run_contexts()
+{
+    const unsigned int count = Options::contexts;
+    const std::map<std::string, std::string> values((*bench_iter_)->option_values());
+    std::vector<Benchmark::OptionPair> options(values.begin(), values.end());
+    std::string name(scene_->name());
+
+    Scene::Stats stats = scene_->stats();
+    solo_fps_ = 1.0 / stats.average_frame_time;
+    contexts_fps_.assign(count, -1.0);
+
+    /* Run for as long as the benchmark ran alone */
+    double duration = stats.elapsed_time;
+
+    /*
+     * Scene constructors make no GL calls but aren't thread safe, so
+     * create the scenes here and only set them up in the threads.
+     */
+    std::vector<std::unique_ptr<Canvas>> canvases;
+    std::vector<std::unique_ptr<Scene>> scenes;
+    for (unsigned int i = 0; i < count; i++) {
+        std::unique_ptr<Canvas> canvas(canvas_.create_context_canvas(Options::shared_contexts));
+        if (!canvas) {
+            Log::error("Cannot create additional contexts\n");
+            return;
+        }
+        scenes.emplace_back(SceneCollection::create_scene(*canvas, name));
+        canvases.push_back(std::move(canvas));
+    }
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    unsigned int ready = 0;
+    bool start = false;
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 0; i < count; i++) {
+        threads.emplace_back([&, i](std::unique_ptr<Canvas> canvas,
+                                    std::unique_ptr<Scene> scene) {
+            bool ok = canvas->init() && scene;
+            std::unique_ptr<Benchmark> benchmark;
+
+            if (ok) {
+                benchmark.reset(new Benchmark(*scene, options));
+                ok = benchmark->setup_scene().running();
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready++;
+                cond.notify_all();
+                cond.wait(lock, [&] { return start; });
+            }
+
+            if (ok) {
+                unsigned int frames = 0;
+                uint64_t start_us = Util::get_timestamp_us();
+
+                while (!stop) {
+                    canvas->clear();
+                    scene->draw();
+                    scene->update();
+                    canvas->update();
+                    frames++;
+                }
+
+                double elapsed = (Util::get_timestamp_us() - start_us) / 1000000.0;
+                contexts_fps_[i] = frames / elapsed;
+            }
+
+            if (benchmark)
+                benchmark->teardown_scene();
+        }, std::move(canvases[i]), std::move(scenes[i]));
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return ready == count; });
+        start = true;
+        cond.notify_all();
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+    stop = true;
+
+    for (auto &thread : threads)
+        thread.join();
+}
+
 /**********************
  * MainLoopDecoration *
  **********************/
@@ -288,6 +628,9 @@ MainLoopDecoration::draw()
     if (show_title_)
         title_renderer_->render();
 
+    if (capture_)
+        capture_->capture();
+
     canvas_.update();
 }
 
@@ -377,6 +720,9 @@ MainLoopValidation::draw()
 
     scene_->draw();
 
+    if (Options::validation_mode != Options::ValidationModePixel)
+        canvas_.read_pixels(frame_);
+
     canvas_.update();
 
     scene_->running(false);
@@ -385,11 +731,20 @@ MainLoopValidation::draw()
 void
 MainLoopValidation::log_scene_result()
 {
-    static const std::string format(Log::continuation_prefix + " Validation: %s\n");
+    static const std::string format(Log::continuation_prefix + " Validation: %s%s\n");
     ResultsFile &results_file = ResultsFile::get();
     std::string result;
+    std::string details;
+    Scene::ValidationResult validation;
+
+    if (Options::validation_mode == Options::ValidationModePixel)
+        validation = scene_->validate();
+    else
+        validation = validate_golden(details);
+
+    frame_.clear();
 
-    switch(scene_->validate()) {
+    switch(validation) {
         case Scene::ValidationSuccess:
             result = "Success";
             break;
@@ -403,8 +758,134 @@ MainLoopValidation::log_scene_result()
             break;
     }
 
-    Log::info(format.c_str(), result.c_str());
+    if (!details.empty())
+        details = " (" + details + ")";
+
+    Log::info(format.c_str(), result.c_str(), details.c_str());
     results_file.add_field("status", result);
 
     results_file.end_benchmark();
 }
+
+Scene::ValidationResult
+MainLoopValidation::validate_golden(std::string &details)
+{
+    /* The largest per-component difference that is not considered an error */
+    static const unsigned int tolerance = 16;
+    /* The fraction of pixels that may exceed the tolerance */
+    static const double max_bad_fraction = 0.005;
+    static const double min_ssim = 0.98;
+
+    if (frame_.empty())
+        return Scene::ValidationUnknown;
+
+    const unsigned int width = canvas_.width();
+    const unsigned int height = canvas_.height();
+    const std::string name(golden_name());
+#if GLMARK2_USE_GLESv2
+    static const char *api = "glesv2";
+#else
+    static const char *api = "gl";
+#endif
+    /* Precision differs between GL and GLES, so keep separate references */
+    const std::filesystem::path ref_path =
+        std::filesystem::path(Options::data_path) / "golden" / api / (name + ".png");
+
+    if (Options::validation_mode == Options::ValidationModeGoldenUpdate) {
+        std::error_code ec;
+        std::filesystem::create_directories(ref_path.parent_path(), ec);
+        if (!PNGWriter::write(ref_path, width, height, frame_.data(), true, 9))
+            return Scene::ValidationFailure;
+        details = "reference updated";
+        return Scene::ValidationSuccess;
+    }
+
+    if (!std::filesystem::exists(ref_path)) {
+        details = "no reference image";
+        return Scene::ValidationUnknown;
+    }
+
+    PNGReader reader(ref_path);
+    if (reader.error())
+        return Scene::ValidationFailure;
+
+    if (reader.width() != width || reader.height() != height) {
+        std::stringstream ss;
+        ss << "reference is " << reader.width() << "x" << reader.height()
+           << ", frame is " << width << "x" << height;
+        details = ss.str();
+        return Scene::ValidationFailure;
+    }
+
+    /* Convert the reference to the bottom-up RGBA layout of the frame */
+    const size_t stride = static_cast<size_t>(width) * 4;
+    const unsigned int bpp = reader.pixelBytes();
+    std::vector<uint8_t> ref(stride * height);
+    std::vector<uint8_t> row(static_cast<size_t>(width) * bpp);
+
+    for (unsigned int y = 0; y < height && reader.nextRow(row.data()); y++) {
+        uint8_t *dst = &ref[(height - y - 1) * stride];
+        for (unsigned int x = 0; x < width; x++) {
+            memcpy(dst + 4 * x, &row[bpp * x], 3);
+            dst[4 * x + 3] = bpp == 4 ? row[bpp * x + 3] : 0xff;
+        }
+    }
+
+    ImageCompare::Result cmp =
+        ImageCompare::compare(frame_.data(), ref.data(), width, height, tolerance);
+
+    std::string psnr = std::isinf(cmp.psnr) ? "inf" : Util::toString(cmp.psnr, 2);
+    std::string ssim = Util::toString(cmp.ssim, 4);
+
+    std::stringstream ss;
+    ss << "PSNR: " << psnr << " dB SSIM: " << ssim
+       << " BadPixels: " << cmp.bad_pixels;
+
+    ResultsFile &results_file = ResultsFile::get();
+    results_file.add_field("psnr", psnr);
+    results_file.add_field("ssim", ssim);
+    results_file.add_field("bad_pixels", Util::toString(cmp.bad_pixels));
+
+    bool ok = cmp.bad_pixels <= max_bad_fraction * width * height &&
+              cmp.ssim >= min_ssim;
+
+    if (!ok) {
+        std::vector<uint8_t> diff;
+        ImageCompare::diff_image(frame_.data(), ref.data(), width, height,
+                                 tolerance, diff);
+        PNGWriter::write(name + "-actual.png", width, height, frame_.data(), true);
+        PNGWriter::write(name + "-diff.png", width, height, diff.data(), true);
+        ss << ", see " << name << "-diff.png";
+    }
+
+    details = ss.str();
+
+    return ok ? Scene::ValidationSuccess : Scene::ValidationFailure;
+}
+
+/**
+ * Gets the name of the reference image for the current scene, based on
+ * the scene name and any explicitly set options that affect rendering.
+ */
+std::string
+MainLoopValidation::golden_name()
+{
+    std::string name(scene_->name());
+
+    for (auto const& opt : scene_->options()) {
+        if (!opt.second.set || opt.first == "duration" || opt.first == "nframes" ||
+            opt.first == "precision" || opt.first == "min-duration" ||
+            opt.first == "max-duration")
+        {
+            continue;
+        }
+        name += "-" + opt.first + "=" + opt.second.value;
+    }
+
+    for (auto &c : name) {
+        if (!isalnum(static_cast<unsigned char>(c)) && !strchr("-_=.,", c))
+            c = '_';
+    }
+
+    return name;
+}
@@ -22,10 +22,15 @@
 #ifndef GLMARK2_MAIN_LOOP_H_
 #define GLMARK2_MAIN_LOOP_H_
 
+#include "asset-prefetcher.h"
 #include "canvas.h"
 #include "benchmark.h"
 #include "text-renderer.h"
+#include "frame-capture.h"
+#include "frame-pacer.h"
+#include "soak-monitor.h"
 #include "vec.h"
+#include <memory>
 #include <vector>
 
 /**
@@ -51,6 +56,13 @@ public:
      */
     unsigned int score();
 
+    /**
+     * Sets the frame capture to feed the rendered frames to.
+     *
+     * @param capture the frame capture, or nullptr to stop capturing
+     */
+    void capture(FrameCapture *capture) { capture_ = capture; }
+
     /**
      * Perform the next main loop step.
      *
@@ -91,12 +103,30 @@ protected:
         SceneSetupStatusUnsupported
     };
     void next_benchmark();
+    void prefetch_next_benchmark();
+    void run_contexts();
+    void log_sweep_table(const Benchmark::Sweep &sweep);
+
+    /* The result of a benchmark that is part of a sweep */
+    struct SweepResult {
+        std::vector<std::string> values;
+        double frame_time;
+    };
     Canvas &canvas_;
     Scene *scene_;
     const std::vector<Benchmark *> &benchmarks_;
-    unsigned int score_;
+    /* A sum of frame rates, which can outgrow an integer with --run-forever */
+    double score_;
     unsigned int benchmarks_run_;
     SceneSetupStatus scene_setup_status_;
+    FrameCapture *capture_;
+    AssetPrefetcher prefetcher_;
+    std::unique_ptr<FramePacer> pacer_;
+    std::unique_ptr<SoakMonitor> soak_;
+    std::vector<double> contexts_fps_;
+    double solo_fps_;
+    const Benchmark::Sweep *sweep_;
+    std::vector<SweepResult> sweep_results_;
 
     std::vector<Benchmark *>::const_iterator bench_iter_;
 };
@@ -136,6 +166,12 @@ public:
 
     virtual void draw();
     virtual void log_scene_result();
+
+protected:
+    Scene::ValidationResult validate_golden(std::string &details);
+    std::string golden_name();
+
+    std::vector<uint8_t> frame_;
 };
 
 #endif /* GLMARK2_MAIN_LOOP_H_ */
@@ -32,6 +32,9 @@
 #include "benchmark-collection.h"
 #include "scene-collection.h"
 #include "results-file.h"
+#include "frame-capture.h"
+#include "job-launcher.h"
+#include "process-tuning.h"
 
 #include "canvas-generic.h"
 
@@ -114,26 +117,42 @@ list_scenes()
     }
 }
 
-void
+bool
 do_benchmark(Canvas &canvas)
 {
     BenchmarkCollection benchmark_collection;
+    std::unique_ptr<FrameCapture> capture;
     MainLoop *loop;
 
     benchmark_collection.populate_from_options();
-    
+
+    if (!Options::capture.empty()) {
+        capture.reset(new FrameCapture(canvas));
+        if (!capture->init())
+            return false;
+    }
+
     if (benchmark_collection.needs_decoration())
         loop = new MainLoopDecoration(canvas, benchmark_collection.benchmarks());
     else
         loop = new MainLoop(canvas, benchmark_collection.benchmarks());
 
+    loop->capture(capture.get());
+
     while (loop->step());
 
+    if (capture) {
+        capture->finish();
+        Log::debug("Captured %u frames\n", capture->frames_written());
+    }
+
     Log::info("=======================================================\n");
     Log::info("                                  glmark2 Score: %u \n", loop->score());
     Log::info("=======================================================\n");
 
     delete loop;
+
+    return true;
 }
 
 void
@@ -185,6 +204,16 @@ main(int argc, char *argv[])
     if (!Options::parse_args(argc, argv))
         return 1;
 
+    /* This restarts the program, so do it before anything else is set up */
+    if (Options::no_aslr && !ProcessTuning::disable_aslr(argv))
+        return 1;
+
+    /* Keep the messages out of a frame capture stream on stdout */
+    if (Options::capture == "-" && !FrameCapture::reserve_stdout()) {
+        fprintf(stderr, "Could not reserve the standard output for frame capture\n");
+        return 1;
+    }
+
     /* Initialize Log class */
     Log::init(std::filesystem::path(argv[0]).stem().string(), Options::show_debug);
 
@@ -220,6 +249,30 @@ main(int argc, char *argv[])
     }
 #endif
 
+    /*
+     * Set up the scheduling and memory of the process before creating any
+     * threads or workers, so that they inherit the settings.
+     */
+    if (!ProcessTuning::apply())
+        return 1;
+
+    /* With --jobs, this process only launches the workers and reports their results */
+    if (Options::jobs > 1 && !Options::list_scenes) {
+#if GLMARK2_USE_NULL || GLMARK2_USE_GBM
+        if (Options::validate) {
+            Log::error("--jobs cannot be used with --validate\n");
+            return 1;
+        }
+
+        int status = 0;
+        if (!JobLauncher::fork_workers(status))
+            return status;
+#else
+        Log::error("--jobs is only supported on the null and gbm platforms\n");
+        return 1;
+#endif
+    }
+
     // Create the canvas
 #if GLMARK2_USE_EGL
     GLStateEGL gl_state;
@@ -260,6 +313,7 @@ main(int argc, char *argv[])
     results_file.add_field("cmdline", get_full_command_line(argc, argv));
     results_file.add_field("executable", GLMARK2_EXECUTABLE);
     results_file.add_field("version", GLMARK_VERSION);
+    ProcessTuning::add_results_info();
 
     Log::info("=======================================================\n");
     Log::info("    glmark2 %s\n", GLMARK_VERSION);
@@ -271,12 +325,14 @@ main(int argc, char *argv[])
 
     canvas.visible(true);
 
+    bool success = true;
+
     if (Options::validate)
         do_validation(canvas);
     else
-        do_benchmark(canvas);
+        success = do_benchmark(canvas);
 
     results_file.end();
 
-    return 0;
+    return success ? 0 : 1;
 }
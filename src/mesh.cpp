@@ -23,13 +23,16 @@
  */
 #include "mesh.h"
 #include "log.h"
+#include "options.h"
 #include "gl-headers.h"
+#include "gl-state.h"
 
 #include <algorithm>
+#include <cstring>
 
 Mesh::Mesh() :
-    vertex_size_(0), interleave_(false), vbo_update_method_(VBOUpdateMethodMap),
-    vbo_usage_(VBOUsageStatic)
+    vertex_size_(0), vao_(0), interleave_(false), vbo_update_method_(VBOUpdateMethodMap),
+    vbo_usage_(VBOUsageStatic), vbo_slot_(0), vbo_update_bytes_(0)
 {
 }
 
@@ -77,6 +80,9 @@ Mesh::set_attrib_locations(const std::vector<int> &locations)
     if (locations.size() != vertex_format_.size())
         Log::error("Trying to set attribute locations using wrong size\n");
     attrib_locations_ = locations;
+
+    if (!vbos_.empty())
+        select_vao();
 }
 
 
@@ -199,7 +205,21 @@ Mesh::vertices()
 /**
  * Sets the VBO update method.
  *
- * The default value is VBOUpdateMethodMap.
+ * The default value is VBOUpdateMethodMap. The methods are:
+ *
+ * - VBOUpdateMethodMap: maps the whole buffer with glMapBuffer
+ * - VBOUpdateMethodSubData: uploads each range with glBufferSubData
+ * - VBOUpdateMethodMapRange: keeps a ring of copies of the data, and maps
+ *   each range of the next copy with glMapBufferRange, unsynchronized,
+ *   after waiting for the fence of its last use (see ::vbo_fence())
+ * - VBOUpdateMethodOrphan: orphans the buffer with glBufferData and
+ *   uploads all of it again
+ * - VBOUpdateMethodPersistent: keeps a ring of copies of the data in a
+ *   persistently mapped buffer, and writes all of the next copy after
+ *   waiting for the fence of its last use (see ::vbo_fence())
+ *
+ * The methods that use persistent mapping take effect in the next call to
+ * ::build_vbo().
  */
 void
 Mesh::vbo_update_method(Mesh::VBOUpdateMethod method)
@@ -238,6 +258,22 @@ Mesh::interleave(bool interleave)
     interleave_ = interleave;
 }
 
+/**
+ * Sets the fence for the draws that read the VBO data since the last update.
+ *
+ * The VBOUpdateMethodMapRange and VBOUpdateMethodPersistent methods write
+ * the VBOs without synchronization, so before they overwrite data they wait
+ * for the fence of the last draws that read it. Scenes using these methods
+ * should set a fence after drawing the mesh.
+ *
+ * @param fence the fence (e.g. from Canvas::sync())
+ */
+void
+Mesh::vbo_fence(std::unique_ptr<GLStateSync> fence)
+{
+    vbo_fences_[vbo_slot_] = std::move(fence);
+}
+
 /**
  * Resets a Mesh object to its initial, empty state.
  */
@@ -326,14 +362,6 @@ Mesh::build_vbo()
 
     attrib_data_ptr_.clear();
 
-    GLenum buffer_usage;
-    if (vbo_usage_ == Mesh::VBOUsageStream)
-        buffer_usage = GL_STREAM_DRAW;
-    else if (vbo_usage_ == Mesh::VBOUsageDynamic)
-        buffer_usage = GL_DYNAMIC_DRAW;
-    else /* if (vbo_usage_ == Mesh::VBOUsageStatic) */
-        buffer_usage = GL_STATIC_DRAW;
-
     if (!interleave_) {
         /* Create a vbo for each attribute */
         for (std::vector<std::pair<int, int> >::const_iterator ai = vertex_format_.begin();
@@ -341,38 +369,199 @@ Mesh::build_vbo()
              ai++)
         {
             float *data = vertex_arrays_[ai - vertex_format_.begin()];
-            GLuint vbo;
-
-            glGenBuffers(1, &vbo);
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            glBufferData(GL_ARRAY_BUFFER, nvertices * ai->first * sizeof(float),
-                         data, buffer_usage);
 
-            vbos_.push_back(vbo);
+            vbos_.push_back(create_vbo(data, nvertices * ai->first));
             attrib_data_ptr_.push_back(0);
         }
 
         vertex_stride_ = 0;
     }
     else {
-        GLuint vbo;
         /* Create a single vbo to store all attribute data */
-        glGenBuffers(1, &vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-        glBufferData(GL_ARRAY_BUFFER, nvertices * vertex_size_ * sizeof(float),
-                     vertex_arrays_[0], GL_STATIC_DRAW);
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GLuint vbo = create_vbo(vertex_arrays_[0], nvertices * vertex_size_);
+        float *map = vbo_maps_.back();
 
+        vbo_maps_.clear();
         for (size_t i = 0; i < vertex_format_.size(); i++) {
             attrib_data_ptr_.push_back(reinterpret_cast<float *>(sizeof(float) * vertex_format_[i].second));
             vbos_.push_back(vbo);
+            vbo_maps_.push_back(map);
         }
         vertex_stride_ = vertex_size_ * sizeof(float);
     }
 
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
     delete_array();
+
+    delete_vao();
+    if (!attrib_locations_.empty())
+        select_vao();
+}
+
+/**
+ * Creates a VBO and fills it with data.
+ *
+ * For the persistent and map-range update methods, the buffer holds a ring
+ * of copies of the data, and for the persistent method it is kept mapped.
+ *
+ * @param data the data
+ * @param nfloats the size of the data in floats
+ *
+ * @return the VBO
+ */
+GLuint
+Mesh::create_vbo(const float *data, size_t nfloats)
+{
+    GLuint vbo;
+
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    if (vbo_update_method_ == VBOUpdateMethodPersistent) {
+        static const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                                        GL_MAP_COHERENT_BIT;
+        GLsizeiptr size = vbo_ring_size * nfloats * sizeof(float);
+
+        GLExtensions::BufferStorage(GL_ARRAY_BUFFER, size, 0, flags);
+        float *map = reinterpret_cast<float *>(
+                GLExtensions::MapBufferRange(GL_ARRAY_BUFFER, 0, size, flags)
+                );
+        if (map) {
+            for (unsigned int i = 0; i < vbo_ring_size; i++)
+                std::copy(data, data + nfloats, map + i * nfloats);
+        }
+        else {
+            Log::error("Failed to map VBO persistently\n");
+        }
+
+        vbo_maps_.push_back(map);
+        vbo_slot_ = 0;
+    }
+    else if (vbo_update_method_ == VBOUpdateMethodMapRange) {
+        GLsizeiptr size = nfloats * sizeof(float);
+
+        glBufferData(GL_ARRAY_BUFFER, vbo_ring_size * size, 0, vbo_buffer_usage());
+        for (unsigned int i = 0; i < vbo_ring_size; i++)
+            glBufferSubData(GL_ARRAY_BUFFER, i * size, size, data);
+
+        vbo_maps_.push_back(0);
+        vbo_slot_ = 0;
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, nfloats * sizeof(float), data,
+                     vbo_buffer_usage());
+        vbo_maps_.push_back(0);
+    }
+
+    return vbo;
+}
+
+/**
+ * Gets the GL buffer usage for the VBO usage hint.
+ *
+ * @return the GL buffer usage
+ */
+GLenum
+Mesh::vbo_buffer_usage() const
+{
+    if (vbo_usage_ == Mesh::VBOUsageStream)
+        return GL_STREAM_DRAW;
+    else if (vbo_usage_ == Mesh::VBOUsageDynamic)
+        return GL_DYNAMIC_DRAW;
+    else /* if (vbo_usage_ == Mesh::VBOUsageStatic) */
+        return GL_STATIC_DRAW;
+}
+
+/**
+ * Whether vertex array objects can be used to render meshes.
+ *
+ * VAOs are used if the context supports them (GL 3.0 or GLES 3.0) and
+ * they have not been disabled with --no-vao.
+ */
+bool
+Mesh::vao_supported()
+{
+    return Options::vao && GLExtensions::GenVertexArrays &&
+           GLExtensions::version_at_least(3, 0);
+}
+
+/**
+ * Selects the vertex array object to render with, for the current
+ * attribute locations.
+ *
+ * The VAO records the vertex attribute state of the VBOs, so this requires
+ * both the VBOs and the attribute locations, and it's done by whichever of
+ * ::build_vbo() and ::set_attrib_locations() comes last. Since some scenes
+ * render the same mesh with different programs, a VAO is kept for each set
+ * of locations. If VAOs are not supported, the attribute state is instead
+ * set up on every draw.
+ */
+void
+Mesh::select_vao()
+{
+    vao_ = 0;
+
+    if (!vao_supported())
+        return;
+
+    for (size_t i = 0; i < vaos_.size(); i++) {
+        if (vaos_[i].first == attrib_locations_) {
+            vao_ = vaos_[i].second;
+            return;
+        }
+    }
+
+    GLExtensions::GenVertexArrays(1, &vao_);
+    GLExtensions::BindVertexArray(vao_);
+    enable_vbo_attribs();
+    GLExtensions::BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    vaos_.push_back(std::pair<std::vector<int>, GLuint>(attrib_locations_, vao_));
+}
+
+/**
+ * Deletes all vertex array objects.
+ */
+void
+Mesh::delete_vao()
+{
+    for (size_t i = 0; i < vaos_.size(); i++)
+        GLExtensions::DeleteVertexArrays(1, &vaos_[i].second);
+
+    vaos_.clear();
+    vao_ = 0;
+}
+
+/**
+ * Sets up the vertex attributes to read from the VBOs.
+ */
+void
+Mesh::enable_vbo_attribs()
+{
+    for (size_t i = 0; i < vertex_format_.size(); i++) {
+        if (attrib_locations_[i] < 0)
+            continue;
+        glEnableVertexAttribArray(attrib_locations_[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, vbos_[i]);
+        glVertexAttribPointer(attrib_locations_[i], vertex_format_[i].first,
+                              GL_FLOAT, GL_FALSE, vertex_stride_,
+                              attrib_data_ptr_[i]);
+    }
+}
+
+/**
+ * Disables the vertex attributes set up by ::enable_vbo_attribs().
+ */
+void
+Mesh::disable_vbo_attribs()
+{
+    for (size_t i = 0; i < vertex_format_.size(); i++) {
+        if (attrib_locations_[i] < 0)
+            continue;
+        glDisableVertexAttribArray(attrib_locations_[i]);
+    }
 }
 
 /**
@@ -435,8 +624,8 @@ Mesh::update_array(const std::vector<std::pair<size_t, size_t> >& ranges)
 /**
  * Updates ranges of a single VBO.
  *
- * This method use either glMapBuffer or glBufferSubData to perform
- * the update. The used method can be set with ::vbo_update_method().
+ * The method used to perform the update can be set with
+ * ::vbo_update_method().
  *
  * @param ranges the ranges of vertices to update
  * @param n the index of the vbo to update
@@ -448,9 +637,28 @@ Mesh::update_single_vbo(const std::vector<std::pair<size_t, size_t> >& ranges,
 {
     float *src_start(vertex_arrays_[n]);
     float *dest_start(0);
+    size_t total_floats(nfloats * vertices_.size());
+
+    /* These methods write all of the data */
+    if (vbo_update_method_ == VBOUpdateMethodPersistent) {
+        if (vbo_maps_[n]) {
+            std::copy(src_start, src_start + total_floats,
+                      vbo_maps_[n] + vbo_slot_ * total_floats);
+        }
+        vbo_update_bytes_ += total_floats * sizeof(float);
+        return;
+    }
 
     glBindBuffer(GL_ARRAY_BUFFER, vbos_[n]);
 
+    if (vbo_update_method_ == VBOUpdateMethodOrphan) {
+        glBufferData(GL_ARRAY_BUFFER, total_floats * sizeof(float), 0,
+                     vbo_buffer_usage());
+        glBufferSubData(GL_ARRAY_BUFFER, 0, total_floats * sizeof(float), src_start);
+        vbo_update_bytes_ += total_floats * sizeof(float);
+        return;
+    }
+
     if (vbo_update_method_ == VBOUpdateMethodMap) {
         dest_start = reinterpret_cast<float *>(
                 GLExtensions::MapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY)
@@ -473,6 +681,23 @@ Mesh::update_single_vbo(const std::vector<std::pair<size_t, size_t> >& ranges,
             glBufferSubData(GL_ARRAY_BUFFER, nfloats * iter->first * sizeof(float),
                             (src_end - src) * sizeof(float), src);
         }
+        else if (vbo_update_method_ == VBOUpdateMethodMapRange) {
+            size_t offset = vbo_slot_ * total_floats + nfloats * iter->first;
+            float *dest = reinterpret_cast<float *>(
+                    GLExtensions::MapBufferRange(GL_ARRAY_BUFFER,
+                                                 offset * sizeof(float),
+                                                 (src_end - src) * sizeof(float),
+                                                 GL_MAP_WRITE_BIT |
+                                                 GL_MAP_INVALIDATE_RANGE_BIT |
+                                                 GL_MAP_UNSYNCHRONIZED_BIT)
+                    );
+            if (dest) {
+                std::copy(src, src_end, dest);
+                GLExtensions::UnmapBuffer(GL_ARRAY_BUFFER);
+            }
+        }
+
+        vbo_update_bytes_ += (src_end - src) * sizeof(float);
     }
 
     if (vbo_update_method_ == VBOUpdateMethodMap)
@@ -495,18 +720,92 @@ Mesh::update_vbo(const std::vector<std::pair<size_t, size_t> >& ranges)
 
     update_array(ranges);
 
+    /*
+     * Move on to the next copy of the data, waiting only if the draws
+     * that read it are still in flight
+     */
+    std::vector<std::pair<size_t, size_t> > vbo_ranges(ranges);
+
+    if (vbo_update_method_ == VBOUpdateMethodPersistent ||
+        vbo_update_method_ == VBOUpdateMethodMapRange)
+    {
+        vbo_slot_ = (vbo_slot_ + 1) % vbo_ring_size;
+        wait_vbo_fence(vbo_slot_);
+    }
+
+    /*
+     * The map-range method only writes the updated ranges, so the copy
+     * must also catch up with the updates made to the other copies since
+     * it was last written
+     */
+    if (vbo_update_method_ == VBOUpdateMethodMapRange) {
+        for (unsigned int i = 0; i < vbo_ring_size; i++) {
+            if (i != vbo_slot_) {
+                vbo_ranges.insert(vbo_ranges.end(), vbo_slot_ranges_[i].begin(),
+                                  vbo_slot_ranges_[i].end());
+            }
+        }
+        vbo_slot_ranges_[vbo_slot_] = ranges;
+
+        /* Merge the overlapping ranges, so that each vertex is written once */
+        std::sort(vbo_ranges.begin(), vbo_ranges.end());
+        size_t merged = 0;
+        for (size_t i = 1; i < vbo_ranges.size(); i++) {
+            if (vbo_ranges[i].first <= vbo_ranges[merged].second + 1) {
+                vbo_ranges[merged].second = std::max(vbo_ranges[merged].second,
+                                                     vbo_ranges[i].second);
+            }
+            else {
+                vbo_ranges[++merged] = vbo_ranges[i];
+            }
+        }
+        if (!vbo_ranges.empty())
+            vbo_ranges.resize(merged + 1);
+    }
+
     if (!interleave_) {
         for (size_t i = 0; i < vbos_.size(); i++)
-            update_single_vbo(ranges, i, vertex_format_[i].first);
+            update_single_vbo(vbo_ranges, i, vertex_format_[i].first);
     }
     else {
-        update_single_vbo(ranges, 0, vertex_size_);
+        update_single_vbo(vbo_ranges, 0, vertex_size_);
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 
+/**
+ * Waits for the fence of a slot of the VBO data, if there is one.
+ *
+ * @param slot the slot to wait for
+ */
+void
+Mesh::wait_vbo_fence(unsigned int slot)
+{
+    if (vbo_fences_[slot]) {
+        vbo_fences_[slot]->wait();
+        vbo_fences_[slot].reset();
+    }
+}
+
+/**
+ * Gets the first vertex of the current copy of the VBO data.
+ *
+ * @return the index of the first vertex to draw
+ */
+size_t
+Mesh::vbo_first_vertex() const
+{
+    if (vbo_update_method_ == VBOUpdateMethodPersistent ||
+        vbo_update_method_ == VBOUpdateMethodMapRange)
+    {
+        return vbo_slot_ * vertices_.size();
+    }
+
+    return 0;
+}
+
 /**
  * Deletes all resources associated with built vertex arrays.
  */
@@ -526,12 +825,22 @@ Mesh::delete_array()
 void
 Mesh::delete_vbo()
 {
+    delete_vao();
+
+    /* Wait for pending draws, since the buffers may be mapped */
+    for (unsigned int i = 0; i < vbo_ring_size; i++)
+        wait_vbo_fence(i);
+
     for (size_t i = 0; i < vbos_.size(); i++) {
         GLuint vbo = vbos_[i];
         glDeleteBuffers(1, &vbo);
     }
 
     vbos_.clear();
+    vbo_maps_.clear();
+    vbo_slot_ = 0;
+    for (unsigned int i = 0; i < vbo_ring_size; i++)
+        vbo_slot_ranges_[i].clear();
 }
 
 
@@ -571,22 +880,90 @@ Mesh::render_array()
 void
 Mesh::render_vbo()
 {
-    for (size_t i = 0; i < vertex_format_.size(); i++) {
-        if (attrib_locations_[i] < 0)
-            continue;
-        glEnableVertexAttribArray(attrib_locations_[i]);
-        glBindBuffer(GL_ARRAY_BUFFER, vbos_[i]);
-        glVertexAttribPointer(attrib_locations_[i], vertex_format_[i].first,
-                              GL_FLOAT, GL_FALSE, vertex_stride_,
-                              attrib_data_ptr_[i]);
+    if (vao_) {
+        GLExtensions::BindVertexArray(vao_);
+        glDrawArrays(GL_TRIANGLES, vbo_first_vertex(), vertices_.size());
+        GLExtensions::BindVertexArray(0);
+        return;
     }
 
-    glDrawArrays(GL_TRIANGLES, 0, vertices_.size());
+    enable_vbo_attribs();
+    glDrawArrays(GL_TRIANGLES, vbo_first_vertex(), vertices_.size());
+    disable_vbo_attribs();
+}
 
-    for (size_t i = 0; i < vertex_format_.size(); i++) {
-        if (attrib_locations_[i] < 0)
-            continue;
-        glDisableVertexAttribArray(attrib_locations_[i]);
+/**
+ * Renders a mesh using vertex buffer objects, in separate draw calls.
+ *
+ * The vertices are drawn in consecutive ranges of @range_size vertices, one
+ * draw call per range. The vertex attribute state is set up only once, so
+ * this is suitable for measuring the cost of the state changes that are
+ * made between the draw calls by @setup_func.
+ *
+ * @param range_size the number of vertices in each range
+ * @param setup_func a function to call before drawing each range (or NULL)
+ * @param data user data to pass to @setup_func
+ */
+void
+Mesh::render_vbo(size_t range_size, range_setup_func setup_func, void *data)
+{
+    if (range_size == 0)
+        return;
+
+    size_t base = vbo_first_vertex();
+
+    if (vao_)
+        GLExtensions::BindVertexArray(vao_);
+    else
+        enable_vbo_attribs();
+
+    for (size_t first = 0, range = 0; first < vertices_.size();
+         first += range_size, range++)
+    {
+        if (setup_func)
+            setup_func(range, data);
+        glDrawArrays(GL_TRIANGLES, base + first,
+                     std::min(range_size, vertices_.size() - first));
+    }
+
+    if (vao_)
+        GLExtensions::BindVertexArray(0);
+    else
+        disable_vbo_attribs();
+}
+
+/**
+ * Remaps the texture coordinates of a range of vertices.
+ *
+ * The first two components (u, v) of the attribute become
+ * offset + (u, v) * scale. This is useful for pointing texture coordinates
+ * to a sub-image of a texture atlas (see TexturePacker).
+ *
+ * The mesh must be rebuilt (or its vertex arrays/buffers updated) for the
+ * changes to take effect.
+ *
+ * @param pos the position of the texture coordinate attribute
+ * @param offset the offset to add to the scaled coordinates
+ * @param scale the scale to apply to the coordinates
+ * @param first the first vertex to remap
+ * @param count the number of vertices to remap
+ */
+void
+Mesh::remap_texcoords(unsigned int pos, const LibMatrix::vec2 &offset,
+                      const LibMatrix::vec2 &scale, size_t first, size_t count)
+{
+    if (pos >= vertex_format_.size() || vertex_format_[pos].first < 2) {
+        Log::error("Trying to remap texture coordinates of invalid attribute\n");
+        return;
+    }
+
+    int offset_in_vertex = vertex_format_[pos].second;
+    size_t end = std::min(first + count, vertices_.size());
+
+    for (size_t i = first; i < end; i++) {
+        float *tc = &vertices_[i][offset_in_vertex];
+        tc[0] = offset.x() + tc[0] * scale.x();
+        tc[1] = offset.y() + tc[1] * scale.y();
     }
 }
 
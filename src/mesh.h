@@ -25,11 +25,15 @@
 #ifndef GLMARK2_MESH_H_
 #define GLMARK2_MESH_H_
 
+#include <memory>
 #include <utility>
 #include <vector>
+#include <stdint.h>
 #include "vec.h"
 #include "gl-headers.h"
 
+class GLStateSync;
+
 /**
  * A mesh of vertices.
  */
@@ -51,6 +55,9 @@ public:
     enum VBOUpdateMethod {
         VBOUpdateMethodMap,
         VBOUpdateMethodSubData,
+        VBOUpdateMethodMapRange,
+        VBOUpdateMethodOrphan,
+        VBOUpdateMethodPersistent,
     };
     enum VBOUsage {
         VBOUsageStatic,
@@ -61,6 +68,8 @@ public:
     void vbo_update_method(VBOUpdateMethod method);
     void vbo_usage(VBOUsage usage);
     void interleave(bool interleave);
+    void vbo_fence(std::unique_ptr<GLStateSync> fence);
+    uint64_t vbo_update_bytes() const { return vbo_update_bytes_; }
 
     void reset();
     void build_array();
@@ -73,6 +82,15 @@ public:
     void render_array();
     void render_vbo();
 
+    static bool vao_supported();
+
+    typedef void (*range_setup_func)(size_t range, void *data);
+
+    void render_vbo(size_t range_size, range_setup_func setup_func, void *data);
+
+    void remap_texcoords(unsigned int pos, const LibMatrix::vec2 &offset,
+                         const LibMatrix::vec2 &scale, size_t first, size_t count);
+
     typedef void (*grid_configuration_func)(Mesh &mesh, int x, int y, int n_x, int n_y,
                                             LibMatrix::vec3 &ul,
                                             LibMatrix::vec3 &ll,
@@ -84,11 +102,23 @@ public:
 
 private:
     bool check_attrib(unsigned int pos, int dim);
+    void select_vao();
+    void delete_vao();
+    void enable_vbo_attribs();
+    void disable_vbo_attribs();
     std::vector<float> &ensure_vertex();
     void update_single_array(const std::vector<std::pair<size_t, size_t> >& ranges,
                              size_t n, size_t nfloats, size_t offset);
     void update_single_vbo(const std::vector<std::pair<size_t, size_t> >& ranges,
                            size_t n, size_t nfloats);
+    GLuint create_vbo(const float *data, size_t nfloats);
+    GLenum vbo_buffer_usage() const;
+    void wait_vbo_fence(unsigned int slot);
+    size_t vbo_first_vertex() const;
+
+    // The number of copies of the data kept by the persistent and map-range
+    // update methods
+    static const unsigned int vbo_ring_size = 3;
 
     //
     // vertex_format_ is a vector of pairs describing the attribute data.
@@ -108,11 +138,23 @@ private:
 
     std::vector<float *> vertex_arrays_;
     std::vector<GLuint> vbos_;
+    // The VAOs recorded for each set of attribute locations used with the
+    // VBOs, and the one for the current locations (or 0 if not using VAOs)
+    std::vector<std::pair<std::vector<int>, GLuint> > vaos_;
+    GLuint vao_;
     std::vector<float *> attrib_data_ptr_;
     int vertex_stride_;
     bool interleave_;
     VBOUpdateMethod vbo_update_method_;
     VBOUsage vbo_usage_;
+    // The persistently mapped data of each VBO, the copy (slot) of the data
+    // that is current, the fences for the draws reading from each slot and
+    // the ranges last written to each slot by the map-range method
+    std::vector<float *> vbo_maps_;
+    unsigned int vbo_slot_;
+    std::unique_ptr<GLStateSync> vbo_fences_[vbo_ring_size];
+    std::vector<std::pair<size_t, size_t> > vbo_slot_ranges_[vbo_ring_size];
+    uint64_t vbo_update_bytes_;
 };
 
 #endif
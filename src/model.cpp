@@ -33,6 +33,7 @@
 #include <fstream>
 #include <sstream>
 #include <memory>
+#include <mutex>
 
 using std::string;
 using std::vector;
@@ -811,6 +812,10 @@ Model::load_obj(const std::filesystem::path &filename)
 namespace ModelPrivate
 {
 ModelMap modelMap;
+
+/* The models loaded ahead of time by Model::prefetch() */
+std::map<std::string, std::shared_ptr<Model>> prefetched;
+std::mutex prefetchedMutex;
 }
 
 /**
@@ -871,6 +876,15 @@ Model::find_models()
 bool
 Model::load(const string& modelName)
 {
+    {
+        std::lock_guard<std::mutex> lock(ModelPrivate::prefetchedMutex);
+        auto iter = ModelPrivate::prefetched.find(modelName);
+        if (iter != ModelPrivate::prefetched.end()) {
+            *this = *iter->second;
+            return true;
+        }
+    }
+
     bool retVal(false);
     ModelMap::const_iterator modelIt = ModelPrivate::modelMap.find(modelName);
     if (modelIt == ModelPrivate::modelMap.end())
@@ -893,3 +907,37 @@ Model::load(const string& modelName)
 
     return retVal;
 }
+
+/**
+ * Loads a model ahead of time, so that a later ::load() only needs to copy
+ * it.
+ *
+ * This doesn't use the GL, so it can be called from any thread, but
+ * Model::find_models() must have been called before.
+ *
+ * @param modelName the model name
+ *
+ * @return whether the operation succeeded
+ */
+bool
+Model::prefetch(const string& modelName)
+{
+    std::shared_ptr<Model> model(new Model());
+    if (!model->load(modelName))
+        return false;
+
+    std::lock_guard<std::mutex> lock(ModelPrivate::prefetchedMutex);
+    ModelPrivate::prefetched[modelName] = model;
+
+    return true;
+}
+
+/**
+ * Drops the models loaded by ::prefetch().
+ */
+void
+Model::clear_prefetched()
+{
+    std::lock_guard<std::mutex> lock(ModelPrivate::prefetchedMutex);
+    ModelPrivate::prefetched.clear();
+}
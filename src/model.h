@@ -84,6 +84,8 @@ public:
     ~Model() {}
 
     bool load(const std::string& name);
+    static bool prefetch(const std::string& name);
+    static void clear_prefetched();
 
     bool needTexcoords() const { return !gotTexcoords_; }
     bool needNormals() const { return !gotNormals_; }
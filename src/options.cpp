@@ -21,6 +21,7 @@
  *  Jesse Barker <jesse.barker@linaro.org>
  */
 
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 #include <getopt.h>
@@ -31,6 +32,7 @@
 std::vector<std::string> Options::benchmarks;
 std::vector<std::string> Options::benchmark_files;
 bool Options::validate = false;
+Options::ValidationMode Options::validation_mode = Options::ValidationModePixel;
 std::string Options::data_path = std::string(GLMARK_DATA_PATH);
 Options::FrameEnd Options::frame_end = Options::FrameEndDefault;
 Options::SwapMode Options::swap_mode = Options::SwapModeDefault;
@@ -41,6 +43,7 @@ bool Options::show_debug = false;
 bool Options::show_version = false;
 bool Options::show_help = false;
 bool Options::reuse_context = false;
+bool Options::vao = true;
 bool Options::run_forever = false;
 bool Options::annotate = false;
 unsigned int Options::offscreen = 0;
@@ -48,6 +51,23 @@ GLVisualConfig Options::visual_config;
 bool Options::good_config = false;
 Options::Results Options::results = Options::ResultsFps;
 std::string Options::results_file;
+std::string Options::shader_cache;
+bool Options::prefetch = false;
+unsigned int Options::contexts = 1;
+bool Options::shared_contexts = false;
+unsigned int Options::jobs = 1;
+std::vector<int> Options::cpu_affinity;
+int Options::sched_fifo = 0;
+bool Options::nice_set = false;
+int Options::nice = 0;
+bool Options::mlock = false;
+bool Options::no_aslr = false;
+double Options::target_fps = 0.0;
+double Options::soak_interval = 0.0;
+unsigned int Options::soak_window = 10;
+std::string Options::capture;
+unsigned int Options::capture_every = 1;
+Options::CaptureFormat Options::capture_format = Options::CaptureFormatDefault;
 std::vector<Options::WindowSystemOption> Options::winsys_options;
 std::string Options::winsys_options_help;
 Options::MacOSGLProfile Options::macos_gl_profile = Options::MacOSGLProfileCore;
@@ -56,7 +76,7 @@ static struct option long_options[] = {
     {"annotate", 0, 0, 0},
     {"benchmark", 1, 0, 0},
     {"benchmark-file", 1, 0, 0},
-    {"validate", 0, 0, 0},
+    {"validate", 2, 0, 0},
     {"data-path", 1, 0, 0},
     {"frame-end", 1, 0, 0},
     {"swap-mode", 1, 0, 0},
@@ -64,11 +84,28 @@ static struct option long_options[] = {
     {"visual-config", 1, 0, 0},
     {"good-config", 0, 0, 0},
     {"reuse-context", 0, 0, 0},
+    {"no-vao", 0, 0, 0},
     {"run-forever", 0, 0, 0},
+    {"soak", 2, 0, 0},
+    {"soak-window", 1, 0, 0},
     {"size", 1, 0, 0},
     {"fullscreen", 0, 0, 0},
     {"results", 1, 0, 0},
     {"results-file", 1, 0, 0},
+    {"shader-cache", 1, 0, 0},
+    {"prefetch", 0, 0, 0},
+    {"contexts", 1, 0, 0},
+    {"shared-contexts", 0, 0, 0},
+    {"jobs", 1, 0, 0},
+    {"cpu-affinity", 1, 0, 0},
+    {"sched-fifo", 2, 0, 0},
+    {"nice", 1, 0, 0},
+    {"mlock", 0, 0, 0},
+    {"no-aslr", 0, 0, 0},
+    {"target-fps", 1, 0, 0},
+    {"capture", 1, 0, 0},
+    {"capture-every", 1, 0, 0},
+    {"capture-format", 1, 0, 0},
     {"winsys-options", 1, 0, 0},
     {"macos-gl-profile", 1, 0, 0},
     {"list-scenes", 0, 0, 0},
@@ -131,12 +168,33 @@ frame_end_from_str(const std::string &str)
         m = Options::FrameEndFinish;
     else if (str == "readpixels")
         m = Options::FrameEndReadPixels;
+    else if (str == "async-readback")
+        m = Options::FrameEndAsyncReadback;
     else if (str == "none")
         m = Options::FrameEndNone;
 
     return m;
 }
 
+/**
+ * Parses a validation mode string
+ *
+ * @param str the string to parse
+ *
+ * @return the parsed validation mode
+ */
+static Options::ValidationMode
+validation_mode_from_str(const std::string &str)
+{
+    if (str == "pixel")
+        return Options::ValidationModePixel;
+    if (str == "golden")
+        return Options::ValidationModeGolden;
+    if (str == "golden-update")
+        return Options::ValidationModeGoldenUpdate;
+    throw std::runtime_error{"Invalid validation mode '" + str + "'"};
+}
+
 /**
  * Parses a swap mode string
  *
@@ -159,6 +217,116 @@ swap_mode_from_str(const std::string &str)
     return m;
 }
 
+/**
+ * Parses a capture format string
+ *
+ * @param str the string to parse
+ *
+ * @return the parsed capture format
+ */
+static Options::CaptureFormat
+capture_format_from_str(const std::string &str)
+{
+    if (str == "png")
+        return Options::CaptureFormatPNG;
+    if (str == "y4m")
+        return Options::CaptureFormatY4M;
+    if (str == "rgba")
+        return Options::CaptureFormatRGBA;
+    throw std::runtime_error{"Invalid capture format '" + str + "'"};
+}
+
+static unsigned int
+count_from_str(std::string const& option, std::string const& str)
+{
+    int ret = 0;
+    try
+    {
+        ret = std::stol(str);
+        if (ret <= 0) throw std::runtime_error{""};
+    }
+    catch (...)
+    {
+        throw std::runtime_error{"Invalid " + option + " option value '" + str + "'"};
+    }
+
+    return ret;
+}
+
+/**
+ * Parses a list of CPUs of the form "0-3,6"
+ */
+static std::vector<int>
+cpu_list_from_str(std::string const& str)
+{
+    std::vector<int> cpus;
+    std::vector<std::string> ranges;
+    Util::split(str, ',', ranges, Util::SplitModeNormal);
+
+    try
+    {
+        for (const auto &range : ranges)
+        {
+            std::vector<std::string> ends;
+            Util::split(range, '-', ends, Util::SplitModeNormal);
+            if (ends.empty() || ends.size() > 2) throw std::runtime_error{""};
+
+            int first = std::stoi(ends[0]);
+            int last = ends.size() > 1 ? std::stoi(ends[1]) : first;
+            if (first < 0 || last < first) throw std::runtime_error{""};
+
+            for (int cpu = first; cpu <= last; cpu++)
+                cpus.push_back(cpu);
+        }
+        if (cpus.empty()) throw std::runtime_error{""};
+    }
+    catch (...)
+    {
+        throw std::runtime_error{"Invalid cpu-affinity option value '" + str + "'"};
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+
+    return cpus;
+}
+
+static double
+positive_from_str(std::string const& option, std::string const& str)
+{
+    double ret = 0.0;
+    try
+    {
+        size_t pos = 0;
+        ret = std::stod(str, &pos);
+        if (pos != str.size() || !(ret > 0.0)) throw std::runtime_error{""};
+    }
+    catch (...)
+    {
+        throw std::runtime_error{"Invalid " + option + " option value '" + str + "'"};
+    }
+
+    return ret;
+}
+
+static int
+int_from_str(std::string const& option, std::string const& str, int min, int max)
+{
+    int ret = 0;
+    try
+    {
+        size_t pos = 0;
+        ret = std::stoi(str, &pos);
+        if (pos != str.size() || ret < min || ret > max) throw std::runtime_error{""};
+    }
+    catch (...)
+    {
+        throw std::runtime_error{"Invalid " + option + " option value '" + str + "'"};
+    }
+
+    return ret;
+}
+
 Options::Results
 results_from_str(std::string const& str)
 {
@@ -231,15 +399,23 @@ Options::print_help()
            "\n"
            "Options:\n"
            "  -b, --benchmark BENCH  A benchmark or options to run: '(scene)?(:opt1=val1)*'\n"
-           "                         (the option can be used multiple times)\n"
+           "                         (the option can be used multiple times); values can\n"
+           "                         be swept with lists '{a,b,c}' or 'range(start,stop,step)'\n"
            "  -f, --benchmark-file F Load benchmarks to run from a file containing a\n"
            "                         list of benchmark descriptions (one per line)\n"
            "                         (the option can be used multiple times)\n"
-           "      --validate         Run a quick output validation test instead of \n"
-           "                         running the benchmarks\n"
+           "      --validate(=MODE)  Run a quick output validation test instead of \n"
+           "                         running the benchmarks. MODE is one of:\n"
+           "                         pixel: check sample pixels (default)\n"
+           "                         golden: compare whole frames with the reference\n"
+           "                           images in the data path, writing images of\n"
+           "                           any differences to the current directory\n"
+           "                         golden-update: save whole frames as the new\n"
+           "                           reference images\n"
            "      --data-path PATH   Path to glmark2 models, shaders and textures\n"
            "                         Default: " GLMARK_DATA_PATH "\n"
-           "      --frame-end METHOD How to end a frame [default,none,swap,finish,readpixels]\n"
+           "      --frame-end METHOD How to end a frame [default,none,swap,finish,readpixels,\n"
+           "                         async-readback]\n"
            "      --swap-mode MODE   How to swap a frame, all modes supported only in the DRM\n"
            "                         flavor, 'fifo' available in all flavors to force vsync\n"
            "                         [default,immediate,mailbox,fifo]\n"
@@ -256,12 +432,44 @@ Options::print_help()
            "                         requirements (see --visual-config)\n"
            "      --reuse-context    Use a single context for all scenes\n"
            "                         (by default, each scene gets its own context)\n"
+           "      --no-vao           Don't use vertex array objects for meshes, set up\n"
+           "                         the vertex attributes on every draw instead\n"
            "  -s, --size WxH         Size of the output window (default: 800x600)\n"
            "      --fullscreen       Run in fullscreen mode (equivalent to --size -1x-1)\n"
            "      --results RESULTS  The types of results to report for each benchmark,\n"
            "                         as a ':' separated list [fps,cpu,shader]\n"
            "      --results-file F   The file to save the results to, in the format determined\n"
            "                         by the file extension [csv,xml]\n"
+           "      --shader-cache DIR Cache the linked shader programs as binaries in DIR,\n"
+           "                         and load them from there instead of compiling\n"
+           "                         them in later runs (if supported by the driver)\n"
+           "      --prefetch         Read the shaders and decode the models and textures\n"
+           "                         of the next benchmark while the current one runs\n"
+           "      --contexts N       After each benchmark, run it again concurrently in N\n"
+           "                         contexts, each rendering off-screen in its own thread,\n"
+           "                         and report the scaling (default: 1, EGL only)\n"
+           "      --shared-contexts  Create the --contexts contexts in a share group\n"
+           "      --jobs N           Run the benchmarks in N worker processes at the same\n"
+           "                         time, each pinned to its share of the CPUs, and report\n"
+           "                         their total throughput (null and gbm platforms only)\n"
+           "      --cpu-affinity L   Run glmark2 and all its threads only on the CPUs in\n"
+           "                         the list L, eg '0-3,6' (Linux only)\n"
+           "      --sched-fifo[=P]   Run with the SCHED_FIFO real-time scheduling policy\n"
+           "                         and priority P (default: 1, Linux only)\n"
+           "      --nice N           Run with the nice level N [-20,19]\n"
+           "      --mlock            Lock all the memory of glmark2 in RAM, to avoid\n"
+           "                         page faults while benchmarking\n"
+           "      --no-aslr          Restart glmark2 with address space layout\n"
+           "                         randomization disabled (Linux only)\n"
+           "      --target-fps N     Pace the frames to N frames per second, and report\n"
+           "                         the missed deadlines, latency and headroom\n"
+           "      --capture DEST     Capture the rendered frames, either as files in the\n"
+           "                         DEST directory or, if DEST is '-', as a video stream\n"
+           "                         on the standard output\n"
+           "      --capture-every N  Capture only every Nth frame of each benchmark\n"
+           "                         (default: 1)\n"
+           "      --capture-format F The format of the captured frames [png,y4m,rgba]\n"
+           "                         (default: png for a directory, y4m for '-')\n"
            "      --winsys-options O A list of 'opt=value' pairs for window system specific\n"
            "                         options, separated by ':'\n"
            "      --macos-gl-profile P OpenGL profile to request in the macos-gl flavor\n"
@@ -272,6 +480,12 @@ Options::print_help()
            "                         (only explicitly set options are shown by default)\n"
            "      --run-forever      Run indefinitely, looping from the last benchmark\n"
            "                         back to the first\n"
+           "      --soak[=S]         Run forever, and every S seconds (default: 60) report\n"
+           "                         the rolling frame rate statistics of each benchmark,\n"
+           "                         any drift of its frame rate, the GL objects left\n"
+           "                         after it and the resident memory of glmark2\n"
+           "      --soak-window N    The number of latest runs of each benchmark in the\n"
+           "                         rolling statistics of --soak (default: 10)\n"
            "      --annotate         Annotate the benchmarks with on-screen information\n"
            "                         (same as -b :show-fps=true:title=#info#)\n"
            "  -d, --debug            Display debug messages\n"
@@ -310,7 +524,17 @@ Options::parse_args(int argc, char **argv)
         else if (c == 'f' || !strcmp(optname, "benchmark-file"))
             Options::benchmark_files.push_back(optarg);
         else if (!strcmp(optname, "validate"))
+        {
             Options::validate = true;
+            try {
+                if (optarg)
+                    Options::validation_mode = validation_mode_from_str(optarg);
+            }
+            catch (const std::exception& e) {
+                fprintf(stderr, "%s\n", e.what());
+                return false;
+            }
+        }
         else if (!strcmp(optname, "data-path"))
             Options::data_path = std::string(optarg);
         else if (!strcmp(optname, "frame-end"))
@@ -325,6 +549,8 @@ Options::parse_args(int argc, char **argv)
             Options::good_config = true;
         else if (!strcmp(optname, "reuse-context"))
             Options::reuse_context = true;
+        else if (!strcmp(optname, "no-vao"))
+            Options::vao = false;
         else if (c == 's' || !strcmp(optname, "size"))
             parse_size(optarg, Options::size);
         else if (!strcmp(optname, "fullscreen"))
@@ -333,6 +559,77 @@ Options::parse_args(int argc, char **argv)
             Options::results = results_from_str(optarg);
         else if (!strcmp(optname, "results-file"))
             Options::results_file = optarg;
+        else if (!strcmp(optname, "shader-cache"))
+            Options::shader_cache = optarg;
+        else if (!strcmp(optname, "prefetch"))
+            Options::prefetch = true;
+        else if (!strcmp(optname, "contexts"))
+        {
+            try {
+                Options::contexts = count_from_str(optname, optarg);
+            }
+            catch (const std::exception& e) {
+                fprintf(stderr, "%s\n", e.what());
+                return false;
+            }
+        }
+        else if (!strcmp(optname, "jobs"))
+        {
+            try {
+                Options::jobs = count_from_str(optname, optarg);
+            }
+            catch (const std::exception& e) {
+                fprintf(stderr, "%s\n", e.what());
+                return false;
+            }
+        }
+        else if (!strcmp(optname, "shared-contexts"))
+            Options::shared_contexts = true;
+        else if (!strcmp(optname, "cpu-affinity") ||
+                 !strcmp(optname, "sched-fifo") ||
+                 !strcmp(optname, "nice") ||
+                 !strcmp(optname, "target-fps"))
+        {
+            try {
+                if (!strcmp(optname, "target-fps")) {
+                    Options::target_fps = positive_from_str(optname, optarg);
+                }
+                else if (!strcmp(optname, "cpu-affinity")) {
+                    Options::cpu_affinity = cpu_list_from_str(optarg);
+                }
+                else if (!strcmp(optname, "sched-fifo")) {
+                    Options::sched_fifo = optarg ? int_from_str(optname, optarg, 1, 99) : 1;
+                }
+                else {
+                    Options::nice = int_from_str(optname, optarg, -20, 19);
+                    Options::nice_set = true;
+                }
+            }
+            catch (const std::exception& e) {
+                fprintf(stderr, "%s\n", e.what());
+                return false;
+            }
+        }
+        else if (!strcmp(optname, "mlock"))
+            Options::mlock = true;
+        else if (!strcmp(optname, "no-aslr"))
+            Options::no_aslr = true;
+        else if (!strcmp(optname, "capture"))
+            Options::capture = optarg;
+        else if (!strcmp(optname, "capture-every") ||
+                 !strcmp(optname, "capture-format"))
+        {
+            try {
+                if (!strcmp(optname, "capture-every"))
+                    Options::capture_every = count_from_str(optname, optarg);
+                else
+                    Options::capture_format = capture_format_from_str(optarg);
+            }
+            catch (const std::exception& e) {
+                fprintf(stderr, "%s\n", e.what());
+                return false;
+            }
+        }
         else if (!strcmp(optname, "winsys-options"))
             Options::winsys_options = winsys_options_from_str(optarg);
         else if (!strcmp(optname, "macos-gl-profile"))
@@ -351,6 +648,22 @@ Options::parse_args(int argc, char **argv)
             Options::show_all_options = true;
         else if (!strcmp(optname, "run-forever"))
             Options::run_forever = true;
+        else if (!strcmp(optname, "soak") || !strcmp(optname, "soak-window"))
+        {
+            try {
+                if (!strcmp(optname, "soak-window")) {
+                    Options::soak_window = count_from_str(optname, optarg);
+                }
+                else {
+                    Options::soak_interval = optarg ? positive_from_str(optname, optarg) : 60.0;
+                    Options::run_forever = true;
+                }
+            }
+            catch (const std::exception& e) {
+                fprintf(stderr, "%s\n", e.what());
+                return false;
+            }
+        }
         else if (c == 'd' || !strcmp(optname, "debug"))
             Options::show_debug = true;
         else if (!strcmp(optname, "version"))
@@ -40,7 +40,21 @@ struct Options {
         FrameEndNone,
         FrameEndSwap,
         FrameEndFinish,
-        FrameEndReadPixels
+        FrameEndReadPixels,
+        FrameEndAsyncReadback
+    };
+
+    enum ValidationMode {
+        ValidationModePixel,
+        ValidationModeGolden,
+        ValidationModeGoldenUpdate,
+    };
+
+    enum CaptureFormat {
+        CaptureFormatDefault,
+        CaptureFormatPNG,
+        CaptureFormatY4M,
+        CaptureFormatRGBA,
     };
 
     enum SwapMode {
@@ -67,6 +81,7 @@ struct Options {
     static std::vector<std::string> benchmarks;
     static std::vector<std::string> benchmark_files;
     static bool validate;
+    static ValidationMode validation_mode;
     static std::string data_path;
     static FrameEnd frame_end;
     static SwapMode swap_mode;
@@ -77,6 +92,7 @@ struct Options {
     static bool show_version;
     static bool show_help;
     static bool reuse_context;
+    static bool vao;
     static bool run_forever;
     static bool annotate;
     static unsigned int offscreen;
@@ -84,6 +100,23 @@ struct Options {
     static bool good_config;
     static Results results;
     static std::string results_file;
+    static std::string shader_cache;
+    static bool prefetch;
+    static unsigned int contexts;
+    static bool shared_contexts;
+    static unsigned int jobs;
+    static std::vector<int> cpu_affinity;
+    static int sched_fifo;
+    static bool nice_set;
+    static int nice;
+    static bool mlock;
+    static bool no_aslr;
+    static double target_fps;
+    static double soak_interval;
+    static unsigned int soak_window;
+    static std::string capture;
+    static unsigned int capture_every;
+    static CaptureFormat capture_format;
     static std::vector<WindowSystemOption> winsys_options;
     static std::string winsys_options_help;
 
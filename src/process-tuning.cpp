@@ -0,0 +1,239 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "process-tuning.h"
+#include "log.h"
+#include "options.h"
+#include "results-file.h"
+#include "util.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#include <sys/personality.h>
+#endif
+
+bool ProcessTuning::memory_locked_ = false;
+
+bool
+ProcessTuning::disable_aslr(char *argv[])
+{
+#ifdef __linux__
+    int persona = personality(0xffffffff);
+
+    if (persona >= 0 && (persona & ADDR_NO_RANDOMIZE))
+        return true;
+
+    if (persona < 0 || personality(persona | ADDR_NO_RANDOMIZE) < 0) {
+        Log::error("Could not disable address space randomization: %s\n",
+                   strerror(errno));
+        return false;
+    }
+
+    /* The new layout only takes effect for a new program image */
+    execv("/proc/self/exe", argv);
+
+    Log::error("Could not restart with address space randomization disabled: %s\n",
+               strerror(errno));
+    return false;
+#else
+    static_cast<void>(argv);
+    Log::error("Disabling address space randomization is not supported on this platform\n");
+    return false;
+#endif
+}
+
+bool
+ProcessTuning::apply()
+{
+    bool ok = true;
+
+    if (!Options::cpu_affinity.empty() && !set_affinity(Options::cpu_affinity))
+        ok = false;
+
+#ifdef __linux__
+    if (Options::sched_fifo > 0) {
+        sched_param param;
+        param.sched_priority = Options::sched_fifo;
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            Log::error("Could not use SCHED_FIFO with priority %d: %s\n",
+                       Options::sched_fifo, strerror(errno));
+            ok = false;
+        }
+    }
+#else
+    if (Options::sched_fifo > 0) {
+        Log::error("SCHED_FIFO is not supported on this platform\n");
+        ok = false;
+    }
+#endif
+
+#ifndef _WIN32
+    if (Options::nice_set && setpriority(PRIO_PROCESS, 0, Options::nice) != 0) {
+        Log::error("Could not set the nice level to %d: %s\n",
+                   Options::nice, strerror(errno));
+        ok = false;
+    }
+#else
+    if (Options::nice_set) {
+        Log::error("Nice levels are not supported on this platform\n");
+        ok = false;
+    }
+#endif
+
+    if (Options::mlock && !lock_memory())
+        ok = false;
+
+    return ok;
+}
+
+bool
+ProcessTuning::lock_memory()
+{
+#ifndef _WIN32
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        Log::error("Could not lock the memory of the process: %s\n", strerror(errno));
+        return false;
+    }
+
+    memory_locked_ = true;
+    return true;
+#else
+    Log::error("Locking memory is not supported on this platform\n");
+    return false;
+#endif
+}
+
+void
+ProcessTuning::add_results_info()
+{
+    ResultsFile &results_file = ResultsFile::get();
+    std::string scheduling("unknown");
+    std::string nice("unknown");
+    std::string aslr("unknown");
+
+#ifdef __linux__
+    int policy = sched_getscheduler(0);
+    if (policy == SCHED_FIFO || policy == SCHED_RR) {
+        sched_param param;
+        sched_getparam(0, &param);
+        scheduling = std::string(policy == SCHED_FIFO ? "fifo:" : "rr:") +
+                     Util::toString(param.sched_priority);
+    }
+    else if (policy >= 0) {
+        scheduling = "other";
+    }
+
+    int persona = personality(0xffffffff);
+    if (persona >= 0)
+        aslr = (persona & ADDR_NO_RANDOMIZE) ? "disabled" : "enabled";
+#endif
+
+#ifndef _WIN32
+    errno = 0;
+    int priority = getpriority(PRIO_PROCESS, 0);
+    if (errno == 0)
+        nice = Util::toString(priority);
+#endif
+
+    std::string cpus(cpu_list_string(allowed_cpus()));
+
+    Log::debug("CPU affinity: %s, scheduling: %s, nice: %s, memory locked: %s, ASLR: %s\n",
+               cpus.empty() ? "unknown" : cpus.c_str(), scheduling.c_str(), nice.c_str(),
+               memory_locked_ ? "yes" : "no", aslr.c_str());
+
+    results_file.add_field("cpu_affinity", cpus);
+    results_file.add_field("scheduling", scheduling);
+    results_file.add_field("nice", nice);
+    results_file.add_field("memory_locked", memory_locked_ ? "true" : "false");
+    results_file.add_field("aslr", aslr);
+}
+
+std::vector<int>
+ProcessTuning::allowed_cpus()
+{
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t allowed;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return cpus;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed))
+            cpus.push_back(cpu);
+    }
+#endif
+    return cpus;
+}
+
+bool
+ProcessTuning::set_affinity(const std::vector<int> &cpus)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            Log::error("Invalid CPU %d\n", cpu);
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        Log::error("Could not set the CPU affinity to %s: %s\n",
+                   cpu_list_string(cpus).c_str(), strerror(errno));
+        return false;
+    }
+
+    return true;
+#else
+    static_cast<void>(cpus);
+    Log::error("Setting the CPU affinity is not supported on this platform\n");
+    return false;
+#endif
+}
+
+std::string
+ProcessTuning::cpu_list_string(const std::vector<int> &cpus)
+{
+    std::string str;
+
+    for (size_t i = 0; i < cpus.size(); i++) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            j++;
+
+        if (!str.empty())
+            str += ",";
+        str += Util::toString(cpus[i]);
+        if (j > i)
+            str += "-" + Util::toString(cpus[j]);
+        i = j;
+    }
+
+    return str;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_PROCESS_TUNING_H_
+#define GLMARK2_PROCESS_TUNING_H_
+
+#include <string>
+#include <vector>
+
+/**
+ * Controls how the process is scheduled and how its memory is handled, to
+ * make the measurements more stable.
+ *
+ * The CPU affinity and scheduling settings apply to the calling thread,
+ * and are inherited by the threads it creates afterwards, so they must be
+ * applied before any other threads are started.
+ */
+class ProcessTuning
+{
+public:
+    /**
+     * Restarts the program with address space layout randomization
+     * disabled, unless it already is.
+     *
+     * @param argv the arguments to restart the program with
+     *
+     * @return true if randomization is disabled, false if it couldn't be
+     *         disabled (on success, the call doesn't return until then)
+     */
+    static bool disable_aslr(char *argv[]);
+
+    /**
+     * Applies the --cpu-affinity, --sched-fifo, --nice and --mlock options.
+     *
+     * @return whether all the requested settings could be applied
+     */
+    static bool apply();
+
+    /**
+     * Locks all the current and future memory of the process.
+     */
+    static bool lock_memory();
+
+    /**
+     * Adds the settings the process runs with to the info section of the
+     * results file.
+     */
+    static void add_results_info();
+
+    /**
+     * Gets the CPUs the calling thread may run on, or an empty list if
+     * this is not known.
+     */
+    static std::vector<int> allowed_cpus();
+
+    /**
+     * Sets the CPUs the calling thread may run on.
+     */
+    static bool set_affinity(const std::vector<int> &cpus);
+
+    /**
+     * Formats a list of CPUs compactly, eg "0-3,6".
+     */
+    static std::string cpu_list_string(const std::vector<int> &cpus);
+
+private:
+    static bool memory_locked_;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "program-cache.h"
+#include "gl-headers.h"
+#include "log.h"
+#include "options.h"
+#include "program.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdint.h>
+
+namespace
+{
+
+/* Identifies the cache files, and the version of their layout */
+const char cache_magic[] = "glmark2 program cache 1\n";
+
+/*
+ * The 64-bit FNV-1a hash, which is enough to name the files, since the
+ * full keys are compared on load.
+ */
+uint64_t
+fnv1a(const std::string &str)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : str) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string
+gl_string(GLenum name)
+{
+    const GLubyte *str = glGetString(name);
+    return str ? reinterpret_cast<const char *>(str) : "";
+}
+
+void
+write_u32(std::ostream &os, uint32_t value)
+{
+    os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+bool
+read_u32(std::istream &is, uint32_t &value)
+{
+    return static_cast<bool>(is.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+}
+
+bool
+ProgramCache::enabled()
+{
+    if (Options::shader_cache.empty() ||
+        !GLExtensions::GetProgramBinary || !GLExtensions::ProgramBinary)
+    {
+        return false;
+    }
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+/**
+ * Gets the key of a program, which identifies everything that affects its
+ * binary: the GL implementation and the program's shaders and varyings.
+ */
+std::string
+ProgramCache::key(const Program &program, const Shaders &shaders)
+{
+    std::stringstream ss;
+
+    ss << gl_string(GL_VENDOR) << '\n'
+       << gl_string(GL_RENDERER) << '\n'
+       << gl_string(GL_VERSION) << '\n';
+
+    for (const auto &shader : shaders)
+        ss << shader.first << ' ' << shader.second.size() << '\n' << shader.second;
+
+    for (const std::string &varying : program.feedbackVaryings())
+        ss << "varying " << varying << '\n';
+
+    return ss.str();
+}
+
+std::string
+ProgramCache::path(const std::string &key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin",
+                  static_cast<unsigned long long>(fnv1a(key)));
+    return (std::filesystem::path(Options::shader_cache) / name).string();
+}
+
+bool
+ProgramCache::load(Program &program, const Shaders &shaders)
+{
+    /* Programs whose binaries can be cached must say so before linking */
+    if (GLExtensions::ProgramParameteri) {
+        GLExtensions::ProgramParameteri(program.handle(),
+                                        GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    std::string program_key(key(program, shaders));
+    std::string file_path(path(program_key));
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::string magic(sizeof(cache_magic) - 1, '\0');
+    std::string file_key;
+    uint32_t key_size = 0;
+    uint32_t format = 0;
+    uint32_t binary_size = 0;
+    std::vector<unsigned char> binary;
+
+    bool ok = file.read(&magic[0], magic.size()) && magic == cache_magic &&
+              read_u32(file, key_size) && key_size == program_key.size();
+    if (ok) {
+        file_key.resize(key_size);
+        ok = file.read(&file_key[0], key_size) && file_key == program_key &&
+             read_u32(file, format) && read_u32(file, binary_size) && binary_size > 0;
+    }
+    if (ok) {
+        binary.resize(binary_size);
+        ok = static_cast<bool>(file.read(reinterpret_cast<char *>(binary.data()),
+                                         binary_size));
+    }
+
+    if (!ok) {
+        Log::debug("Ignoring invalid program cache file %s\n", file_path.c_str());
+        return false;
+    }
+
+    if (!program.loadBinary(format, binary)) {
+        /* Start over with a fresh program, which will replace the stale one */
+        Log::debug("Program binary %s was rejected\n", file_path.c_str());
+        program.release();
+        program.init();
+        if (GLExtensions::ProgramParameteri) {
+            GLExtensions::ProgramParameteri(program.handle(),
+                                            GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        return false;
+    }
+
+    Log::debug("Loaded program binary %s\n", file_path.c_str());
+    return true;
+}
+
+void
+ProgramCache::store(Program &program, const Shaders &shaders)
+{
+    unsigned int format = 0;
+    std::vector<unsigned char> binary;
+    if (!program.getBinary(format, binary))
+        return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(Options::shader_cache, ec);
+
+    std::string program_key(key(program, shaders));
+    std::string file_path(path(program_key));
+
+    /*
+     * Write to a temporary file and then move it into place, so that
+     * concurrent runs never see a partially written file.
+     */
+    std::string tmp_path(file_path + ".tmp" + std::to_string(std::random_device()()));
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(cache_magic, sizeof(cache_magic) - 1);
+        write_u32(file, program_key.size());
+        file.write(program_key.data(), program_key.size());
+        write_u32(file, format);
+        write_u32(file, binary.size());
+        file.write(reinterpret_cast<const char *>(binary.data()), binary.size());
+
+        if (!file) {
+            Log::debug("Cannot write program cache file %s\n", tmp_path.c_str());
+            file.close();
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, file_path, ec);
+    if (ec) {
+        Log::debug("Cannot write program cache file %s\n", file_path.c_str());
+        std::filesystem::remove(tmp_path, ec);
+        return;
+    }
+
+    Log::debug("Stored program binary %s\n", file_path.c_str());
+}
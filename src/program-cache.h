@@ -0,0 +1,76 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_PROGRAM_CACHE_H_
+#define GLMARK2_PROGRAM_CACHE_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class Program;
+
+/**
+ * Caches linked shader programs as program binaries on disk.
+ *
+ * The programs are stored in the directory set with --shader-cache, one
+ * file per program, named after a hash of the program's shader sources
+ * and the GL renderer and version strings. The full sources and strings
+ * are stored with each binary and compared when it is loaded, so a hash
+ * collision or a different driver can only cause a cache miss.
+ */
+class ProgramCache
+{
+public:
+    /** The shaders of a program, as pairs of shader type and source */
+    typedef std::vector<std::pair<unsigned int, std::string> > Shaders;
+
+    /**
+     * Whether the cache is enabled and program binaries are supported by
+     * the current context.
+     */
+    static bool enabled();
+
+    /**
+     * Loads a program from the cache.
+     *
+     * If the program isn't in the cache, or its binary is rejected by the
+     * GL, the program is left ready for adding the shaders and building
+     * it, after which it should be stored with ::store().
+     *
+     * @param program the program to load, which must have been initialized
+     * @param shaders the shaders of the program
+     *
+     * @return whether the program was loaded
+     */
+    static bool load(Program &program, const Shaders &shaders);
+
+    /**
+     * Stores a built program in the cache.
+     *
+     * @param program the program to store
+     * @param shaders the shaders of the program
+     */
+    static void store(Program &program, const Shaders &shaders);
+
+private:
+    static std::string key(const Program &program, const Shaders &shaders);
+    static std::string path(const std::string &key);
+};
+
+#endif
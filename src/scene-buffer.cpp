@@ -294,7 +294,8 @@ private:
 
 struct SceneBufferPrivate {
     WaveMesh *wave;
-    SceneBufferPrivate() : wave(0) {}
+    bool fence;
+    SceneBufferPrivate() : wave(0), fence(false) {}
     ~SceneBufferPrivate() { delete wave; }
 };
 
@@ -307,7 +308,7 @@ SceneBuffer::SceneBuffer(Canvas &pCanvas) :
                                            "false,true");
     options_["update-method"] = Scene::Option("update-method", "map",
                                               "Which method to use to update vertex data",
-                                              "map,subdata");
+                                              "map,subdata,map-range,orphan,persistent");
     options_["update-fraction"] = Scene::Option("update-fraction", "1.0",
                                                 "The fraction of the mesh length that is updated at every iteration (0.0-1.0)");
     options_["update-dispersion"] = Scene::Option("update-dispersion", "0.0",
@@ -329,7 +330,9 @@ SceneBuffer::~SceneBuffer()
 bool
 SceneBuffer::supported(bool show_errors)
 {
-    if (options_["update-method"].value != "subdata" &&
+    const std::string &update_method = options_["update-method"].value;
+
+    if (update_method == "map" &&
         (GLExtensions::MapBuffer == 0 || GLExtensions::UnmapBuffer == 0))
     {
         if (show_errors) {
@@ -339,6 +342,41 @@ SceneBuffer::supported(bool show_errors)
         return false;
     }
 
+    if ((update_method == "map-range" || update_method == "persistent") &&
+        (!GLExtensions::version_at_least(3, 0) ||
+         GLExtensions::MapBufferRange == 0 || GLExtensions::UnmapBuffer == 0))
+    {
+        if (show_errors) {
+            Log::error("Requested MapBufferRange VBO update method but"
+                       " GL 3.0 or GLES 3.0 is not supported!\n");
+        }
+        return false;
+    }
+
+    if (update_method == "persistent" &&
+        (GLExtensions::BufferStorage == 0 ||
+         !(GLExtensions::version_at_least(4, 4) ||
+           GLExtensions::support("GL_ARB_buffer_storage") ||
+           GLExtensions::support("GL_EXT_buffer_storage"))))
+    {
+        if (show_errors) {
+            Log::error("Requested persistent VBO update method but"
+                       " buffer storage is not supported!\n");
+        }
+        return false;
+    }
+
+    /* These methods write without synchronization, and need fences */
+    if ((update_method == "map-range" || update_method == "persistent") &&
+        !canvas_.supports_sync())
+    {
+        if (show_errors) {
+            Log::error("Requested %s VBO update method but sync objects"
+                       " are not supported!\n", update_method.c_str());
+        }
+        return false;
+    }
+
     return true;
 }
 
@@ -359,9 +397,18 @@ SceneBuffer::setup()
         update_method = Mesh::VBOUpdateMethodMap;
     else if (options_["update-method"].value == "subdata")
         update_method = Mesh::VBOUpdateMethodSubData;
+    else if (options_["update-method"].value == "map-range")
+        update_method = Mesh::VBOUpdateMethodMapRange;
+    else if (options_["update-method"].value == "orphan")
+        update_method = Mesh::VBOUpdateMethodOrphan;
+    else if (options_["update-method"].value == "persistent")
+        update_method = Mesh::VBOUpdateMethodPersistent;
     else
         update_method = Mesh::VBOUpdateMethodMap;
 
+    priv_->fence = (update_method == Mesh::VBOUpdateMethodMapRange ||
+                    update_method == Mesh::VBOUpdateMethodPersistent);
+
     if (options_["buffer-usage"].value == "static")
         usage = Mesh::VBOUsageStatic;
     else if (options_["buffer-usage"].value == "stream")
@@ -395,6 +442,14 @@ SceneBuffer::setup()
 void
 SceneBuffer::teardown()
 {
+    double elapsed = realTime_.elapsed();
+
+    if (priv_->wave && elapsed > 0.0) {
+        add_metric("Upload", "upload_rate",
+                   priv_->wave->mesh().vbo_update_bytes() / (1000000.0 * elapsed),
+                   "MB/s", 1);
+    }
+
     delete priv_->wave;
     priv_->wave = 0;
 
@@ -423,6 +478,9 @@ SceneBuffer::draw()
     priv_->wave->program()["ModelViewProjectionMatrix"] = model_view_proj;
 
     priv_->wave->mesh().render_vbo();
+
+    if (priv_->fence)
+        priv_->wave->mesh().vbo_fence(canvas_.sync());
 }
 
 Scene::ValidationResult
@@ -33,17 +33,57 @@
 
 SceneBump::SceneBump(Canvas &pCanvas) :
     Scene(pCanvas, "bump"),
-    texture_(0), rotation_(0.0f), rotationSpeed_(0.0f)
+    texture_(0), rotation_(0.0f), rotationSpeed_(0.0f),
+    useUniformBuffer_(false), modelViewProjectionOffset_(0),
+    normalMatrixOffset_(0)
 {
     options_["bump-render"] = Scene::Option("bump-render", "off",
                                             "How to render bumps",
                                             "off,normals,normals-tangent,height,high-poly");
+    options_["uniform-path"] = Scene::Option("uniform-path", "classic",
+                                             "How to load the per-frame matrices",
+                                             "classic,ubo");
+    options_["ubo-update"] = Scene::Option("ubo-update", "subdata",
+                                           "How to update the uniform buffer (ubo path only)",
+                                           "subdata,map");
 }
 
 SceneBump::~SceneBump()
 {
 }
 
+void
+SceneBump::assets(const std::map<std::string, std::string> &values,
+                   Assets &assets) const
+{
+    const std::string &bump_render = values.at("bump-render");
+
+    assets.models.push_back(bump_render == "high-poly" ? "asteroid-high" : "asteroid-low");
+
+    if (bump_render == "normals")
+        assets.textures.push_back("asteroid-normal-map");
+    else if (bump_render == "normals-tangent")
+        assets.textures.push_back("asteroid-normal-map-tangent");
+    else if (bump_render == "height")
+        assets.textures.push_back("asteroid-height-map");
+}
+
+bool
+SceneBump::supported(bool show_errors)
+{
+    if (options_["uniform-path"].value == "ubo" &&
+        !Scene::uniform_buffers_supported())
+    {
+        if (show_errors) {
+            Log::error("Requested the ubo uniform path but uniform buffers"
+                       " (GL 3.1 or GLES 3.0) are not supported!\n");
+        }
+        return false;
+    }
+
+    return true;
+}
+
 bool
 SceneBump::load()
 {
@@ -57,6 +97,47 @@ SceneBump::unload()
 {
 }
 
+bool
+SceneBump::load_shaders(ShaderSource &vtx_source, ShaderSource &frg_source)
+{
+    // Move the matrices into a uniform block, for the ubo uniform path
+    if (useUniformBuffer_) {
+        std::vector<std::string> members;
+        members.push_back("mat4 ModelViewProjectionMatrix");
+        members.push_back("mat4 NormalMatrix");
+
+        for (ShaderSource *source : {&vtx_source, &frg_source}) {
+            source->version(Scene::glsl_version(140, 300));
+            source->modernize();
+            source->uniform_block("Transform", members);
+        }
+    }
+
+    if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    if (useUniformBuffer_) {
+        UniformBlockLayout layout;
+        modelViewProjectionOffset_ = layout.addMat4();
+        normalMatrixOffset_ = layout.addMat4();
+
+        UniformBuffer::UpdateMethod method =
+            options_["ubo-update"].value == "map" ? UniformBuffer::UpdateMapRing :
+                                                    UniformBuffer::UpdateSubData;
+        if (!transformBuffer_.init(layout, 0, method) ||
+            !program_.uniformBlockBinding("Transform", 0))
+        {
+            Log::error("Failed to set up the uniform buffer\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool
 SceneBump::setup_model_plain(const std::string &type)
 {
@@ -90,18 +171,15 @@ SceneBump::setup_model_plain(const std::string &type)
     model.convert_to_mesh(mesh_, attribs);
 
     /* Load shaders */
-    ShaderSource vtx_source(vtx_shader_filename);
-    ShaderSource frg_source(frg_shader_filename);
+    ShaderSource vtx_source(vtx_shader_filename, ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(frg_shader_filename, ShaderSource::ShaderTypeFragment);
 
     /* Add constants to shaders */
     frg_source.add_const("LightSourcePosition", lightPosition);
     frg_source.add_const("LightSourceHalfVector", halfVector);
 
-    if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
-                                          frg_source.str()))
-    {
+    if (!load_shaders(vtx_source, frg_source))
         return false;
-    }
 
     std::vector<GLint> attrib_locations;
     attrib_locations.push_back(program_["position"].location());
@@ -139,18 +217,15 @@ SceneBump::setup_model_normals()
     model.convert_to_mesh(mesh_, attribs);
 
     /* Load shaders */
-    ShaderSource vtx_source(vtx_shader_filename);
-    ShaderSource frg_source(frg_shader_filename);
+    ShaderSource vtx_source(vtx_shader_filename, ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(frg_shader_filename, ShaderSource::ShaderTypeFragment);
 
     /* Add constants to shaders */
     frg_source.add_const("LightSourcePosition", lightPosition);
     frg_source.add_const("LightSourceHalfVector", halfVector);
 
-    if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
-                                          frg_source.str()))
-    {
+    if (!load_shaders(vtx_source, frg_source))
         return false;
-    }
 
     std::vector<GLint> attrib_locations;
     attrib_locations.push_back(program_["position"].location());
@@ -195,18 +270,15 @@ SceneBump::setup_model_normals_tangent()
     model.convert_to_mesh(mesh_, attribs);
 
     /* Load shaders */
-    ShaderSource vtx_source(vtx_shader_filename);
-    ShaderSource frg_source(frg_shader_filename);
+    ShaderSource vtx_source(vtx_shader_filename, ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(frg_shader_filename, ShaderSource::ShaderTypeFragment);
 
     /* Add constants to shaders */
     frg_source.add_const("LightSourcePosition", lightPosition);
     frg_source.add_const("LightSourceHalfVector", halfVector);
 
-    if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
-                                          frg_source.str()))
-    {
+    if (!load_shaders(vtx_source, frg_source))
         return false;
-    }
 
     std::vector<GLint> attrib_locations;
     attrib_locations.push_back(program_["position"].location());
@@ -253,8 +325,8 @@ SceneBump::setup_model_height()
     model.convert_to_mesh(mesh_, attribs);
 
     /* Load shaders */
-    ShaderSource vtx_source(vtx_shader_filename);
-    ShaderSource frg_source(frg_shader_filename);
+    ShaderSource vtx_source(vtx_shader_filename, ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(frg_shader_filename, ShaderSource::ShaderTypeFragment);
 
     /* Add constants to shaders */
     frg_source.add_const("LightSourcePosition", lightPosition);
@@ -262,11 +334,8 @@ SceneBump::setup_model_height()
     frg_source.add_const("TextureStepX", 1.0 / 1024.0);
     frg_source.add_const("TextureStepY", 1.0 / 1024.0);
 
-    if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
-                                          frg_source.str()))
-    {
+    if (!load_shaders(vtx_source, frg_source))
         return false;
-    }
 
     std::vector<GLint> attrib_locations;
     attrib_locations.push_back(program_["position"].location());
@@ -293,6 +362,8 @@ SceneBump::setup()
 
     bool setup_succeeded = false;
 
+    useUniformBuffer_ = (options_["uniform-path"].value == "ubo");
+
     if (bump_render == "normals")
         setup_succeeded = setup_model_normals();
     else if (bump_render == "normals-tangent")
@@ -313,6 +384,9 @@ SceneBump::setup()
     program_["NormalMap"] = 0;
     program_["HeightMap"] = 0;
 
+    modelViewProjectionHandle_ = program_.symbolHandle("ModelViewProjectionMatrix");
+    normalMatrixHandle_ = program_.symbolHandle("NormalMatrix");
+
     rotation_ = 0.0;
 
     return true;
@@ -323,6 +397,7 @@ SceneBump::teardown()
 {
     mesh_.reset();
 
+    transformBuffer_.release();
     program_.stop();
     program_.release();
 
@@ -343,20 +418,26 @@ SceneBump::draw()
 {
     LibMatrix::Stack4 model_view;
 
-    // Load the ModelViewProjectionMatrix uniform in the shader
+    // Calculate the matrices to load into the shader
     LibMatrix::mat4 model_view_proj(canvas_.projection());
 
     model_view.translate(0.0f, 0.0f, -3.5f);
     model_view.rotate(rotation_, 0.0f, 1.0f, 0.0f);
     model_view_proj *= model_view.getCurrent();
 
-    program_["ModelViewProjectionMatrix"] = model_view_proj;
-
-    // Load the NormalMatrix uniform in the shader. The NormalMatrix is the
-    // inverse transpose of the model view matrix.
+    // The NormalMatrix is the inverse transpose of the model view matrix.
     LibMatrix::mat4 normal_matrix(model_view.getCurrent());
     normal_matrix.inverse().transpose();
-    program_["NormalMatrix"] = normal_matrix;
+
+    if (useUniformBuffer_) {
+        transformBuffer_.set(modelViewProjectionOffset_, model_view_proj);
+        transformBuffer_.set(normalMatrixOffset_, normal_matrix);
+        transformBuffer_.update();
+    }
+    else {
+        program_[modelViewProjectionHandle_] = model_view_proj;
+        program_[normalMatrixHandle_] = normal_matrix;
+    }
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, texture_);
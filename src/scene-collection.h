@@ -23,6 +23,7 @@
 #ifndef GLMARK2_SCENE_COLLECTION_H_
 #define GLMARK2_SCENE_COLLECTION_H_
 
+#include <string>
 #include <vector>
 #include "benchmark.h"
 #include "scene.h"
@@ -48,9 +49,85 @@ public:
     }
     const std::vector<Scene*>& get() { return scenes_; }
 
+    //
+    // Creates only the scene with the given name, e.g. for rendering it in
+    // another thread, without creating (and changing the state of) the
+    // others.
+    //
+    // @param canvas the canvas to create the scene with
+    // @param name the name of the scene
+    //
+    // @return the new scene, or nullptr if there is no such scene
+    //
+    static Scene* create_scene(Canvas& canvas, const std::string& name)
+    {
+        for (const Entry& entry : entries())
+        {
+            if (name == entry.name)
+                return entry.create(canvas);
+        }
+        return nullptr;
+    }
+
 private:
     std::vector<Scene*> scenes_;
 
+    // The name of each scene, which must match the one its constructor
+    // passes to Scene, and how to create it.
+    struct Entry
+    {
+        const char* name;
+        Scene* (*create)(Canvas&);
+    };
+
+    template <typename T>
+    static Scene* create(Canvas& canvas) { return new T(canvas); }
+
+    static const std::vector<Entry>& entries()
+    {
+        static const std::vector<Entry> entries_ = {
+            { "", &create<SceneDefaultOptions> },
+            { "build", &create<SceneBuild> },
+            { "texture", &create<SceneTexture> },
+            { "shading", &create<SceneShading> },
+            { "conditionals", &create<SceneConditionals> },
+            { "function", &create<SceneFunction> },
+            { "loop", &create<SceneLoop> },
+            { "bump", &create<SceneBump> },
+            { "effect2d", &create<SceneEffect2D> },
+            { "pulsar", &create<ScenePulsar> },
+            { "desktop", &create<SceneDesktop> },
+            { "buffer", &create<SceneBuffer> },
+            { "ideas", &create<SceneIdeas> },
+            { "terrain", &create<SceneTerrain> },
+            { "jellyfish", &create<SceneJellyfish> },
+            { "shadow", &create<SceneShadow> },
+            { "refract", &create<SceneRefract> },
+            { "clear", &create<SceneClear> },
+            { "readback", &create<SceneReadback> },
+            { "image-decode", &create<SceneImageDecode> },
+            { "texture-packing", &create<SceneTexturePacking> },
+            { "instancing", &create<SceneInstancing> },
+            { "draw-overhead", &create<SceneDrawOverhead> },
+            { "mrt", &create<SceneMRT> },
+            { "deferred", &create<SceneDeferred> },
+            { "compute-prefix-sum", &create<SceneComputePrefixSum> },
+            { "compute-blur", &create<SceneComputeBlur> },
+            { "compute-nbody", &create<SceneComputeNBody> },
+            { "particles", &create<SceneParticles> },
+            { "shader-compile", &create<SceneShaderCompile> },
+    #if GLMARK2_USE_MACOS
+            { "gl41-instancing", &create<SceneGL41Instancing> },
+            { "gl41-pipeline", &create<SceneGL41Pipeline> },
+            { "gl41-mrt", &create<SceneGL41MRT> },
+            { "gl41-texarray", &create<SceneGL41TexArray> },
+            { "gl41-streaming-sync", &create<SceneGL41StreamingSync> },
+            { "gl41-geometry", &create<SceneGL41Geometry> },
+    #endif
+        };
+        return entries_;
+    }
+
     //
     // Creates all the available scenes and adds them to the supplied vector.
     // 
@@ -59,34 +136,8 @@ private:
     //
     void add_scenes(Canvas& canvas)
     {
-        scenes_.push_back(new SceneDefaultOptions(canvas));
-        scenes_.push_back(new SceneBuild(canvas));
-        scenes_.push_back(new SceneTexture(canvas));
-        scenes_.push_back(new SceneShading(canvas));
-        scenes_.push_back(new SceneConditionals(canvas));
-        scenes_.push_back(new SceneFunction(canvas));
-        scenes_.push_back(new SceneLoop(canvas));
-        scenes_.push_back(new SceneBump(canvas));
-        scenes_.push_back(new SceneEffect2D(canvas));
-        scenes_.push_back(new ScenePulsar(canvas));
-        scenes_.push_back(new SceneDesktop(canvas));
-        scenes_.push_back(new SceneBuffer(canvas));
-        scenes_.push_back(new SceneIdeas(canvas));
-        scenes_.push_back(new SceneTerrain(canvas));
-        scenes_.push_back(new SceneJellyfish(canvas));
-        scenes_.push_back(new SceneShadow(canvas));
-        scenes_.push_back(new SceneRefract(canvas));
-        scenes_.push_back(new SceneClear(canvas));
-
-    #if GLMARK2_USE_MACOS
-        scenes_.push_back(new SceneGL41Instancing(canvas));
-        scenes_.push_back(new SceneGL41Pipeline(canvas));
-        scenes_.push_back(new SceneGL41MRT(canvas));
-        scenes_.push_back(new SceneGL41TexArray(canvas));
-        scenes_.push_back(new SceneGL41StreamingSync(canvas));
-        scenes_.push_back(new SceneGL41Geometry(canvas));
-    #endif
-
+        for (const Entry& entry : entries())
+            scenes_.push_back(entry.create(canvas));
     }
 };
 #endif // GLMARK2_SCENE_COLLECTION_H_
@@ -0,0 +1,348 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+struct SceneComputeBlurPrivate
+{
+    /* The number of pixels each work group filters */
+    static const unsigned int tile_size = 128;
+    static const unsigned int max_radius = 32;
+
+    SceneComputeBlurPrivate() :
+        compute(true), width(0), height(0), vao(0), quad_buffer(0)
+    {
+        for (GLuint &t : textures)
+            t = 0;
+        for (GLuint &f : fbos)
+            f = 0;
+    }
+
+    /**
+     * Gets the weights of a gaussian kernel, as a GLSL list.
+     *
+     * The weights are those RenderWindowBlur (scene-desktop.cpp) uses,
+     * so that the two kinds of blur do the same amount of work.
+     */
+    static std::string kernel(unsigned int radius)
+    {
+        float sigma = std::max(1.0f, radius / 3.0f);
+        float s2 = 2.0f * sigma * sigma;
+        std::stringstream ss;
+
+        for (unsigned int i = 0; i <= radius; i++) {
+            float k = 1.0 / std::sqrt(M_PI * s2) * std::exp(-(static_cast<float>(i) * i) / s2);
+            if (i > 0)
+                ss << ", ";
+            ss << Util::toString(k);
+        }
+
+        return ss.str();
+    }
+
+    enum Texture {
+        TextureSource,
+        TextureIntermediate,
+        TextureResult,
+        TextureCount
+    };
+
+    bool compute;
+    GLsizei width;
+    GLsizei height;
+    Program blur_program;
+    Program blit_program;
+    GLuint textures[TextureCount];
+    /* The framebuffers of the fragment shader blur */
+    GLuint fbos[TextureCount];
+    GLuint vao;
+    GLuint quad_buffer;
+};
+
+SceneComputeBlur::SceneComputeBlur(Canvas &pCanvas) :
+    SceneCompute(pCanvas, "compute-blur")
+{
+    priv_ = new SceneComputeBlurPrivate();
+    options_["method"] = Scene::Option("method", "compute",
+                                       "How to blur: a compute shader caching tiles of the"
+                                       " image in shared memory, or a fragment shader",
+                                       "compute,fragment");
+    options_["radius"] = Scene::Option("radius", "5",
+                                       "The blur radius (in pixels)");
+    options_["size"] = Scene::Option("size", "1024x1024",
+                                     "The size of the image to blur (WxH)");
+}
+
+SceneComputeBlur::~SceneComputeBlur()
+{
+    delete priv_;
+}
+
+bool
+SceneComputeBlur::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    priv_->compute = options_["method"].value == "compute";
+
+    unsigned int radius = Util::fromString<unsigned int>(options_["radius"].value);
+    if (radius > SceneComputeBlurPrivate::max_radius) {
+        Log::error("The blur radius must be at most %u\n",
+                   SceneComputeBlurPrivate::max_radius);
+        return false;
+    }
+
+    std::vector<std::string> size;
+    Util::split(options_["size"].value, 'x', size, Util::SplitModeNormal);
+    priv_->width = size.size() > 0 ? Util::fromString<int>(size[0]) : 0;
+    priv_->height = size.size() > 1 ? Util::fromString<int>(size[1]) : priv_->width;
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    if (priv_->width <= 0 || priv_->height <= 0 ||
+        priv_->width > max_size || priv_->height > max_size)
+    {
+        Log::error("Invalid image size %dx%d (maximum is %dx%d)\n",
+                   priv_->width, priv_->height, max_size, max_size);
+        return false;
+    }
+
+    /* Load the shaders */
+    std::string kernel(SceneComputeBlurPrivate::kernel(radius));
+    std::string version(Scene::glsl_version(430, 310));
+
+    ShaderSource vtx_source(Options::data_path + "/shaders/compute-blit.vert",
+                            ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(Options::data_path + "/shaders/compute-blit.frag",
+                            ShaderSource::ShaderTypeFragment);
+    vtx_source.version(version);
+    frg_source.version(version);
+
+    if (!Scene::load_shaders_from_strings(priv_->blit_program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    if (priv_->compute) {
+        ShaderSource blur_source(Options::data_path + "/shaders/compute-blur.comp");
+        blur_source.replace("$TILE_SIZE$", Util::toString(SceneComputeBlurPrivate::tile_size));
+        blur_source.replace("$RADIUS$", Util::toString(radius));
+        blur_source.replace("$KERNEL$", kernel);
+        if (!load_compute_shader(priv_->blur_program, blur_source))
+            return false;
+    }
+    else {
+        ShaderSource blur_source(Options::data_path + "/shaders/compute-blur.frag",
+                                 ShaderSource::ShaderTypeFragment);
+        blur_source.replace("$RADIUS$", Util::toString(radius));
+        blur_source.replace("$KERNEL$", kernel);
+        blur_source.version(version);
+        if (!Scene::load_shaders_from_strings(priv_->blur_program, vtx_source.str(),
+                                              blur_source.str()))
+        {
+            return false;
+        }
+    }
+
+    priv_->blur_program.start();
+    priv_->blur_program["Source"] = 0;
+    priv_->blit_program.start();
+    priv_->blit_program["Texture0"] = 0;
+
+    /* A pattern of circles on a checkerboard, with plenty of edges to blur */
+    std::vector<uint8_t> pixels(4 * priv_->width * priv_->height);
+    for (GLsizei y = 0; y < priv_->height; y++) {
+        for (GLsizei x = 0; x < priv_->width; x++) {
+            uint8_t *p = &pixels[4 * (y * priv_->width + x)];
+            int cx = x % 64 - 32;
+            int cy = y % 64 - 32;
+            bool check = ((x / 16) ^ (y / 16)) & 1;
+            bool circle = cx * cx + cy * cy < 400;
+            p[0] = circle ? 0xff : (check ? 0x40 : 0xc0);
+            p[1] = circle ? 0x80 : (check ? 0x40 : 0xc0);
+            p[2] = check ? 0xff : 0x20;
+            p[3] = 0xff;
+        }
+    }
+
+    /* Image textures must have immutable storage */
+    glGenTextures(SceneComputeBlurPrivate::TextureCount, priv_->textures);
+    for (GLuint texture : priv_->textures) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        GLExtensions::TexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, priv_->width, priv_->height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, priv_->textures[SceneComputeBlurPrivate::TextureSource]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, priv_->width, priv_->height,
+                    GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (!priv_->compute) {
+        GLExtensions::GenFramebuffers(SceneComputeBlurPrivate::TextureCount, priv_->fbos);
+        for (unsigned int i = SceneComputeBlurPrivate::TextureIntermediate;
+             i < SceneComputeBlurPrivate::TextureCount; i++)
+        {
+            GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, priv_->fbos[i]);
+            GLExtensions::FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                               GL_TEXTURE_2D, priv_->textures[i], 0);
+            GLenum status = GLExtensions::CheckFramebufferStatus(GL_FRAMEBUFFER);
+            if (status != GL_FRAMEBUFFER_COMPLETE) {
+                GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+                Log::error("Failed to create the blur framebuffers (status 0x%x)\n", status);
+                return false;
+            }
+        }
+        GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+    }
+
+    /* The full screen quad for drawing the result */
+    static const GLfloat quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+
+    GLExtensions::GenVertexArrays(1, &priv_->vao);
+    GLExtensions::BindVertexArray(priv_->vao);
+    glGenBuffers(1, &priv_->quad_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, priv_->quad_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    GLint position = priv_->blit_program["position"].location();
+    glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(position);
+    GLExtensions::BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (!priv_->compute && priv_->blur_program["position"].location() != position) {
+        Log::error("The blur programs have different attribute locations\n");
+        return false;
+    }
+
+    return true;
+}
+
+void
+SceneComputeBlur::teardown()
+{
+    double elapsed = realTime_.elapsed();
+    if (elapsed > 0.0) {
+        add_metric("Elements", "element_rate",
+                   static_cast<double>(priv_->width) * priv_->height * currentFrame_ /
+                   (1000000.0 * elapsed), "Mpixels/s", 2);
+    }
+
+    if (priv_->vao) {
+        GLExtensions::DeleteVertexArrays(1, &priv_->vao);
+        priv_->vao = 0;
+    }
+
+    if (priv_->quad_buffer) {
+        glDeleteBuffers(1, &priv_->quad_buffer);
+        priv_->quad_buffer = 0;
+    }
+
+    if (priv_->fbos[0]) {
+        GLExtensions::DeleteFramebuffers(SceneComputeBlurPrivate::TextureCount, priv_->fbos);
+        for (GLuint &f : priv_->fbos)
+            f = 0;
+    }
+
+    if (priv_->textures[0]) {
+        glDeleteTextures(SceneComputeBlurPrivate::TextureCount, priv_->textures);
+        for (GLuint &t : priv_->textures)
+            t = 0;
+    }
+
+    priv_->blur_program.stop();
+    priv_->blur_program.release();
+    priv_->blit_program.stop();
+    priv_->blit_program.release();
+
+    Scene::teardown();
+}
+
+void
+SceneComputeBlur::draw()
+{
+    static const unsigned int tile_size = SceneComputeBlurPrivate::tile_size;
+
+    /* Blur horizontally into the intermediate texture, then vertically */
+    struct {
+        SceneComputeBlurPrivate::Texture source;
+        SceneComputeBlurPrivate::Texture destination;
+        int direction_x;
+        int direction_y;
+    } passes[] = {
+        {SceneComputeBlurPrivate::TextureSource,
+         SceneComputeBlurPrivate::TextureIntermediate, 1, 0},
+        {SceneComputeBlurPrivate::TextureIntermediate,
+         SceneComputeBlurPrivate::TextureResult, 0, 1},
+    };
+
+    priv_->blur_program.start();
+    glActiveTexture(GL_TEXTURE0);
+
+    if (!priv_->compute) {
+        glViewport(0, 0, priv_->width, priv_->height);
+        GLExtensions::BindVertexArray(priv_->vao);
+    }
+
+    for (auto &pass : passes) {
+        glBindTexture(GL_TEXTURE_2D, priv_->textures[pass.source]);
+        glUniform2i(priv_->blur_program["Direction"].location(),
+                    pass.direction_x, pass.direction_y);
+
+        if (priv_->compute) {
+            GLExtensions::BindImageTexture(0, priv_->textures[pass.destination], 0,
+                                           GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+            /* One work group per tile of a row or a column */
+            if (pass.direction_x)
+                GLExtensions::DispatchCompute(work_groups(priv_->width, tile_size),
+                                              priv_->height, 1);
+            else
+                GLExtensions::DispatchCompute(work_groups(priv_->height, tile_size),
+                                              priv_->width, 1);
+            GLExtensions::MemoryBarrierGL(GL_TEXTURE_FETCH_BARRIER_BIT);
+        }
+        else {
+            GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, priv_->fbos[pass.destination]);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        }
+    }
+
+    /* Show the result */
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+    glViewport(0, 0, canvas_.width(), canvas_.height());
+
+    priv_->blit_program.start();
+    GLExtensions::BindVertexArray(priv_->vao);
+    glBindTexture(GL_TEXTURE_2D, priv_->textures[SceneComputeBlurPrivate::TextureResult]);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    GLExtensions::BindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+struct SceneComputeNBodyPrivate
+{
+    static const unsigned int local_size = 128;
+
+    SceneComputeNBodyPrivate() : particles(0), current(0), velocity_buffer(0)
+    {
+        for (unsigned int i = 0; i < 2; i++) {
+            position_buffers[i] = 0;
+            vaos[i] = 0;
+        }
+    }
+
+    unsigned int particles;
+    Program update_program;
+    Program draw_program;
+    /* The positions are read from one buffer and written to the other */
+    unsigned int current;
+    GLuint position_buffers[2];
+    /* Draws the positions of the matching buffer as points */
+    GLuint vaos[2];
+    GLuint velocity_buffer;
+    LibMatrix::mat4 projection;
+};
+
+SceneComputeNBody::SceneComputeNBody(Canvas &pCanvas) :
+    SceneCompute(pCanvas, "compute-nbody")
+{
+    priv_ = new SceneComputeNBodyPrivate();
+    options_["particles"] = Scene::Option("particles", "4096",
+                                          "The number of particles to simulate");
+}
+
+SceneComputeNBody::~SceneComputeNBody()
+{
+    delete priv_;
+}
+
+bool
+SceneComputeNBody::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    static const unsigned int local_size = SceneComputeNBodyPrivate::local_size;
+
+    priv_->particles = Util::fromString<unsigned int>(options_["particles"].value);
+    if (priv_->particles == 0 ||
+        work_groups(priv_->particles, local_size) > max_work_groups)
+    {
+        Log::error("The number of particles must be between 1 and %u\n",
+                   max_work_groups * local_size);
+        priv_->particles = 0;
+        return false;
+    }
+
+    /* Load the shaders */
+    ShaderSource update_source(Options::data_path + "/shaders/compute-nbody.comp");
+    update_source.replace("$LOCAL_SIZE$", Util::toString(local_size));
+    if (!load_compute_shader(priv_->update_program, update_source))
+        return false;
+
+    ShaderSource vtx_source(Options::data_path + "/shaders/compute-nbody.vert",
+                            ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(Options::data_path + "/shaders/compute-nbody.frag",
+                            ShaderSource::ShaderTypeFragment);
+    std::string version(Scene::glsl_version(430, 310));
+    vtx_source.version(version);
+    frg_source.version(version);
+
+    if (!Scene::load_shaders_from_strings(priv_->draw_program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    /*
+     * A disc galaxy: the particles orbit the center in the same direction,
+     * with the speed needed to balance the mass closer to the center.
+     */
+    unsigned int n = priv_->particles;
+    std::vector<LibMatrix::vec4> positions(n);
+    std::vector<LibMatrix::vec4> velocities(n);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float mass = 1.0f / n;
+
+    for (unsigned int i = 0; i < n; i++) {
+        float r = 0.05f + 0.95f * std::sqrt(unit(rng));
+        float theta = 2.0f * M_PI * unit(rng);
+        float h = 0.05f * (unit(rng) - 0.5f);
+        positions[i] = LibMatrix::vec4(r * std::cos(theta), h, r * std::sin(theta), mass);
+
+        /* The mass inside the orbit grows as r^2, so v^2 = M(r) / r = r */
+        float speed = std::sqrt(r);
+        velocities[i] = LibMatrix::vec4(-speed * std::sin(theta), 0.0f,
+                                        speed * std::cos(theta), 0.0f);
+    }
+
+    glGenBuffers(2, priv_->position_buffers);
+    GLExtensions::GenVertexArrays(2, priv_->vaos);
+    GLint position = priv_->draw_program["position"].location();
+
+    for (unsigned int i = 0; i < 2; i++) {
+        GLExtensions::BindVertexArray(priv_->vaos[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, priv_->position_buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, n * sizeof(LibMatrix::vec4),
+                     positions.data(), GL_DYNAMIC_COPY);
+        glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, 0, 0);
+        glEnableVertexAttribArray(position);
+    }
+    GLExtensions::BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &priv_->velocity_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, priv_->velocity_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, n * sizeof(LibMatrix::vec4),
+                 velocities.data(), GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    priv_->current = 0;
+    priv_->update_program.start();
+    priv_->update_program["Count"] = static_cast<int>(n);
+    priv_->update_program["TimeStep"] = 0.002f;
+
+    float aspect = static_cast<float>(canvas_.width()) / canvas_.height();
+    priv_->projection = LibMatrix::Mat4::perspective(45.0f, aspect, 0.1f, 10.0f);
+
+#if !GLMARK2_USE_GLESv2
+    glEnable(GL_PROGRAM_POINT_SIZE);
+#endif
+
+    return true;
+}
+
+void
+SceneComputeNBody::teardown()
+{
+    double elapsed = realTime_.elapsed();
+    if (elapsed > 0.0 && priv_->particles > 0) {
+        double n = priv_->particles;
+        add_metric("Elements", "element_rate",
+                   n * currentFrame_ / (1000.0 * elapsed), "K/s", 1);
+        add_metric("Interactions", "interaction_rate",
+                   n * n * currentFrame_ / (1000000000.0 * elapsed), "G/s", 3);
+    }
+
+#if !GLMARK2_USE_GLESv2
+    glDisable(GL_PROGRAM_POINT_SIZE);
+#endif
+
+    if (priv_->vaos[0]) {
+        GLExtensions::DeleteVertexArrays(2, priv_->vaos);
+        priv_->vaos[0] = priv_->vaos[1] = 0;
+    }
+
+    if (priv_->position_buffers[0]) {
+        glDeleteBuffers(2, priv_->position_buffers);
+        priv_->position_buffers[0] = priv_->position_buffers[1] = 0;
+    }
+
+    if (priv_->velocity_buffer) {
+        glDeleteBuffers(1, &priv_->velocity_buffer);
+        priv_->velocity_buffer = 0;
+    }
+
+    priv_->update_program.stop();
+    priv_->update_program.release();
+    priv_->draw_program.stop();
+    priv_->draw_program.release();
+
+    Scene::teardown();
+}
+
+void
+SceneComputeNBody::draw()
+{
+    unsigned int next = 1 - priv_->current;
+
+    /* Advance the simulation by one step */
+    priv_->update_program.start();
+    GLExtensions::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+                                 priv_->position_buffers[priv_->current]);
+    GLExtensions::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                                 priv_->position_buffers[next]);
+    GLExtensions::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, priv_->velocity_buffer);
+    GLExtensions::DispatchCompute(work_groups(priv_->particles,
+                                              SceneComputeNBodyPrivate::local_size), 1, 1);
+    GLExtensions::MemoryBarrierGL(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                                  GL_SHADER_STORAGE_BARRIER_BIT);
+
+    /* Draw the new positions, orbiting slowly above the disc */
+    float angle = 0.1f * realTime_.elapsed();
+    LibMatrix::mat4 view_projection(priv_->projection);
+    view_projection *= LibMatrix::Mat4::lookAt(2.5f * std::sin(angle), 1.2f,
+                                               2.5f * std::cos(angle),
+                                               0.0f, 0.0f, 0.0f,
+                                               0.0f, 1.0f, 0.0f);
+
+    priv_->draw_program.start();
+    priv_->draw_program["ViewProjectionMatrix"] = view_projection;
+    GLExtensions::BindVertexArray(priv_->vaos[next]);
+    glDrawArrays(GL_POINTS, 0, priv_->particles);
+    GLExtensions::BindVertexArray(0);
+
+    priv_->current = next;
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <vector>
+
+struct SceneComputePrefixSumPrivate
+{
+    /* Each work group scans a block of two elements per invocation */
+    static const unsigned int local_size = 128;
+    static const unsigned int block_size = 2 * local_size;
+
+    SceneComputePrefixSumPrivate() :
+        input_buffer(0), sums_buffer(0), validation(Scene::ValidationUnknown) {}
+
+    /* Compares the scanned elements with the ones computed on the CPU */
+    Scene::ValidationResult check_result();
+
+    Program scan_program;
+    Program add_program;
+    std::vector<GLuint> input;
+    /* The number of elements to scan at each level */
+    std::vector<unsigned int> level_sizes;
+    /*
+     * The scanned elements of each level: the first holds the result,
+     * the others the block totals of the previous level.
+     */
+    std::vector<GLuint> level_buffers;
+    GLuint input_buffer;
+    /* Receives the (unused) total of the single block of the last level */
+    GLuint sums_buffer;
+    /* The buffers are gone by the time the scene is validated */
+    Scene::ValidationResult validation;
+};
+
+Scene::ValidationResult
+SceneComputePrefixSumPrivate::check_result()
+{
+    GLExtensions::MemoryBarrierGL(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, level_buffers[0]);
+    const GLuint *result = static_cast<const GLuint *>(
+        GLExtensions::MapBufferRange(GL_SHADER_STORAGE_BUFFER, 0,
+                                     input.size() * sizeof(GLuint), GL_MAP_READ_BIT));
+    if (!result) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        return Scene::ValidationUnknown;
+    }
+
+    /* The scan is exclusive: each element is the sum of the ones before it */
+    GLuint sum = 0;
+    size_t bad = input.size();
+    for (size_t i = 0; i < input.size(); i++) {
+        if (result[i] != sum) {
+            bad = i;
+            break;
+        }
+        sum += input[i];
+    }
+
+    if (bad < input.size()) {
+        Log::debug("Validation failed! Element %zu is %u instead of %u\n",
+                   bad, result[bad], sum);
+    }
+
+    GLExtensions::UnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    return bad < input.size() ? Scene::ValidationFailure : Scene::ValidationSuccess;
+}
+
+SceneComputePrefixSum::SceneComputePrefixSum(Canvas &pCanvas) :
+    SceneCompute(pCanvas, "compute-prefix-sum")
+{
+    priv_ = new SceneComputePrefixSumPrivate();
+    options_["elements"] = Scene::Option("elements", "1048576",
+                                         "The number of elements to scan");
+}
+
+SceneComputePrefixSum::~SceneComputePrefixSum()
+{
+    delete priv_;
+}
+
+bool
+SceneComputePrefixSum::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    static const unsigned int block_size = SceneComputePrefixSumPrivate::block_size;
+
+    priv_->validation = Scene::ValidationUnknown;
+
+    unsigned int elements = Util::fromString<unsigned int>(options_["elements"].value);
+    if (elements == 0 || work_groups(elements, block_size) > max_work_groups) {
+        Log::error("The number of elements must be between 1 and %u\n",
+                   max_work_groups * block_size);
+        return false;
+    }
+
+    std::string local_size(Util::toString(SceneComputePrefixSumPrivate::local_size));
+    ShaderSource scan_source(Options::data_path + "/shaders/compute-scan.comp");
+    ShaderSource add_source(Options::data_path + "/shaders/compute-scan-add.comp");
+    scan_source.replace("$LOCAL_SIZE$", local_size);
+    add_source.replace("$LOCAL_SIZE$", local_size);
+
+    if (!load_compute_shader(priv_->scan_program, scan_source) ||
+        !load_compute_shader(priv_->add_program, add_source))
+    {
+        return false;
+    }
+
+    /* Small pseudo-random values, so that the sums don't overflow */
+    priv_->input.resize(elements);
+    for (unsigned int i = 0; i < elements; i++)
+        priv_->input[i] = (i * 2654435761u) >> 28;
+
+    /* Scan the block totals recursively, until they fit in a single block */
+    unsigned int n = elements;
+    priv_->level_sizes.push_back(n);
+    while (n > block_size) {
+        n = work_groups(n, block_size);
+        priv_->level_sizes.push_back(n);
+    }
+
+    priv_->level_buffers.resize(priv_->level_sizes.size());
+    glGenBuffers(priv_->level_buffers.size(), priv_->level_buffers.data());
+    for (size_t i = 0; i < priv_->level_buffers.size(); i++) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, priv_->level_buffers[i]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, priv_->level_sizes[i] * sizeof(GLuint),
+                     0, GL_DYNAMIC_COPY);
+    }
+
+    glGenBuffers(1, &priv_->input_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, priv_->input_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, elements * sizeof(GLuint),
+                 priv_->input.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &priv_->sums_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, priv_->sums_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint), 0, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    return true;
+}
+
+void
+SceneComputePrefixSum::teardown()
+{
+    double elapsed = realTime_.elapsed();
+    if (elapsed > 0.0 && !priv_->input.empty()) {
+        add_metric("Elements", "element_rate",
+                   priv_->input.size() * static_cast<double>(currentFrame_) /
+                   (1000000.0 * elapsed), "M/s", 2);
+    }
+
+    if (Options::validate && !priv_->level_buffers.empty())
+        priv_->validation = priv_->check_result();
+
+    if (!priv_->level_buffers.empty())
+        glDeleteBuffers(priv_->level_buffers.size(), priv_->level_buffers.data());
+    priv_->level_buffers.clear();
+    priv_->level_sizes.clear();
+    priv_->input.clear();
+
+    GLuint buffers[] = {priv_->input_buffer, priv_->sums_buffer};
+    for (GLuint buffer : buffers) {
+        if (buffer)
+            glDeleteBuffers(1, &buffer);
+    }
+    priv_->input_buffer = 0;
+    priv_->sums_buffer = 0;
+
+    priv_->scan_program.stop();
+    priv_->scan_program.release();
+    priv_->add_program.stop();
+    priv_->add_program.release();
+
+    Scene::teardown();
+}
+
+void
+SceneComputePrefixSum::draw()
+{
+    static const unsigned int block_size = SceneComputePrefixSumPrivate::block_size;
+
+    const std::vector<GLuint> &buffers = priv_->level_buffers;
+    const std::vector<unsigned int> &sizes = priv_->level_sizes;
+    size_t levels = sizes.size();
+
+    /* Scan the blocks of each level, saving their totals in the next level */
+    priv_->scan_program.start();
+    for (size_t i = 0; i < levels; i++) {
+        GLExtensions::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+                                     i == 0 ? priv_->input_buffer : buffers[i]);
+        GLExtensions::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffers[i]);
+        GLExtensions::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+                                     i + 1 < levels ? buffers[i + 1] : priv_->sums_buffer);
+        priv_->scan_program["Count"] = static_cast<int>(sizes[i]);
+        GLExtensions::DispatchCompute(work_groups(sizes[i], block_size), 1, 1);
+        GLExtensions::MemoryBarrierGL(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    /* Add the scanned totals back, from the smallest level down */
+    priv_->add_program.start();
+    for (size_t i = levels - 1; i-- > 0;) {
+        GLExtensions::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffers[i]);
+        GLExtensions::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffers[i + 1]);
+        priv_->add_program["Count"] = static_cast<int>(sizes[i]);
+        GLExtensions::DispatchCompute(work_groups(sizes[i], block_size), 1, 1);
+        GLExtensions::MemoryBarrierGL(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+}
+
+Scene::ValidationResult
+SceneComputePrefixSum::validate()
+{
+    return priv_->validation;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "shader-source.h"
+#include "log.h"
+#include "gl-headers.h"
+
+SceneCompute::SceneCompute(Canvas &pCanvas, const std::string &name) :
+    Scene(pCanvas, name)
+{
+}
+
+SceneCompute::~SceneCompute()
+{
+}
+
+bool
+SceneCompute::supported(bool show_errors)
+{
+#if GLMARK2_USE_GLESv2
+    bool version_ok = GLExtensions::version_at_least(3, 1);
+#else
+    bool version_ok = GLExtensions::version_at_least(4, 3);
+#endif
+
+    if (!version_ok || !GLExtensions::DispatchCompute || !GLExtensions::MemoryBarrierGL ||
+        !GLExtensions::BindBufferBase || !GLExtensions::BindImageTexture ||
+        !GLExtensions::TexStorage2D || !GLExtensions::GenVertexArrays)
+    {
+        if (show_errors) {
+            Log::error("Compute shaders require GL 4.3 or GLES 3.1,"
+                       " which are not supported!\n");
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneCompute::load_compute_shader(Program &program, ShaderSource &source)
+{
+    source.version(Scene::glsl_version(430, 310));
+    return Scene::load_compute_shader_from_string(program, source.str());
+}
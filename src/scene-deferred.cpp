@@ -0,0 +1,791 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "mesh.h"
+#include "model.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+struct SceneDeferredPrivate
+{
+    enum Method {
+        MethodVolumes,
+        MethodTiled,
+    };
+
+    struct Light {
+        LibMatrix::vec3 base;
+        LibMatrix::vec3 color;
+        float phase;
+        float speed;
+    };
+
+    /* The width of the textures holding the light data of the tiled method */
+    static const unsigned int data_width = 1024;
+    /* The size of the screen tiles of the tiled method, in pixels */
+    static const unsigned int tile_size = 16;
+    /* The floor spans [-floor_size, floor_size] in x and z */
+    static constexpr float floor_size = 2.0f;
+    static constexpr float near_plane = 0.5f;
+    static constexpr float fovy = 50.0f;
+
+    SceneDeferredPrivate() :
+        method(MethodVolumes), light_radius(0.0f), width(0), height(0),
+        tiles_x(0), tiles_y(0), fbo(0), albedo_texture(0), normal_texture(0),
+        depth_texture(0), floor_vao(0), floor_buffer(0), quad_vao(0),
+        quad_buffer(0), volume_vao(0), volume_buffer(0), volume_index_buffer(0),
+        instance_buffer(0), light_texture(0), header_texture(0),
+        index_texture(0), index_rows(0), cpu_time_ns(0) {}
+
+    /**
+     * Creates a cube spanning [-1, 1], with its faces wound counter-clockwise
+     * when seen from the outside.
+     */
+    static void create_volume(std::vector<float> &vertices,
+                              std::vector<GLushort> &indices)
+    {
+        static const float normals[6][3] = {
+            { 1, 0, 0}, {-1, 0, 0}, {0,  1, 0},
+            {0, -1, 0}, { 0, 0, 1}, {0,  0, -1},
+        };
+        static const float corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+        static const GLushort quad[6] = {0, 1, 2, 0, 2, 3};
+
+        for (const float *n : normals) {
+            float u[3] = {n[1] + n[2], n[2] + n[0], n[0] + n[1]};
+            float v[3] = {n[1] * u[2] - n[2] * u[1],
+                          n[2] * u[0] - n[0] * u[2],
+                          n[0] * u[1] - n[1] * u[0]};
+            GLushort base = vertices.size() / 3;
+
+            for (const float *c : corners) {
+                for (unsigned int i = 0; i < 3; i++)
+                    vertices.push_back(n[i] + c[0] * u[i] + c[1] * v[i]);
+            }
+            for (GLushort i : quad)
+                indices.push_back(base + i);
+        }
+    }
+
+    /**
+     * Gets the range of screen tiles covered by a light.
+     *
+     * The range is that of the projection of the view space box bounding
+     * the sphere of influence of the light, which is conservative.
+     *
+     * @return false if the light isn't visible
+     */
+    bool light_tiles(const LibMatrix::vec4 &light, unsigned int tiles[4]) const
+    {
+        float r = light.w();
+        float ndc[4] = {-1.0f, -1.0f, 1.0f, 1.0f};
+
+        if (light.z() - r > -near_plane)
+            return false;
+
+        if (light.z() + r < -near_plane) {
+            float x[2] = {light.x() - r, light.x() + r};
+            float y[2] = {light.y() - r, light.y() + r};
+            float z[2] = {-(light.z() - r), -(light.z() + r)};
+            ndc[0] = ndc[1] = 1.0f;
+            ndc[2] = ndc[3] = -1.0f;
+            for (float d : z) {
+                for (unsigned int i = 0; i < 2; i++) {
+                    float px = projection[0][0] * x[i] / d;
+                    float py = projection[1][1] * y[i] / d;
+                    ndc[0] = std::min(ndc[0], px);
+                    ndc[1] = std::min(ndc[1], py);
+                    ndc[2] = std::max(ndc[2], px);
+                    ndc[3] = std::max(ndc[3], py);
+                }
+            }
+            if (ndc[0] > 1.0f || ndc[1] > 1.0f || ndc[2] < -1.0f || ndc[3] < -1.0f)
+                return false;
+        }
+
+        float tx = 0.5f * width / tile_size;
+        float ty = 0.5f * height / tile_size;
+        tiles[0] = std::max(0.0f, (ndc[0] + 1.0f) * tx);
+        tiles[1] = std::max(0.0f, (ndc[1] + 1.0f) * ty);
+        tiles[2] = std::min<float>(tiles_x - 1, (ndc[2] + 1.0f) * tx);
+        tiles[3] = std::min<float>(tiles_y - 1, (ndc[3] + 1.0f) * ty);
+        return true;
+    }
+
+    void update_lights(const LibMatrix::mat4 &view, float time);
+    void build_tiles();
+
+    Method method;
+    float light_radius;
+    std::vector<Light> lights;
+    GLsizei width;
+    GLsizei height;
+    unsigned int tiles_x;
+    unsigned int tiles_y;
+
+    Program gbuffer_program;
+    Program ambient_program;
+    Program light_program;
+    Mesh mesh;
+    LibMatrix::mat4 model_matrix;
+    LibMatrix::mat4 projection;
+
+    GLuint fbo;
+    GLuint albedo_texture;
+    GLuint normal_texture;
+    GLuint depth_texture;
+    GLuint floor_vao;
+    GLuint floor_buffer;
+    GLuint quad_vao;
+    GLuint quad_buffer;
+    GLuint volume_vao;
+    GLuint volume_buffer;
+    GLuint volume_index_buffer;
+    GLuint instance_buffer;
+    GLuint light_texture;
+    GLuint header_texture;
+    GLuint index_texture;
+    unsigned int index_rows;
+
+    /* The view space position and radius, and the color of each light */
+    std::vector<LibMatrix::vec4> light_data;
+    std::vector<LibMatrix::vec4> tile_headers;
+    std::vector<float> tile_indices;
+    uint64_t cpu_time_ns;
+};
+
+void
+SceneDeferredPrivate::update_lights(const LibMatrix::mat4 &view, float time)
+{
+    for (size_t i = 0; i < lights.size(); i++) {
+        const Light &l = lights[i];
+        float angle = l.speed * time + l.phase;
+        LibMatrix::vec4 world(l.base.x() + 0.3f * std::cos(angle),
+                              l.base.y() + 0.1f * std::sin(2.0f * angle),
+                              l.base.z() + 0.3f * std::sin(angle), 1.0f);
+        LibMatrix::vec4 pos(view * world);
+        light_data[2 * i] = LibMatrix::vec4(pos.x(), pos.y(), pos.z(), light_radius);
+        light_data[2 * i + 1] = LibMatrix::vec4(l.color.x(), l.color.y(), l.color.z(), 1.0f);
+    }
+}
+
+/*
+ * Bins the lights into screen tiles with a counting sort: the first pass
+ * counts the lights of each tile, the second fills in the packed lists.
+ */
+void
+SceneDeferredPrivate::build_tiles()
+{
+    std::vector<unsigned int> ranges(4 * lights.size());
+    std::vector<unsigned int> counts(tiles_x * tiles_y, 0);
+    std::vector<bool> visible(lights.size());
+
+    for (size_t i = 0; i < lights.size(); i++) {
+        unsigned int *t = &ranges[4 * i];
+        visible[i] = light_tiles(light_data[2 * i], t);
+        if (!visible[i])
+            continue;
+        for (unsigned int y = t[1]; y <= t[3]; y++) {
+            for (unsigned int x = t[0]; x <= t[2]; x++)
+                counts[y * tiles_x + x]++;
+        }
+    }
+
+    unsigned int total = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        tile_headers[i] = LibMatrix::vec4(total, counts[i], 0.0f, 0.0f);
+        counts[i] = total;
+        total += tile_headers[i].y();
+    }
+
+    unsigned int rows = (total + 4 * data_width - 1) / (4 * data_width);
+    tile_indices.resize(std::max(1u, rows) * 4 * data_width);
+
+    for (size_t i = 0; i < lights.size(); i++) {
+        const unsigned int *t = &ranges[4 * i];
+        if (!visible[i])
+            continue;
+        for (unsigned int y = t[1]; y <= t[3]; y++) {
+            for (unsigned int x = t[0]; x <= t[2]; x++)
+                tile_indices[counts[y * tiles_x + x]++] = i;
+        }
+    }
+}
+
+SceneDeferred::SceneDeferred(Canvas &pCanvas) :
+    Scene(pCanvas, "deferred")
+{
+    priv_ = new SceneDeferredPrivate();
+
+    const ModelMap& modelMap = Model::find_models();
+    std::string optionValues;
+    for (ModelMap::const_iterator modelIt = modelMap.begin();
+         modelIt != modelMap.end();
+         modelIt++)
+    {
+        if (!optionValues.empty())
+            optionValues += ",";
+        optionValues += modelIt->first;
+    }
+
+    options_["model"] = Scene::Option("model", "horse", "Which model to use",
+                                      optionValues);
+    options_["lights"] = Scene::Option("lights", "256",
+                                       "The number of dynamic point lights");
+    options_["light-radius"] = Scene::Option("light-radius", "0.5",
+                                             "The radius of influence of each light,"
+                                             " in model units (the floor is 4 units wide)");
+    options_["method"] = Scene::Option("method", "volumes",
+                                       "How to accumulate the lights: instanced light"
+                                       " volumes, or screen tiles with per-tile light"
+                                       " lists built on the CPU",
+                                       "volumes,tiled");
+}
+
+SceneDeferred::~SceneDeferred()
+{
+    delete priv_;
+}
+
+bool
+SceneDeferred::supported(bool show_errors)
+{
+#if GLMARK2_USE_GLESv2
+    bool version_ok = GLExtensions::version_at_least(3, 0);
+#else
+    bool version_ok = GLExtensions::version_at_least(3, 3);
+#endif
+
+    if (!version_ok || !GLExtensions::DrawBuffers || !GLExtensions::GenVertexArrays ||
+        !GLExtensions::DrawElementsInstanced || !GLExtensions::VertexAttribDivisor)
+    {
+        if (show_errors) {
+            Log::error("Deferred lighting requires GL 3.3 or GLES 3.0,"
+                       " which are not supported!\n");
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneDeferred::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    unsigned int nlights = Util::fromString<unsigned int>(options_["lights"].value);
+    priv_->light_radius = Util::fromString<float>(options_["light-radius"].value);
+    priv_->method = options_["method"].value == "tiled" ?
+                    SceneDeferredPrivate::MethodTiled :
+                    SceneDeferredPrivate::MethodVolumes;
+
+    if (nlights == 0 || priv_->light_radius <= 0.0f) {
+        Log::error("The number of lights and their radius must be positive\n");
+        return false;
+    }
+
+    /* Load the shaders */
+    std::string version(Scene::glsl_version(330, 300));
+    std::string shaders(Options::data_path + "/shaders/");
+
+    ShaderSource gbuffer_vtx(shaders + "deferred-gbuffer.vert", ShaderSource::ShaderTypeVertex);
+    ShaderSource gbuffer_frg(shaders + "deferred-gbuffer.frag", ShaderSource::ShaderTypeFragment);
+    ShaderSource quad_vtx(shaders + "deferred-quad.vert", ShaderSource::ShaderTypeVertex);
+    ShaderSource ambient_frg(shaders + "deferred-common.frag", ShaderSource::ShaderTypeFragment);
+    ShaderSource light_frg(shaders + "deferred-common.frag", ShaderSource::ShaderTypeFragment);
+    ShaderSource volume_vtx(shaders + "deferred-light.vert", ShaderSource::ShaderTypeVertex);
+
+    ambient_frg.append_file(shaders + "deferred-ambient.frag");
+    if (priv_->method == SceneDeferredPrivate::MethodTiled) {
+        light_frg.append_file(shaders + "deferred-tiled.frag");
+        light_frg.replace("$DATA_WIDTH$", Util::toString(SceneDeferredPrivate::data_width));
+    }
+    else {
+        light_frg.append_file(shaders + "deferred-volume.frag");
+    }
+
+    ShaderSource *sources[] = {&gbuffer_vtx, &gbuffer_frg, &quad_vtx, &ambient_frg,
+                               &light_frg, &volume_vtx};
+    for (ShaderSource *source : sources)
+        source->version(version);
+
+    ShaderSource &light_vtx = priv_->method == SceneDeferredPrivate::MethodTiled ?
+                              quad_vtx : volume_vtx;
+
+    if (!Scene::load_shaders_from_strings(priv_->gbuffer_program, gbuffer_vtx.str(),
+                                          gbuffer_frg.str()) ||
+        !Scene::load_shaders_from_strings(priv_->ambient_program, quad_vtx.str(),
+                                          ambient_frg.str()) ||
+        !Scene::load_shaders_from_strings(priv_->light_program, light_vtx.str(),
+                                          light_frg.str()))
+    {
+        return false;
+    }
+
+    /* Load the model, scaled to stand in the middle of the floor */
+    Model model;
+    if (!model.load(options_["model"].value))
+        return false;
+
+    if (model.needNormals())
+        model.calculate_normals();
+
+    std::vector<std::pair<Model::AttribType, int> > attribs;
+    attribs.push_back(std::pair<Model::AttribType, int>(Model::AttribTypePosition, 3));
+    attribs.push_back(std::pair<Model::AttribType, int>(Model::AttribTypeNormal, 3));
+    model.convert_to_mesh(priv_->mesh, attribs);
+    priv_->mesh.build_vbo();
+
+    GLint position = priv_->gbuffer_program["position"].location();
+    GLint normal = priv_->gbuffer_program["normal"].location();
+    std::vector<GLint> attrib_locations;
+    attrib_locations.push_back(position);
+    attrib_locations.push_back(normal);
+    priv_->mesh.set_attrib_locations(attrib_locations);
+
+    LibMatrix::vec3 min_vec(model.minVec());
+    LibMatrix::vec3 extent(model.maxVec() - min_vec);
+    float scale = 1.5f / std::max(extent.x(), std::max(extent.y(), extent.z()));
+    priv_->model_matrix = LibMatrix::Mat4::scale(scale, scale, scale);
+    priv_->model_matrix *= LibMatrix::Mat4::translate(-min_vec.x() - 0.5f * extent.x(),
+                                                      -min_vec.y(),
+                                                      -min_vec.z() - 0.5f * extent.z());
+
+    /* The floor and the full screen quad */
+    static const float s = SceneDeferredPrivate::floor_size;
+    static const GLfloat floor[] = {
+        -s, 0.0f,  s, 0.0f, 1.0f, 0.0f,
+         s, 0.0f,  s, 0.0f, 1.0f, 0.0f,
+        -s, 0.0f, -s, 0.0f, 1.0f, 0.0f,
+         s, 0.0f, -s, 0.0f, 1.0f, 0.0f,
+    };
+    static const GLfloat quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+
+    GLExtensions::GenVertexArrays(1, &priv_->floor_vao);
+    GLExtensions::BindVertexArray(priv_->floor_vao);
+    glGenBuffers(1, &priv_->floor_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, priv_->floor_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(floor), floor, GL_STATIC_DRAW);
+    glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), 0);
+    glVertexAttribPointer(normal, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
+                          reinterpret_cast<const void *>(3 * sizeof(float)));
+    glEnableVertexAttribArray(position);
+    glEnableVertexAttribArray(normal);
+
+    GLExtensions::GenVertexArrays(1, &priv_->quad_vao);
+    GLExtensions::BindVertexArray(priv_->quad_vao);
+    glGenBuffers(1, &priv_->quad_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, priv_->quad_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    GLint quad_position = priv_->ambient_program["position"].location();
+    if (priv_->method == SceneDeferredPrivate::MethodTiled &&
+        priv_->light_program["position"].location() != quad_position)
+    {
+        Log::error("The deferred lighting programs have different attribute locations\n");
+        return false;
+    }
+    glVertexAttribPointer(quad_position, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(quad_position);
+
+    /* The G-buffer: albedo and specular, normal, and depth */
+    priv_->width = canvas_.width();
+    priv_->height = canvas_.height();
+
+    struct {
+        GLuint *texture;
+        GLenum internal_format;
+        GLenum format;
+        GLenum type;
+    } gbuffer[] = {
+        {&priv_->albedo_texture, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE},
+        {&priv_->normal_texture, GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV},
+        {&priv_->depth_texture, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT},
+    };
+
+    for (auto &t : gbuffer) {
+        glGenTextures(1, t.texture);
+        glBindTexture(GL_TEXTURE_2D, *t.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, t.internal_format, priv_->width, priv_->height,
+                     0, t.format, t.type, 0);
+    }
+
+    static const GLenum draw_buffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    GLExtensions::GenFramebuffers(1, &priv_->fbo);
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, priv_->fbo);
+    GLExtensions::FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                       GL_TEXTURE_2D, priv_->albedo_texture, 0);
+    GLExtensions::FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1,
+                                       GL_TEXTURE_2D, priv_->normal_texture, 0);
+    GLExtensions::FramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                       GL_TEXTURE_2D, priv_->depth_texture, 0);
+    GLExtensions::DrawBuffers(2, draw_buffers);
+    GLenum status = GLExtensions::CheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        Log::error("Failed to create the G-buffer (status 0x%x)\n", status);
+        return false;
+    }
+
+    /* The lights, in a fixed pseudo-random arrangement over the floor */
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    priv_->lights.resize(nlights);
+    for (SceneDeferredPrivate::Light &l : priv_->lights) {
+        l.base = LibMatrix::vec3(s * (2.0f * unit(rng) - 1.0f),
+                                 0.1f + 1.2f * unit(rng),
+                                 s * (2.0f * unit(rng) - 1.0f));
+        l.phase = 2.0f * M_PI * unit(rng);
+        l.speed = 0.5f + unit(rng);
+        l.color = LibMatrix::vec3(0.5f + 0.5f * std::cos(l.phase),
+                                  0.5f + 0.5f * std::cos(l.phase + 2.0f),
+                                  0.5f + 0.5f * std::cos(l.phase + 4.0f));
+    }
+
+    /* Dim the lights as they overlap more, so that the image doesn't saturate */
+    float coverage = nlights * M_PI * priv_->light_radius * priv_->light_radius /
+                     (4.0f * s * s);
+    float intensity = 10.0f / std::max(1.0f, coverage);
+    for (SceneDeferredPrivate::Light &l : priv_->lights)
+        l.color *= intensity;
+
+    priv_->light_data.resize(2 * nlights);
+
+    float aspect = static_cast<float>(priv_->width) / priv_->height;
+    priv_->projection = LibMatrix::Mat4::perspective(SceneDeferredPrivate::fovy, aspect,
+                                                     SceneDeferredPrivate::near_plane,
+                                                     20.0f);
+    LibMatrix::mat4 inverse_projection(priv_->projection);
+    inverse_projection.inverse();
+    LibMatrix::vec2 inverse_viewport(1.0f / priv_->width, 1.0f / priv_->height);
+
+    Program *lighting[] = {&priv_->ambient_program, &priv_->light_program};
+    for (Program *program : lighting) {
+        program->start();
+        (*program)["GBufferAlbedo"] = 0;
+        (*program)["GBufferNormal"] = 1;
+        (*program)["GBufferDepth"] = 2;
+        (*program)["InverseProjectionMatrix"] = inverse_projection;
+        (*program)["InverseViewport"] = inverse_viewport;
+    }
+    priv_->ambient_program.start();
+    priv_->ambient_program["AmbientColor"] = LibMatrix::vec3(0.1f, 0.1f, 0.12f);
+    priv_->light_program.start();
+
+    if (priv_->method == SceneDeferredPrivate::MethodTiled) {
+        unsigned int tile = SceneDeferredPrivate::tile_size;
+        unsigned int data_width = SceneDeferredPrivate::data_width;
+        priv_->tiles_x = (priv_->width + tile - 1) / tile;
+        priv_->tiles_y = (priv_->height + tile - 1) / tile;
+        priv_->tile_headers.resize(priv_->tiles_x * priv_->tiles_y);
+
+        GLint max_size = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+        unsigned int light_rows = (2 * nlights + data_width - 1) / data_width;
+        if (light_rows > static_cast<unsigned int>(max_size)) {
+            Log::error("Too many lights for the light data texture\n");
+            return false;
+        }
+        priv_->light_data.resize(light_rows * data_width);
+
+        GLuint *textures[] = {&priv_->light_texture, &priv_->header_texture,
+                              &priv_->index_texture};
+        for (GLuint *t : textures) {
+            glGenTextures(1, t);
+            glBindTexture(GL_TEXTURE_2D, *t);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, priv_->light_texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, data_width, light_rows, 0,
+                     GL_RGBA, GL_FLOAT, 0);
+        glBindTexture(GL_TEXTURE_2D, priv_->header_texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, priv_->tiles_x, priv_->tiles_y, 0,
+                     GL_RGBA, GL_FLOAT, 0);
+        priv_->index_rows = 0;
+
+        priv_->light_program["LightData"] = 3;
+        priv_->light_program["TileHeaders"] = 4;
+        priv_->light_program["TileIndices"] = 5;
+        priv_->light_program["TileSize"] = static_cast<int>(tile);
+    }
+    else {
+        std::vector<float> vertices;
+        std::vector<GLushort> indices;
+        SceneDeferredPrivate::create_volume(vertices, indices);
+
+        GLExtensions::GenVertexArrays(1, &priv_->volume_vao);
+        GLExtensions::BindVertexArray(priv_->volume_vao);
+
+        glGenBuffers(1, &priv_->volume_buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, priv_->volume_buffer);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
+                     vertices.data(), GL_STATIC_DRAW);
+        GLint volume_position = priv_->light_program["position"].location();
+        glVertexAttribPointer(volume_position, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        glEnableVertexAttribArray(volume_position);
+
+        glGenBuffers(1, &priv_->volume_index_buffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, priv_->volume_index_buffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort),
+                     indices.data(), GL_STATIC_DRAW);
+
+        /* The per-light data, updated every frame */
+        GLint light_position = priv_->light_program["light_position"].location();
+        GLint light_color = priv_->light_program["light_color"].location();
+        glGenBuffers(1, &priv_->instance_buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, priv_->instance_buffer);
+        glBufferData(GL_ARRAY_BUFFER, priv_->light_data.size() * sizeof(LibMatrix::vec4),
+                     0, GL_STREAM_DRAW);
+        glVertexAttribPointer(light_position, 4, GL_FLOAT, GL_FALSE,
+                              2 * sizeof(LibMatrix::vec4), 0);
+        glVertexAttribPointer(light_color, 4, GL_FLOAT, GL_FALSE,
+                              2 * sizeof(LibMatrix::vec4),
+                              reinterpret_cast<const void *>(sizeof(LibMatrix::vec4)));
+        glEnableVertexAttribArray(light_position);
+        glEnableVertexAttribArray(light_color);
+        GLExtensions::VertexAttribDivisor(light_position, 1);
+        GLExtensions::VertexAttribDivisor(light_color, 1);
+
+        priv_->light_program["ProjectionMatrix"] = priv_->projection;
+    }
+
+    GLExtensions::BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    priv_->cpu_time_ns = 0;
+
+    return true;
+}
+
+void
+SceneDeferred::teardown()
+{
+    double elapsed = realTime_.elapsed();
+    if (elapsed > 0.0 && currentFrame_ > 0) {
+        /* The frame time divided among the lights */
+        add_metric("LightTime", "light_time",
+                   1000000.0 * elapsed / (currentFrame_ * priv_->lights.size()),
+                   "us", 3);
+        add_metric("LightUpdate", "light_update",
+                   priv_->cpu_time_ns / (1000000.0 * currentFrame_), "ms", 3);
+    }
+
+    for (unsigned int i = 0; i < 6; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    GLExtensions::BindVertexArray(0);
+    GLuint vaos[] = {priv_->floor_vao, priv_->quad_vao, priv_->volume_vao};
+    for (GLuint vao : vaos) {
+        if (vao)
+            GLExtensions::DeleteVertexArrays(1, &vao);
+    }
+    priv_->floor_vao = priv_->quad_vao = priv_->volume_vao = 0;
+
+    GLuint buffers[] = {priv_->floor_buffer, priv_->quad_buffer, priv_->volume_buffer,
+                        priv_->volume_index_buffer, priv_->instance_buffer};
+    for (GLuint buffer : buffers) {
+        if (buffer)
+            glDeleteBuffers(1, &buffer);
+    }
+    priv_->floor_buffer = priv_->quad_buffer = priv_->volume_buffer = 0;
+    priv_->volume_index_buffer = priv_->instance_buffer = 0;
+
+    if (priv_->fbo) {
+        GLExtensions::DeleteFramebuffers(1, &priv_->fbo);
+        priv_->fbo = 0;
+    }
+
+    GLuint textures[] = {priv_->albedo_texture, priv_->normal_texture,
+                         priv_->depth_texture, priv_->light_texture,
+                         priv_->header_texture, priv_->index_texture};
+    for (GLuint texture : textures) {
+        if (texture)
+            glDeleteTextures(1, &texture);
+    }
+    priv_->albedo_texture = priv_->normal_texture = priv_->depth_texture = 0;
+    priv_->light_texture = priv_->header_texture = priv_->index_texture = 0;
+
+    Program *programs[] = {&priv_->gbuffer_program, &priv_->ambient_program,
+                           &priv_->light_program};
+    for (Program *program : programs) {
+        program->stop();
+        program->release();
+    }
+
+    priv_->mesh.reset();
+    priv_->lights.clear();
+    priv_->light_data.clear();
+    priv_->tile_headers.clear();
+    priv_->tile_indices.clear();
+
+    Scene::teardown();
+}
+
+void
+SceneDeferred::draw()
+{
+    float time = realTime_.elapsed();
+
+    /* Orbit slowly around the scene */
+    float angle = 0.2f * time;
+    LibMatrix::mat4 view(LibMatrix::Mat4::lookAt(4.5f * std::sin(angle), 2.5f,
+                                                 4.5f * std::cos(angle),
+                                                 0.0f, 0.4f, 0.0f,
+                                                 0.0f, 1.0f, 0.0f));
+
+    /* Fill the G-buffer */
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, priv_->fbo);
+    glViewport(0, 0, priv_->width, priv_->height);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+
+    Program &gbuffer = priv_->gbuffer_program;
+    gbuffer.start();
+
+    LibMatrix::mat4 floor_mvp(priv_->projection);
+    floor_mvp *= view;
+    LibMatrix::mat4 floor_normal(view);
+    floor_normal.inverse().transpose();
+    gbuffer["ModelViewProjectionMatrix"] = floor_mvp;
+    gbuffer["NormalMatrix"] = floor_normal;
+    gbuffer["ModelMatrix"] = LibMatrix::mat4();
+    gbuffer["MaterialColor"] = LibMatrix::vec4(0.8f, 0.8f, 0.8f, 0.3f);
+    gbuffer["Checker"] = 1.0f;
+    GLExtensions::BindVertexArray(priv_->floor_vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    GLExtensions::BindVertexArray(0);
+
+    LibMatrix::mat4 model_view(view);
+    model_view *= priv_->model_matrix;
+    LibMatrix::mat4 model_mvp(priv_->projection);
+    model_mvp *= model_view;
+    LibMatrix::mat4 model_normal(model_view);
+    model_normal.inverse().transpose();
+    gbuffer["ModelViewProjectionMatrix"] = model_mvp;
+    gbuffer["NormalMatrix"] = model_normal;
+    gbuffer["ModelMatrix"] = priv_->model_matrix;
+    gbuffer["MaterialColor"] = LibMatrix::vec4(0.9f, 0.85f, 0.7f, 1.0f);
+    gbuffer["Checker"] = 0.0f;
+    priv_->mesh.render_vbo();
+
+    glDisable(GL_DEPTH_TEST);
+
+    /* Light the canvas: an ambient pass, then the accumulated lights */
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+    glViewport(0, 0, priv_->width, priv_->height);
+
+    GLuint gbuffer_textures[] = {priv_->albedo_texture, priv_->normal_texture,
+                                 priv_->depth_texture};
+    for (unsigned int i = 0; i < 3; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, gbuffer_textures[i]);
+    }
+
+    priv_->ambient_program.start();
+    GLExtensions::BindVertexArray(priv_->quad_vao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    uint64_t start_ns = Util::get_thread_cpu_time_ns();
+
+    priv_->update_lights(view, time);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    priv_->light_program.start();
+
+    if (priv_->method == SceneDeferredPrivate::MethodTiled) {
+        priv_->build_tiles();
+
+        unsigned int data_width = SceneDeferredPrivate::data_width;
+        unsigned int light_rows = priv_->light_data.size() / data_width;
+        unsigned int index_rows = priv_->tile_indices.size() / (4 * data_width);
+
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, priv_->light_texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, data_width, light_rows,
+                        GL_RGBA, GL_FLOAT, priv_->light_data.data());
+
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, priv_->header_texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, priv_->tiles_x, priv_->tiles_y,
+                        GL_RGBA, GL_FLOAT, priv_->tile_headers.data());
+
+        /* The lists vary in size, so only grow their texture when needed */
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_2D, priv_->index_texture);
+        if (index_rows > priv_->index_rows) {
+            priv_->index_rows = index_rows;
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, data_width, index_rows, 0,
+                         GL_RGBA, GL_FLOAT, priv_->tile_indices.data());
+        }
+        else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, data_width, index_rows,
+                            GL_RGBA, GL_FLOAT, priv_->tile_indices.data());
+        }
+
+        priv_->cpu_time_ns += Util::get_thread_cpu_time_ns() - start_ns;
+
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+    else {
+        glBindBuffer(GL_ARRAY_BUFFER, priv_->instance_buffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0,
+                        priv_->light_data.size() * sizeof(LibMatrix::vec4),
+                        priv_->light_data.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        priv_->cpu_time_ns += Util::get_thread_cpu_time_ns() - start_ns;
+
+        /*
+         * Draw the back faces of the volumes, so that each lit pixel is
+         * shaded once per light even when the camera is inside a volume.
+         */
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_FRONT);
+        GLExtensions::BindVertexArray(priv_->volume_vao);
+        GLExtensions::DrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, 0,
+                                            priv_->lights.size());
+        glCullFace(GL_BACK);
+        glDisable(GL_CULL_FACE);
+    }
+
+    GLExtensions::BindVertexArray(0);
+    glDisable(GL_BLEND);
+    glActiveTexture(GL_TEXTURE0);
+}
@@ -386,8 +386,9 @@ protected:
         program.stop();
     }
 
-    static Program main_program;
-    static GLuint quad_vbo_;
+    /* Per thread, since each thread renders with its own context */
+    static thread_local Program main_program;
+    static thread_local GLuint quad_vbo_;
 
     LibMatrix::vec2 pos_;
     LibMatrix::vec2 size_;
@@ -408,13 +409,13 @@ private:
 
     float rotation_rad_;
     bool texture_contents_invalid_;
-    static int use_count;
+    static thread_local int use_count;
 
 };
 
-int RenderObject::use_count = 0;
-Program RenderObject::main_program;
-GLuint RenderObject::quad_vbo_ = 0;
+thread_local int RenderObject::use_count = 0;
+thread_local Program RenderObject::main_program;
+thread_local GLuint RenderObject::quad_vbo_ = 0;
 
 /**
  * A RenderObject representing the screen.
@@ -668,8 +669,8 @@ private:
     bool separable_;
     bool draw_contents_;
 
-    static int use_count;
-    static RenderClearImage window_contents_;
+    static thread_local int use_count;
+    static thread_local RenderClearImage window_contents_;
 
 };
 
@@ -792,21 +793,21 @@ private:
     unsigned int shadow_size_;
     bool draw_contents_;
 
-    static int use_count;
-    static RenderClearImage window_contents_;
-    static RenderClearImage shadow_h_;
-    static RenderClearImage shadow_v_;
-    static RenderClearImage shadow_corner_;
+    static thread_local int use_count;
+    static thread_local RenderClearImage window_contents_;
+    static thread_local RenderClearImage shadow_h_;
+    static thread_local RenderClearImage shadow_v_;
+    static thread_local RenderClearImage shadow_corner_;
 
 };
 
-int RenderWindowBlur::use_count = 0;
-RenderClearImage RenderWindowBlur::window_contents_("desktop-window");
-int RenderWindowShadow::use_count = 0;
-RenderClearImage RenderWindowShadow::window_contents_("desktop-window");
-RenderClearImage RenderWindowShadow::shadow_h_("desktop-shadow");
-RenderClearImage RenderWindowShadow::shadow_v_("desktop-shadow");
-RenderClearImage RenderWindowShadow::shadow_corner_("desktop-shadow-corner");
+thread_local int RenderWindowBlur::use_count = 0;
+thread_local RenderClearImage RenderWindowBlur::window_contents_("desktop-window");
+thread_local int RenderWindowShadow::use_count = 0;
+thread_local RenderClearImage RenderWindowShadow::window_contents_("desktop-window");
+thread_local RenderClearImage RenderWindowShadow::shadow_h_("desktop-shadow");
+thread_local RenderClearImage RenderWindowShadow::shadow_v_("desktop-shadow");
+thread_local RenderClearImage RenderWindowShadow::shadow_corner_("desktop-shadow-corner");
 
 /*******************************
  * SceneDesktop implementation *
@@ -856,6 +857,17 @@ SceneDesktop::~SceneDesktop()
     delete priv_;
 }
 
+void
+SceneDesktop::assets(const std::map<std::string, std::string> &values,
+                      Assets &assets) const
+{
+    assets.textures.push_back("desktop-window");
+    if (values.at("effect") == "shadow") {
+        assets.textures.push_back("desktop-shadow");
+        assets.textures.push_back("desktop-shadow-corner");
+    }
+}
+
 bool
 SceneDesktop::supported(bool show_errors)
 {
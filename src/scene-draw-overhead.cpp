@@ -0,0 +1,318 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "mesh.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <cmath>
+#include <vector>
+
+struct SceneDrawOverheadPrivate
+{
+    enum Change {
+        ChangeNone,
+        ChangeProgram,
+        ChangeTexture,
+        ChangeUniform,
+        ChangeVBO,
+        ChangeState,
+    };
+
+    /* The number of distinct objects that each state change alternates between */
+    static const unsigned int num_programs = 2;
+    static const unsigned int num_textures = 4;
+    static const unsigned int num_vbos = 2;
+
+    SceneDrawOverheadPrivate() :
+        change(ChangeNone), draws(0), position_location(-1),
+        color_location(-1), total_draws(0), submit_time_us(0),
+        cpu_time_ns(0)
+    {
+        for (GLuint &t : textures)
+            t = 0;
+        for (GLuint &v : vbos)
+            v = 0;
+    }
+
+    static void change_program(size_t range, void *data)
+    {
+        SceneDrawOverheadPrivate *priv = static_cast<SceneDrawOverheadPrivate *>(data);
+        priv->programs[range % num_programs].start();
+    }
+
+    static void change_texture(size_t range, void *data)
+    {
+        SceneDrawOverheadPrivate *priv = static_cast<SceneDrawOverheadPrivate *>(data);
+        glBindTexture(GL_TEXTURE_2D, priv->textures[range % num_textures]);
+    }
+
+    static void change_uniform(size_t range, void *data)
+    {
+        SceneDrawOverheadPrivate *priv = static_cast<SceneDrawOverheadPrivate *>(data);
+        float f = (range & 0xff) / 255.0f;
+        glUniform4f(priv->color_location, f, 1.0f - f, 0.5f, 1.0f);
+    }
+
+    static void change_vbo(size_t range, void *data)
+    {
+        SceneDrawOverheadPrivate *priv = static_cast<SceneDrawOverheadPrivate *>(data);
+        glBindBuffer(GL_ARRAY_BUFFER, priv->vbos[range % num_vbos]);
+        glVertexAttribPointer(priv->position_location, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    }
+
+    static void change_state(size_t range, void *data)
+    {
+        (void)data;
+        if (range & 1) {
+            glEnable(GL_BLEND);
+            glEnable(GL_DEPTH_TEST);
+        }
+        else {
+            glDisable(GL_BLEND);
+            glDisable(GL_DEPTH_TEST);
+        }
+    }
+
+    Mesh::range_setup_func change_func()
+    {
+        switch (change) {
+            case ChangeProgram: return change_program;
+            case ChangeTexture: return change_texture;
+            case ChangeUniform: return change_uniform;
+            case ChangeVBO: return change_vbo;
+            case ChangeState: return change_state;
+            default: return 0;
+        }
+    }
+
+    Change change;
+    unsigned int draws;
+    Program programs[num_programs];
+    Mesh mesh;
+    GLuint textures[num_textures];
+    GLuint vbos[num_vbos];
+    GLint position_location;
+    GLint color_location;
+    uint64_t total_draws;
+    uint64_t submit_time_us;
+    uint64_t cpu_time_ns;
+};
+
+SceneDrawOverhead::SceneDrawOverhead(Canvas &pCanvas) :
+    Scene(pCanvas, "draw-overhead")
+{
+    priv_ = new SceneDrawOverheadPrivate();
+    options_["change"] = Scene::Option("change", "none",
+                                       "The state to change between draw calls",
+                                       "none,program,texture,uniform,vbo,state");
+    options_["draws"] = Scene::Option("draws", "1000",
+                                      "The number of draw calls per frame");
+}
+
+SceneDrawOverhead::~SceneDrawOverhead()
+{
+    delete priv_;
+}
+
+bool
+SceneDrawOverhead::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    static const std::string change_names[] = {
+        "none", "program", "texture", "uniform", "vbo", "state"
+    };
+    priv_->change = SceneDrawOverheadPrivate::ChangeNone;
+    for (unsigned int i = 0; i < sizeof(change_names) / sizeof(*change_names); i++) {
+        if (options_["change"].value == change_names[i])
+            priv_->change = static_cast<SceneDrawOverheadPrivate::Change>(i);
+    }
+
+    priv_->draws = Util::fromString<unsigned int>(options_["draws"].value);
+    if (priv_->draws == 0) {
+        Log::error("The number of draws must be positive\n");
+        return false;
+    }
+
+    /* Identical programs, so that only the switch itself is measured */
+    ShaderSource vtx_source(Options::data_path + "/shaders/draw-overhead.vert");
+    ShaderSource frg_source(Options::data_path + "/shaders/draw-overhead.frag");
+
+    for (Program &program : priv_->programs) {
+        if (!Scene::load_shaders_from_strings(program, vtx_source.str(),
+                                              frg_source.str()))
+        {
+            return false;
+        }
+        program.start();
+        program["Texture0"] = 0;
+        program["Color"] = LibMatrix::vec4(1.0f);
+    }
+
+    priv_->position_location = priv_->programs[0]["position"].location();
+    priv_->color_location = priv_->programs[0]["Color"].location();
+    if (priv_->programs[1]["position"].location() != priv_->position_location) {
+        Log::error("The draw-overhead programs have different attribute locations\n");
+        return false;
+    }
+
+    /* Small textures with different colors */
+    glGenTextures(SceneDrawOverheadPrivate::num_textures, priv_->textures);
+    for (unsigned int i = 0; i < SceneDrawOverheadPrivate::num_textures; i++) {
+        uint8_t pixels[4 * 4 * 4];
+        for (unsigned int p = 0; p < 16; p++) {
+            pixels[4 * p + 0] = (i & 1) ? 0xff : 0x80;
+            pixels[4 * p + 1] = (i & 2) ? 0xff : 0x80;
+            pixels[4 * p + 2] = ((p + p / 4) & 1) ? 0xff : 0xc0;
+            pixels[4 * p + 3] = 0xff;
+        }
+        glBindTexture(GL_TEXTURE_2D, priv_->textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 4, 4, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, pixels);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, priv_->textures[0]);
+
+    /* One small triangle per draw call, in a grid that covers the canvas */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);     // Position
+    priv_->mesh.set_vertex_format(vertex_format);
+
+    unsigned int n_x = static_cast<unsigned int>(std::ceil(std::sqrt(priv_->draws)));
+    unsigned int n_y = (priv_->draws + n_x - 1) / n_x;
+    float cell_w = 2.0f / n_x;
+    float cell_h = 2.0f / n_y;
+    std::vector<float> positions;
+
+    for (unsigned int i = 0; i < priv_->draws; i++) {
+        float x = -1.0f + (i % n_x + 0.3f) * cell_w;
+        float y = -1.0f + (i / n_x + 0.3f) * cell_h;
+        LibMatrix::vec3 pos[3] = {
+            LibMatrix::vec3(x, y, 0.0f),
+            LibMatrix::vec3(x + 0.4f * cell_w, y, 0.0f),
+            LibMatrix::vec3(x, y + 0.4f * cell_h, 0.0f),
+        };
+
+        for (const LibMatrix::vec3 &p : pos) {
+            const float *f = p;
+            priv_->mesh.next_vertex();
+            priv_->mesh.set_attrib(0, p);
+            positions.insert(positions.end(), f, f + 3);
+        }
+    }
+
+    priv_->mesh.build_vbo();
+
+    std::vector<GLint> attrib_locations;
+    attrib_locations.push_back(priv_->position_location);
+    priv_->mesh.set_attrib_locations(attrib_locations);
+
+    /* Copies of the vertex data, for switching between buffers */
+    if (priv_->change == SceneDrawOverheadPrivate::ChangeVBO) {
+        glGenBuffers(SceneDrawOverheadPrivate::num_vbos, priv_->vbos);
+        for (GLuint vbo : priv_->vbos) {
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float),
+                         positions.data(), GL_STATIC_DRAW);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    priv_->programs[0].start();
+
+    priv_->total_draws = 0;
+    priv_->submit_time_us = 0;
+    priv_->cpu_time_ns = 0;
+
+    return true;
+}
+
+void
+SceneDrawOverhead::teardown()
+{
+    if (priv_->total_draws > 0) {
+        if (priv_->submit_time_us > 0) {
+            add_metric("DrawRate", "draw_rate",
+                       static_cast<double>(priv_->total_draws) / priv_->submit_time_us,
+                       "M/s");
+        }
+        add_metric("CallTime", "call_time",
+                   static_cast<double>(priv_->cpu_time_ns) / priv_->total_draws,
+                   "ns", 1);
+    }
+
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+
+    priv_->mesh.reset();
+
+    if (priv_->vbos[0]) {
+        glDeleteBuffers(SceneDrawOverheadPrivate::num_vbos, priv_->vbos);
+        for (GLuint &v : priv_->vbos)
+            v = 0;
+    }
+
+    if (priv_->textures[0]) {
+        glDeleteTextures(SceneDrawOverheadPrivate::num_textures, priv_->textures);
+        for (GLuint &t : priv_->textures)
+            t = 0;
+    }
+
+    for (Program &program : priv_->programs) {
+        program.stop();
+        program.release();
+    }
+
+    Scene::teardown();
+}
+
+void
+SceneDrawOverhead::draw()
+{
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    /*
+     * Time only the submission of the draw calls: the wall clock time gives
+     * the draw rate, and the CPU time of this thread the cost per call,
+     * excluding any time spent waiting for the driver.
+     */
+    uint64_t start_us = Util::get_timestamp_us();
+    uint64_t start_ns = Util::get_thread_cpu_time_ns();
+
+    priv_->mesh.render_vbo(3, priv_->change_func(), priv_);
+
+    priv_->cpu_time_ns += Util::get_thread_cpu_time_ns() - start_ns;
+    priv_->submit_time_us += Util::get_timestamp_us() - start_us;
+    priv_->total_draws += priv_->draws;
+
+    /* Restore the state for the next frame */
+    if (priv_->change == SceneDrawOverheadPrivate::ChangeProgram)
+        priv_->programs[0].start();
+    else if (priv_->change == SceneDrawOverheadPrivate::ChangeUniform)
+        glUniform4f(priv_->color_location, 1.0f, 1.0f, 1.0f, 1.0f);
+}
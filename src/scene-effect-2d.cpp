@@ -50,6 +50,14 @@ SceneEffect2D::~SceneEffect2D()
 {
 }
 
+void
+SceneEffect2D::assets(const std::map<std::string, std::string> &values,
+                       Assets &assets) const
+{
+    (void)values;
+    assets.textures.push_back("effect-2d");
+}
+
 /*
  * Calculates the offset of the coefficient with index i
  * from the center of the kernel matrix. Note that we are
@@ -181,6 +181,14 @@ Lamp::init()
         Log::error("No valid program for lit lamp rendering\n");
         return;
     }
+    litVertexIndex_ = litProgram_[vertexAttribName_].location();
+    litNormalIndex_ = litProgram_[normalAttribName_].location();
+    litNormalMatrixHandle_ = litProgram_.symbolHandle(normalMatrixName_);
+    litModelviewHandle_ = litProgram_.symbolHandle(modelviewName_);
+    litProjectionHandle_ = litProgram_.symbolHandle(projectionName_);
+    litLightPositionHandles_[0] = litProgram_.symbolHandle(light0PositionName_);
+    litLightPositionHandles_[1] = litProgram_.symbolHandle(light1PositionName_);
+    litLightPositionHandles_[2] = litProgram_.symbolHandle(light2PositionName_);
 
     // The simple program with no lighting...
     string unlit_vtx_filename(Options::data_path + "/shaders/ideas-lamp-unlit.vert");
@@ -193,6 +201,9 @@ Lamp::init()
         Log::error("No valid program for unlit lamp rendering.\n");
         return;
     }
+    unlitVertexIndex_ = unlitProgram_[vertexAttribName_].location();
+    unlitModelviewHandle_ = unlitProgram_.symbolHandle(modelviewName_);
+    unlitProjectionHandle_ = unlitProgram_.symbolHandle(projectionName_);
 
     // We need 2 buffers for our work here.  One for the vertex data.
     // and one for the index data.
@@ -218,8 +229,8 @@ Lamp::draw(Stack4& modelview, Stack4& projection, const vec4* lightPositions)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferObjects_[1]);
 
     litProgram_.start();
-    int vertexIndex(litProgram_[vertexAttribName_].location());
-    int normalIndex(litProgram_[normalAttribName_].location());
+    int vertexIndex(litVertexIndex_);
+    int normalIndex(litNormalIndex_);
     glVertexAttribPointer(vertexIndex, 3, GL_FLOAT, GL_FALSE, 0, 0);
     glVertexAttribPointer(normalIndex, 3, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(vertexIndex);
@@ -229,12 +240,12 @@ Lamp::draw(Stack4& modelview, Stack4& projection, const vec4* lightPositions)
                                  mv[0][1], mv[1][1], mv[2][1],
                                  mv[0][2], mv[1][2], mv[2][2]);
     normalMatrix.transpose().inverse();
-    litProgram_[normalMatrixName_] = normalMatrix;
-    litProgram_[modelviewName_] = mv;
-    litProgram_[projectionName_] = projection.getCurrent();
-    litProgram_[light0PositionName_] = lightPositions[0];
-    litProgram_[light1PositionName_] = lightPositions[1];
-    litProgram_[light2PositionName_] = lightPositions[2];
+    litProgram_[litNormalMatrixHandle_] = normalMatrix;
+    litProgram_[litModelviewHandle_] = mv;
+    litProgram_[litProjectionHandle_] = projection.getCurrent();
+    litProgram_[litLightPositionHandles_[0]] = lightPositions[0];
+    litProgram_[litLightPositionHandles_[1]] = lightPositions[1];
+    litProgram_[litLightPositionHandles_[2]] = lightPositions[2];
     static const unsigned int sus(sizeof(unsigned short));
     for (unsigned int i = 0; i < 5; i++)
     {
@@ -245,11 +256,11 @@ Lamp::draw(Stack4& modelview, Stack4& projection, const vec4* lightPositions)
     litProgram_.stop();
 
     unlitProgram_.start();
-    vertexIndex = unlitProgram_[vertexAttribName_].location();
+    vertexIndex = unlitVertexIndex_;
     glVertexAttribPointer(vertexIndex, 3, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(vertexIndex);
-    unlitProgram_[modelviewName_] = mv;
-    unlitProgram_[projectionName_] = projection.getCurrent();
+    unlitProgram_[unlitModelviewHandle_] = mv;
+    unlitProgram_[unlitProjectionHandle_] = projection.getCurrent();
     glDrawElements(GL_TRIANGLE_FAN, 12, GL_UNSIGNED_SHORT, reinterpret_cast<const GLvoid*>(5 * 26 * sus));
     glDisableVertexAttribArray(vertexIndex);
     unlitProgram_.stop();
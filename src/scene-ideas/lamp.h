@@ -43,6 +43,15 @@ public:
 private:    
     Program litProgram_;
     Program unlitProgram_;
+    Program::SymbolHandle litNormalMatrixHandle_;
+    Program::SymbolHandle litModelviewHandle_;
+    Program::SymbolHandle litProjectionHandle_;
+    Program::SymbolHandle litLightPositionHandles_[3];
+    Program::SymbolHandle unlitModelviewHandle_;
+    Program::SymbolHandle unlitProjectionHandle_;
+    int litVertexIndex_;
+    int litNormalIndex_;
+    int unlitVertexIndex_;
     std::string litVertexShader_;
     std::string litFragmentShader_;
     std::string unlitVertexShader_;
@@ -437,6 +437,10 @@ SGILogo::init()
     }
     normalVertexIndex_ = normalProgram_[vertexAttribName_].location();
     normalNormalIndex_ = normalProgram_[normalAttribName_].location();
+    normalHandles_.modelview = normalProgram_.symbolHandle(modelviewName_);
+    normalHandles_.projection = normalProgram_.symbolHandle(projectionName_);
+    normalHandles_.normalMatrix = normalProgram_.symbolHandle(normalMatrixName_);
+    normalHandles_.lightPosition = normalProgram_.symbolHandle(lightPositionName_);
 
     // The program for handling the flat object...
     string logo_flat_vtx_filename(Options::data_path + "/shaders/ideas-logo-flat.vert");
@@ -450,6 +454,9 @@ SGILogo::init()
         return;
     }
     flatVertexIndex_ = flatProgram_[vertexAttribName_].location();
+    flatHandles_.modelview = flatProgram_.symbolHandle(modelviewName_);
+    flatHandles_.projection = flatProgram_.symbolHandle(projectionName_);
+    flatHandles_.logoColor = flatProgram_.symbolHandle(logoColorName_);
 
     // The program for handling the shadow object with texturing...
     string logo_shadow_vtx_filename(Options::data_path + "/shaders/ideas-logo-shadow.vert");
@@ -463,6 +470,9 @@ SGILogo::init()
         return;
     }
     shadowVertexIndex_ = shadowProgram_[vertexAttribName_].location();
+    shadowHandles_.modelview = shadowProgram_.symbolHandle(modelviewName_);
+    shadowHandles_.projection = shadowProgram_.symbolHandle(projectionName_);
+    shadowHandles_.tex = shadowProgram_.symbolHandle("tex");
 
     // We need 2 buffers for our work here.  One for the vertex data.
     // and one for the index data.
@@ -606,7 +616,7 @@ SGILogo::drawElbow(void)
 // GLSL ES, for example), we'll generate it here, and load it as a
 // uniform.
 void
-SGILogo::updateXform(const mat4& mv, Program& program)
+SGILogo::updateXform(const mat4& mv, Program& program, const UniformHandles& handles)
 {
     if (drawStyle_ == LOGO_NORMAL)
     {
@@ -614,9 +624,9 @@ SGILogo::updateXform(const mat4& mv, Program& program)
                                      mv[0][1], mv[1][1], mv[2][1],
                                      mv[0][2], mv[1][2], mv[2][2]);
         normalMatrix.transpose().inverse();
-        program[normalMatrixName_] = normalMatrix;
+        program[handles.normalMatrix] = normalMatrix;
     }
-    program[modelviewName_] = mv;
+    program[handles.modelview] = mv;
 }
 
 Program&
@@ -635,6 +645,22 @@ SGILogo::getProgram()
     return normalProgram_;
 }
 
+const SGILogo::UniformHandles&
+SGILogo::getHandles() const
+{
+    switch (drawStyle_)
+    {
+        case LOGO_NORMAL:
+            return normalHandles_;
+        case LOGO_FLAT:
+            return flatHandles_;
+        case LOGO_SHADOW:
+            return shadowHandles_;
+    }
+
+    return normalHandles_;
+}
+
 void
 SGILogo::draw(Stack4& modelview, 
     Stack4& projection, 
@@ -654,136 +680,137 @@ SGILogo::draw(Stack4& modelview,
     drawStyle_ = style;
     vec4 logoColor(currentColor.x() / 255.0, currentColor.y() / 255.0, currentColor.z() / 255.0, 1.0);
     Program& curProgram = getProgram();
+    const UniformHandles& handles = getHandles();
     curProgram.start();
     switch (drawStyle_)
     {
         case LOGO_NORMAL:
-            curProgram[lightPositionName_] = lightPosition;
+            curProgram[handles.lightPosition] = lightPosition;
             vertexIndex_ = normalVertexIndex_;
             glEnableVertexAttribArray(normalNormalIndex_);
             break;
         case LOGO_FLAT:
-            curProgram[logoColorName_] = logoColor;
+            curProgram[handles.logoColor] = logoColor;
             vertexIndex_ = flatVertexIndex_;
             break;
         case LOGO_SHADOW:
             vertexIndex_ = shadowVertexIndex_;
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_2D, textureName_);
-            curProgram["tex"] = 0;
+            curProgram[handles.tex] = 0;
             break;            
     }
 
     glEnableVertexAttribArray(vertexIndex_);
-    curProgram[projectionName_] = projection.getCurrent();
+    curProgram[handles.projection] = projection.getCurrent();
     modelview.translate(5.500000, -3.500000, 4.500000);
     modelview.translate(0.0,  0.0,  -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -5.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawSingleCylinder();
     bendRight(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -5.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawSingleCylinder();
     bendLeft(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -5.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawSingleCylinder();
     bendRight(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -5.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawSingleCylinder();
     bendLeft(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -5.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawSingleCylinder();
     bendRight(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -7.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawDoubleCylinder();
     bendForward(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     modelview.translate(0.0, 0.0, -5.000000);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawSingleCylinder();
     bendLeft(modelview);
-    updateXform(modelview.getCurrent(), curProgram);
+    updateXform(modelview.getCurrent(), curProgram, handles);
     drawElbow();
     glDisableVertexAttribArray(vertexIndex_);
     switch (drawStyle_)
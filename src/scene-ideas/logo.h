@@ -61,8 +61,21 @@ private:
     void bendLeft(LibMatrix::Stack4& ms);
     void bendRight(LibMatrix::Stack4& ms);
     void bendForward(LibMatrix::Stack4& ms);
-    void updateXform(const LibMatrix::mat4& mv, Program& program);
+    // The uniforms loaded by each program; the ones that a program
+    // doesn't use are left unset.
+    struct UniformHandles
+    {
+        Program::SymbolHandle modelview;
+        Program::SymbolHandle projection;
+        Program::SymbolHandle normalMatrix;
+        Program::SymbolHandle lightPosition;
+        Program::SymbolHandle logoColor;
+        Program::SymbolHandle tex;
+    };
+    void updateXform(const LibMatrix::mat4& mv, Program& program,
+                     const UniformHandles& handles);
     Program& getProgram();
+    const UniformHandles& getHandles() const;
     LibMatrix::vec3 currentPosition_;
     std::vector<LibMatrix::vec3> singleCylinderVertices_;
     std::vector<LibMatrix::vec3> singleCylinderNormals_;
@@ -96,6 +109,9 @@ private:
     Program normalProgram_;
     Program flatProgram_;
     Program shadowProgram_;
+    UniformHandles normalHandles_;
+    UniformHandles flatHandles_;
+    UniformHandles shadowHandles_;
     std::string normalVertexShader_;
     std::string normalFragmentShader_;
     std::string flatVertexShader_;
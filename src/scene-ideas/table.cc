@@ -113,6 +113,11 @@ Table::init(void)
         return;
     }
     tableVertexIndex_ = tableProgram_[vertexAttribName_].location();
+    tableHandles_.modelview = tableProgram_.symbolHandle(modelviewName_);
+    tableHandles_.projection = tableProgram_.symbolHandle(projectionName_);
+    tableHandles_.lightPosition = tableProgram_.symbolHandle(lightPositionName_);
+    tableHandles_.logoDirection = tableProgram_.symbolHandle(logoDirectionName_);
+    tableHandles_.curTime = tableProgram_.symbolHandle(curTimeName_);
 
     // Program to render the paper with lighting and a time-based fade...
     string paper_vtx_filename(Options::data_path + "/shaders/ideas-paper.vert");
@@ -126,6 +131,11 @@ Table::init(void)
         return;
     }
     paperVertexIndex_ = paperProgram_[vertexAttribName_].location();
+    paperHandles_.modelview = paperProgram_.symbolHandle(modelviewName_);
+    paperHandles_.projection = paperProgram_.symbolHandle(projectionName_);
+    paperHandles_.lightPosition = paperProgram_.symbolHandle(lightPositionName_);
+    paperHandles_.logoDirection = paperProgram_.symbolHandle(logoDirectionName_);
+    paperHandles_.curTime = paperProgram_.symbolHandle(curTimeName_);
 
     // Program to handle the text (time-based color fade)...
     string text_vtx_filename(Options::data_path + "/shaders/ideas-text.vert");
@@ -139,6 +149,9 @@ Table::init(void)
         return;
     }
     textVertexIndex_ = textProgram_[vertexAttribName_].location();
+    textHandles_.modelview = textProgram_.symbolHandle(modelviewName_);
+    textHandles_.projection = textProgram_.symbolHandle(projectionName_);
+    textHandles_.curTime = textProgram_.symbolHandle(curTimeName_);
 
     // Program for the drawUnder functionality (just paint it black)...
     string under_table_vtx_filename(Options::data_path + "/shaders/ideas-under-table.vert");
@@ -152,6 +165,8 @@ Table::init(void)
         return;
     }
     underVertexIndex_ = underProgram_[vertexAttribName_].location();
+    underHandles_.modelview = underProgram_.symbolHandle(modelviewName_);
+    underHandles_.projection = underProgram_.symbolHandle(projectionName_);
 
     // Tell all of the characters to initialize themselves...
     i_.init(textVertexIndex_);
@@ -228,11 +243,11 @@ Table::draw(Stack4& modelview,
 
     // Draw the table top
     tableProgram_.start();
-    tableProgram_[projectionName_] = projection.getCurrent();
-    tableProgram_[modelviewName_] = modelview.getCurrent();
-    tableProgram_[lightPositionName_] = lightPos;
-    tableProgram_[logoDirectionName_] = logoDirection;
-    tableProgram_[curTimeName_] = currentTime;
+    tableProgram_[tableHandles_.projection] = projection.getCurrent();
+    tableProgram_[tableHandles_.modelview] = modelview.getCurrent();
+    tableProgram_[tableHandles_.lightPosition] = lightPos;
+    tableProgram_[tableHandles_.logoDirection] = logoDirection;
+    tableProgram_[tableHandles_.curTime] = currentTime;
     glVertexAttribPointer(tableVertexIndex_, 3, GL_FLOAT, GL_FALSE, 0,
         reinterpret_cast<const GLvoid*>(dataMap_.tvOffset));
     glEnableVertexAttribArray(tableVertexIndex_);
@@ -252,11 +267,11 @@ Table::draw(Stack4& modelview,
 
     // Draw the paper lying on the table top
     paperProgram_.start();
-    paperProgram_[projectionName_] = projection.getCurrent();
-    paperProgram_[modelviewName_] = modelview.getCurrent();
-    paperProgram_[lightPositionName_] = lightPos;
-    paperProgram_[logoDirectionName_] = logoDirection;
-    paperProgram_[curTimeName_] = currentTime;
+    paperProgram_[paperHandles_.projection] = projection.getCurrent();
+    paperProgram_[paperHandles_.modelview] = modelview.getCurrent();
+    paperProgram_[paperHandles_.lightPosition] = lightPos;
+    paperProgram_[paperHandles_.logoDirection] = logoDirection;
+    paperProgram_[paperHandles_.curTime] = currentTime;
     glVertexAttribPointer(paperVertexIndex_, 3, GL_FLOAT, GL_FALSE, 0,
         reinterpret_cast<const GLvoid*>(dataMap_.pvOffset));
     glEnableVertexAttribArray(paperVertexIndex_);
@@ -279,45 +294,45 @@ Table::draw(Stack4& modelview,
     // Each character has its own array and element buffers, and they have
     // been initialized with the vertex attrib location for this program.
     textProgram_.start();
-    textProgram_[projectionName_] = projection.getCurrent();
-    textProgram_[modelviewName_] = modelview.getCurrent();
-    textProgram_[curTimeName_] = currentTime;
+    textProgram_[textHandles_.projection] = projection.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
+    textProgram_[textHandles_.curTime] = currentTime;
     i_.draw();
     modelview.translate(3.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     d_.draw();
     modelview.translate(6.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     e_.draw();
     modelview.translate(5.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     a_.draw();
     modelview.translate(6.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     s_.draw();
     modelview.translate(10.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     i_.draw();
     modelview.translate(3.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     n_.draw();
     modelview.translate(-31.0, -13.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     m_.draw();
     modelview.translate(10.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     o_.draw();
     modelview.translate(5.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     t_.draw();
     modelview.translate(4.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     i_.draw();
     modelview.translate(3.5, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     o_.draw();
     modelview.translate(5.0, 0.0, 0.0);
-    textProgram_[modelviewName_] = modelview.getCurrent();
+    textProgram_[textHandles_.modelview] = modelview.getCurrent();
     n_.draw();
     textProgram_.stop();
 
@@ -333,8 +348,8 @@ Table::drawUnder(Stack4& modelview, Stack4& projection)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferObjects_[1]);
 
     underProgram_.start();  
-    underProgram_[modelviewName_] = modelview.getCurrent();
-    underProgram_[projectionName_] = projection.getCurrent();
+    underProgram_[underHandles_.modelview] = modelview.getCurrent();
+    underProgram_[underHandles_.projection] = projection.getCurrent();
     glVertexAttribPointer(underVertexIndex_, 3, GL_FLOAT, GL_FALSE, 0,
         reinterpret_cast<const GLvoid*>(dataMap_.tvOffset));
     glEnableVertexAttribArray(underVertexIndex_);
@@ -57,6 +57,20 @@ private:
     Program paperProgram_;
     Program textProgram_;
     Program underProgram_;
+    // The uniforms loaded by each program; the ones that a program
+    // doesn't use are left unset.
+    struct UniformHandles
+    {
+        Program::SymbolHandle modelview;
+        Program::SymbolHandle projection;
+        Program::SymbolHandle lightPosition;
+        Program::SymbolHandle logoDirection;
+        Program::SymbolHandle curTime;
+    };
+    UniformHandles tableHandles_;
+    UniformHandles paperHandles_;
+    UniformHandles textHandles_;
+    UniformHandles underHandles_;
     std::string tableVertexShader_;
     std::string tableFragmentShader_;
     std::string paperVertexShader_;
@@ -0,0 +1,175 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "image-reader.h"
+#include "texture.h"
+#include "log.h"
+#include "util.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+struct SceneImageDecodePrivate
+{
+    SceneImageDecodePrivate() :
+        filetype(TextureDescriptor::FileTypeUnknown), decodes(0),
+        decoded_pixels(0), decode_time(0), failed(false) {}
+
+    std::filesystem::path pathname;
+    TextureDescriptor::FileType filetype;
+    ImageDecodeOptions decode_options;
+    std::vector<unsigned char> pixels;
+    unsigned int decodes;
+    uint64_t decoded_pixels;
+    uint64_t decode_time;
+    bool failed;
+};
+
+SceneImageDecode::SceneImageDecode(Canvas &pCanvas) :
+    Scene(pCanvas, "image-decode")
+{
+    priv_ = new SceneImageDecodePrivate();
+
+    std::string textures;
+    const TextureMap& textureMap = Texture::find_textures();
+    for (auto const& texture : textureMap) {
+        if (!textures.empty())
+            textures += ",";
+        textures += texture.first;
+    }
+
+    options_["image"] = Scene::Option("image", "terrain-grasslight-512",
+                                      "Which image (texture) to decode",
+                                      textures);
+    options_["scale"] = Scene::Option("scale", "1",
+                                      "Decode JPEG images at 1/scale of their size",
+                                      "1,2,4,8");
+    options_["idct"] = Scene::Option("idct", "accurate",
+                                     "The JPEG inverse DCT method",
+                                     "accurate,fast");
+    options_["upsampling"] = Scene::Option("upsampling", "fancy",
+                                           "The JPEG chroma upsampling method",
+                                           "fancy,simple");
+    options_["region"] = Scene::Option("region", "",
+                                       "The region of the (scaled) image to decode"
+                                       " (WxH+X+Y), empty for the whole image");
+}
+
+SceneImageDecode::~SceneImageDecode()
+{
+    delete priv_;
+}
+
+bool
+SceneImageDecode::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    const TextureMap& textureMap = Texture::find_textures();
+    TextureMap::const_iterator it = textureMap.find(options_["image"].value);
+    if (it == textureMap.end()) {
+        Log::error("Unknown image '%s'\n", options_["image"].value.c_str());
+        return false;
+    }
+
+    priv_->pathname = it->second->pathname();
+    priv_->filetype = it->second->filetype();
+
+    ImageDecodeOptions &opts = priv_->decode_options;
+    opts = ImageDecodeOptions();
+    opts.scale_denom = Util::fromString<unsigned int>(options_["scale"].value);
+    opts.fast_idct = options_["idct"].value == "fast";
+    opts.fancy_upsampling = options_["upsampling"].value != "simple";
+
+    const std::string &region = options_["region"].value;
+    if (!region.empty() &&
+        sscanf(region.c_str(), "%ux%u+%u+%u", &opts.region_width,
+               &opts.region_height, &opts.region_x, &opts.region_y) != 4)
+    {
+        Log::error("Invalid decode region '%s', expected WxH+X+Y\n",
+                   region.c_str());
+        return false;
+    }
+
+    priv_->decodes = 0;
+    priv_->decoded_pixels = 0;
+    priv_->decode_time = 0;
+    priv_->failed = false;
+
+    return true;
+}
+
+void
+SceneImageDecode::teardown()
+{
+    if (priv_->decode_time > 0) {
+        add_metric("Decode", "decode_rate",
+                   static_cast<double>(priv_->decoded_pixels) / priv_->decode_time,
+                   "MP/s", 1);
+    }
+    if (priv_->decodes > 0) {
+        add_metric("DecodeTime", "decode_time",
+                   priv_->decode_time / (1000.0 * priv_->decodes), "ms");
+    }
+
+    priv_->pixels.clear();
+    priv_->pixels.shrink_to_fit();
+
+    Scene::teardown();
+}
+
+void
+SceneImageDecode::draw()
+{
+    uint64_t start = Util::get_timestamp_us();
+
+    std::unique_ptr<ImageReader> reader;
+    if (priv_->filetype == TextureDescriptor::FileTypeJPEG)
+        reader.reset(new JPEGReader(priv_->pathname, priv_->decode_options));
+    else
+        reader.reset(new PNGReader(priv_->pathname, priv_->decode_options));
+
+    if (reader->error()) {
+        priv_->failed = true;
+        running_ = false;
+        return;
+    }
+
+    const size_t stride = static_cast<size_t>(reader->width()) * reader->pixelBytes();
+    priv_->pixels.resize(stride * reader->height());
+
+    unsigned char *row = priv_->pixels.data();
+    while (reader->nextRow(row))
+        row += stride;
+
+    priv_->decode_time += Util::get_timestamp_us() - start;
+    priv_->decoded_pixels += static_cast<uint64_t>(reader->width()) * reader->height();
+    priv_->decodes++;
+}
+
+Scene::ValidationResult
+SceneImageDecode::validate()
+{
+    if (priv_->failed)
+        return Scene::ValidationFailure;
+
+    return priv_->decodes > 0 ? Scene::ValidationSuccess : Scene::ValidationUnknown;
+}
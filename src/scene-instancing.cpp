@@ -0,0 +1,501 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+struct SceneInstancingPrivate
+{
+    enum Method {
+        MethodDraws,
+        MethodAttrib,
+        MethodUBO,
+        MethodTexture,
+    };
+
+    /*
+     * The maximum width of the texture holding the instance data, in
+     * texels, and the texels taking a matrix, one for each column
+     */
+    static const unsigned int max_texture_width = 1024;
+    static const unsigned int matrix_texels = 4;
+
+    SceneInstancingPrivate() :
+        method(MethodAttrib), indexed(true), instances(0), vertex_count(0),
+        batch_size(0), data_location(-1), vao(0), vertex_buffer(0),
+        index_buffer(0), instance_buffer(0), instance_texture(0) {}
+
+    /**
+     * Creates a unit cube, with per-face normals.
+     *
+     * @param vertices the interleaved positions and normals
+     * @param indices the triangle indices
+     */
+    static void create_cube(std::vector<float> &vertices,
+                            std::vector<GLushort> &indices)
+    {
+        static const float normals[6][3] = {
+            { 1, 0, 0}, {-1, 0, 0}, {0,  1, 0},
+            {0, -1, 0}, { 0, 0, 1}, {0,  0, -1},
+        };
+
+        for (unsigned int f = 0; f < 6; f++) {
+            const float *n = normals[f];
+            /* Two axes spanning the face, so that (u, v, n) is right-handed */
+            float u[3] = {n[1] + n[2], n[2] + n[0], n[0] + n[1]};
+            float v[3] = {n[1] * u[2] - n[2] * u[1],
+                          n[2] * u[0] - n[0] * u[2],
+                          n[0] * u[1] - n[1] * u[0]};
+            static const float corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+            GLushort base = vertices.size() / 6;
+
+            for (unsigned int c = 0; c < 4; c++) {
+                for (unsigned int i = 0; i < 3; i++) {
+                    vertices.push_back(0.5f * (n[i] + corners[c][0] * u[i] +
+                                               corners[c][1] * v[i]));
+                }
+                vertices.insert(vertices.end(), n, n + 3);
+            }
+
+            static const GLushort quad[6] = {0, 1, 2, 0, 2, 3};
+            for (GLushort i : quad)
+                indices.push_back(base + i);
+        }
+    }
+
+    /**
+     * Gets the model matrix of an instance, which places it in a square
+     * grid in the xy-plane, with its own orientation.
+     */
+    LibMatrix::mat4 instance_matrix(unsigned int i, unsigned int side, float scale)
+    {
+        float offset = 0.5f * (side - 1);
+        LibMatrix::mat4 model(LibMatrix::Mat4::translate(i % side - offset,
+                                                         i / side - offset, 0.0f));
+        model *= LibMatrix::Mat4::rotate(37.0f * i, std::sin(0.71f * i),
+                                         std::cos(0.71f * i), 1.0f);
+        model *= LibMatrix::Mat4::scale(scale, scale, scale);
+        return model;
+    }
+
+    /**
+     * Gets the width of the texture holding the instance data, in
+     * instances.
+     */
+    unsigned int texture_width() const
+    {
+        return std::min(instances, max_texture_width / matrix_texels);
+    }
+
+    void draw_instances(GLsizei count)
+    {
+        if (indexed) {
+            GLExtensions::DrawElementsInstanced(GL_TRIANGLES, vertex_count,
+                                                GL_UNSIGNED_SHORT, 0, count);
+        }
+        else {
+            GLExtensions::DrawArraysInstanced(GL_TRIANGLES, 0, vertex_count, count);
+        }
+    }
+
+    Method method;
+    bool indexed;
+    unsigned int instances;
+    GLsizei vertex_count;
+    unsigned int batch_size;
+    /* The column-major model matrices of the instances */
+    std::vector<float> data;
+    GLint data_location;
+    Program program;
+    GLuint vao;
+    GLuint vertex_buffer;
+    GLuint index_buffer;
+    GLuint instance_buffer;
+    GLuint instance_texture;
+};
+
+SceneInstancing::SceneInstancing(Canvas &pCanvas) :
+    Scene(pCanvas, "instancing")
+{
+    priv_ = new SceneInstancingPrivate();
+    options_["method"] = Scene::Option("method", "attrib",
+                                       "How to draw the objects: one draw call per object,"
+                                       " or instanced with the per-instance data in a vertex"
+                                       " attribute, a uniform buffer or a texture",
+                                       "draws,attrib,ubo,texture");
+    options_["instances"] = Scene::Option("instances", "4096",
+                                          "The number of objects to draw");
+    options_["indexed"] = Scene::Option("indexed", "true",
+                                        "Whether to use indexed draw calls",
+                                        "false,true");
+}
+
+SceneInstancing::~SceneInstancing()
+{
+    delete priv_;
+}
+
+bool
+SceneInstancing::supported(bool show_errors)
+{
+#if GLMARK2_USE_GLESv2
+    bool version_ok = GLExtensions::version_at_least(3, 0);
+#else
+    bool version_ok = GLExtensions::version_at_least(3, 3);
+#endif
+
+    if (!version_ok ||
+        !GLExtensions::DrawArraysInstanced || !GLExtensions::DrawElementsInstanced ||
+        !GLExtensions::VertexAttribDivisor || !GLExtensions::GenVertexArrays)
+    {
+        if (show_errors) {
+            Log::error("Instancing requires GL 3.3 or GLES 3.0,"
+                       " which are not supported!\n");
+        }
+        return false;
+    }
+
+    if (options_["method"].value == "ubo" &&
+        (!GLExtensions::GetUniformBlockIndex || !GLExtensions::UniformBlockBinding ||
+         !GLExtensions::BindBufferRange))
+    {
+        if (show_errors)
+            Log::error("Requested the ubo method but uniform buffers are not supported!\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneInstancing::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    const std::string &method = options_["method"].value;
+    if (method == "draws")
+        priv_->method = SceneInstancingPrivate::MethodDraws;
+    else if (method == "ubo")
+        priv_->method = SceneInstancingPrivate::MethodUBO;
+    else if (method == "texture")
+        priv_->method = SceneInstancingPrivate::MethodTexture;
+    else
+        priv_->method = SceneInstancingPrivate::MethodAttrib;
+
+    priv_->indexed = options_["indexed"].value == "true";
+    priv_->instances = Util::fromString<unsigned int>(options_["instances"].value);
+    if (priv_->instances == 0) {
+        Log::error("The number of instances must be positive\n");
+        return false;
+    }
+
+    unsigned int side = static_cast<unsigned int>(std::ceil(std::sqrt(priv_->instances)));
+    float scale = std::min(0.7f, 8.0f / side + 0.2f);
+    priv_->data.resize(16 * priv_->instances);
+    for (unsigned int i = 0; i < priv_->instances; i++) {
+        LibMatrix::mat4 model(priv_->instance_matrix(i, side, scale));
+        const float *m = model;
+        std::copy(m, m + 16, &priv_->data[16 * i]);
+    }
+
+    /* Describe how the shader gets the instance data */
+    std::string input;
+    std::string data;
+
+    switch (priv_->method) {
+        case SceneInstancingPrivate::MethodDraws:
+            input = "uniform mat4 InstanceData;";
+            data = "InstanceData";
+            break;
+        case SceneInstancingPrivate::MethodAttrib:
+            input = "in mat4 instance;";
+            data = "instance";
+            break;
+        case SceneInstancingPrivate::MethodUBO:
+        {
+            /*
+             * Draw in batches that fit in a uniform block, with each batch
+             * starting at a properly aligned offset.
+             */
+            GLint max_block_size = 0;
+            GLint alignment = 0;
+            glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &max_block_size);
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+            const int matrix_size = 16 * sizeof(float);
+            unsigned int align = std::max(1, alignment / matrix_size);
+            unsigned int batch = std::min(priv_->instances,
+                                          static_cast<unsigned int>(max_block_size /
+                                                                    matrix_size));
+            batch = std::max(align, batch / align * align);
+            priv_->batch_size = std::min(batch, 4096u);
+
+            input = "layout(std140) uniform InstanceBlock { mat4 Instances[" +
+                    Util::toString(priv_->batch_size) + "]; };";
+            data = "Instances[gl_InstanceID]";
+            break;
+        }
+        case SceneInstancingPrivate::MethodTexture:
+        {
+            /* Each matrix takes a run of texels in a row, one for each column */
+            std::string w(Util::toString(priv_->texture_width()));
+            std::string x(Util::toString(SceneInstancingPrivate::matrix_texels) +
+                          " * (gl_InstanceID % " + w + ")");
+            std::string y("gl_InstanceID / " + w);
+            input = "uniform highp sampler2D InstanceTexture;";
+            data = "mat4(";
+            for (unsigned int c = 0; c < SceneInstancingPrivate::matrix_texels; c++) {
+                data += (c ? ", " : "") + std::string("texelFetch(InstanceTexture, ivec2(") +
+                        x + " + " + Util::toString(c) + ", " + y + "), 0)";
+            }
+            data += ")";
+            break;
+        }
+    }
+
+    ShaderSource vtx_source(Options::data_path + "/shaders/instancing.vert",
+                            ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(Options::data_path + "/shaders/instancing.frag",
+                            ShaderSource::ShaderTypeFragment);
+
+    vtx_source.replace("$INSTANCE_INPUT$", input);
+    vtx_source.replace("$INSTANCE_DATA$", data);
+    vtx_source.version(Scene::glsl_version(140, 300));
+    frg_source.version(Scene::glsl_version(140, 300));
+
+    if (!Scene::load_shaders_from_strings(priv_->program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    /* Set up the geometry */
+    std::vector<float> vertices;
+    std::vector<GLushort> indices;
+    SceneInstancingPrivate::create_cube(vertices, indices);
+
+    if (!priv_->indexed) {
+        std::vector<float> expanded;
+        for (GLushort i : indices)
+            expanded.insert(expanded.end(), &vertices[6 * i], &vertices[6 * i + 6]);
+        vertices.swap(expanded);
+    }
+    priv_->vertex_count = indices.size();
+
+    GLExtensions::GenVertexArrays(1, &priv_->vao);
+    GLExtensions::BindVertexArray(priv_->vao);
+
+    glGenBuffers(1, &priv_->vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, priv_->vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
+                 vertices.data(), GL_STATIC_DRAW);
+
+    GLint position = priv_->program["position"].location();
+    GLint normal = priv_->program["normal"].location();
+    glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), 0);
+    glVertexAttribPointer(normal, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
+                          reinterpret_cast<const void *>(3 * sizeof(float)));
+    glEnableVertexAttribArray(position);
+    glEnableVertexAttribArray(normal);
+
+    if (priv_->indexed) {
+        glGenBuffers(1, &priv_->index_buffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, priv_->index_buffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort),
+                     indices.data(), GL_STATIC_DRAW);
+    }
+
+    priv_->program.start();
+
+    /* Set up the instance data */
+    switch (priv_->method) {
+        case SceneInstancingPrivate::MethodDraws:
+            priv_->data_location = priv_->program["InstanceData"].location();
+            break;
+        case SceneInstancingPrivate::MethodAttrib:
+        {
+            GLint instance = priv_->program["instance"].location();
+            glGenBuffers(1, &priv_->instance_buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, priv_->instance_buffer);
+            glBufferData(GL_ARRAY_BUFFER, priv_->data.size() * sizeof(float),
+                         priv_->data.data(), GL_STATIC_DRAW);
+
+            /* A matrix attribute takes a location for each column */
+            for (GLint c = 0; c < 4; c++) {
+                glVertexAttribPointer(instance + c, 4, GL_FLOAT, GL_FALSE,
+                                      16 * sizeof(float),
+                                      reinterpret_cast<const void *>(4 * c * sizeof(float)));
+                glEnableVertexAttribArray(instance + c);
+                GLExtensions::VertexAttribDivisor(instance + c, 1);
+            }
+            break;
+        }
+        case SceneInstancingPrivate::MethodUBO:
+        {
+            GLuint block = GLExtensions::GetUniformBlockIndex(priv_->program.handle(),
+                                                              "InstanceBlock");
+            if (block == GL_INVALID_INDEX) {
+                Log::error("Failed to find the instance uniform block\n");
+                return false;
+            }
+            GLExtensions::UniformBlockBinding(priv_->program.handle(), block, 0);
+
+            /* Pad the buffer so that the last batch can be bound whole */
+            unsigned int nbatches = (priv_->instances + priv_->batch_size - 1) /
+                                    priv_->batch_size;
+            std::vector<float> padded(priv_->data);
+            padded.resize(16 * nbatches * priv_->batch_size);
+
+            glGenBuffers(1, &priv_->instance_buffer);
+            glBindBuffer(GL_UNIFORM_BUFFER, priv_->instance_buffer);
+            glBufferData(GL_UNIFORM_BUFFER, padded.size() * sizeof(float),
+                         padded.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            break;
+        }
+        case SceneInstancingPrivate::MethodTexture:
+        {
+            unsigned int width = priv_->texture_width();
+            unsigned int height = (priv_->instances + width - 1) / width;
+            GLint max_size = 0;
+            glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+            if (height > static_cast<unsigned int>(max_size)) {
+                Log::error("Too many instances for the instance data texture\n");
+                return false;
+            }
+
+            std::vector<float> padded(priv_->data);
+            padded.resize(16 * width * height);
+
+            glGenTextures(1, &priv_->instance_texture);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, priv_->instance_texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F,
+                         SceneInstancingPrivate::matrix_texels * width, height, 0,
+                         GL_RGBA, GL_FLOAT, padded.data());
+            priv_->program["InstanceTexture"] = 0;
+            break;
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    /* Look at the grid of cubes from slightly below */
+    float grid = static_cast<float>(side);
+    float distance = 0.6f * grid / std::tan(30.0f * M_PI / 180.0f) + 1.0f;
+    float aspect = static_cast<float>(canvas_.width()) / canvas_.height();
+    LibMatrix::mat4 view_proj(LibMatrix::Mat4::perspective(60.0, aspect, 1.0,
+                                                           distance + grid));
+    view_proj *= LibMatrix::Mat4::lookAt(0.0, -0.3f * distance, distance,
+                                         0.0, 0.0, 0.0,
+                                         0.0, 1.0, 0.0);
+
+    priv_->program["ViewProjectionMatrix"] = view_proj;
+
+    glEnable(GL_DEPTH_TEST);
+
+    return true;
+}
+
+void
+SceneInstancing::teardown()
+{
+    glDisable(GL_DEPTH_TEST);
+
+    if (priv_->vao) {
+        GLExtensions::BindVertexArray(0);
+        GLExtensions::DeleteVertexArrays(1, &priv_->vao);
+        priv_->vao = 0;
+    }
+
+    GLuint buffers[3] = {priv_->vertex_buffer, priv_->index_buffer,
+                         priv_->instance_buffer};
+    for (GLuint buffer : buffers) {
+        if (buffer)
+            glDeleteBuffers(1, &buffer);
+    }
+    priv_->vertex_buffer = 0;
+    priv_->index_buffer = 0;
+    priv_->instance_buffer = 0;
+
+    if (priv_->instance_texture) {
+        glDeleteTextures(1, &priv_->instance_texture);
+        priv_->instance_texture = 0;
+    }
+
+    priv_->program.stop();
+    priv_->program.release();
+    priv_->data.clear();
+
+    double elapsed = realTime_.elapsed();
+    if (elapsed > 0.0) {
+        add_metric("Instances", "instance_rate",
+                   priv_->instances * static_cast<double>(currentFrame_) /
+                   (1000000.0 * elapsed), "M/s", 2);
+    }
+
+    Scene::teardown();
+}
+
+void
+SceneInstancing::draw()
+{
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    priv_->program["Time"] = static_cast<float>(realTime_.elapsed());
+
+    switch (priv_->method) {
+        case SceneInstancingPrivate::MethodDraws:
+            for (unsigned int i = 0; i < priv_->instances; i++) {
+                glUniformMatrix4fv(priv_->data_location, 1, GL_FALSE,
+                                   &priv_->data[16 * i]);
+                if (priv_->indexed)
+                    glDrawElements(GL_TRIANGLES, priv_->vertex_count, GL_UNSIGNED_SHORT, 0);
+                else
+                    glDrawArrays(GL_TRIANGLES, 0, priv_->vertex_count);
+            }
+            break;
+        case SceneInstancingPrivate::MethodUBO:
+            for (unsigned int first = 0; first < priv_->instances;
+                 first += priv_->batch_size)
+            {
+                GLsizeiptr size = 16 * priv_->batch_size * sizeof(float);
+                GLExtensions::BindBufferRange(GL_UNIFORM_BUFFER, 0,
+                                              priv_->instance_buffer,
+                                              16 * first * sizeof(float), size);
+                priv_->draw_instances(std::min(priv_->batch_size,
+                                               priv_->instances - first));
+            }
+            break;
+        case SceneInstancingPrivate::MethodAttrib:
+        case SceneInstancingPrivate::MethodTexture:
+            priv_->draw_instances(priv_->instances);
+            break;
+    }
+}
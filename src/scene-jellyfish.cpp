@@ -43,6 +43,20 @@ SceneJellyfish::~SceneJellyfish()
     delete priv_;
 }
 
+void
+SceneJellyfish::assets(const std::map<std::string, std::string> &values,
+                        Assets &assets) const
+{
+    (void)values;
+    assets.files.push_back(Options::data_path + "/models/jellyfish.jobj");
+    assets.textures.push_back("jellyfish256");
+    for (unsigned int i = 1; i < 33; i++) {
+        std::stringstream ss;
+        ss << "jellyfish-caustics-" << std::setw(2) << std::setfill('0') << i;
+        assets.textures.push_back(ss.str());
+    }
+}
+
 bool
 SceneJellyfish::setup()
 {
@@ -326,6 +340,10 @@ JellyfishPrivate::JellyfishPrivate() :
     normalLocation_(0),
     colorLocation_(0),
     texcoordLocation_(0),
+    worldHandle_(0),
+    worldViewProjHandle_(0),
+    worldInvTransposeHandle_(0),
+    currentTimeHandle_(0),
     viewport_(512.0, 512.0),
     lightPosition_(10.0, 40.0, -60.0),
     lightColor_(0.8, 1.3, 1.1, 1.0),
@@ -411,6 +429,10 @@ JellyfishPrivate::initialize()
     normalLocation_ = program_["aVertexNormal"].location();
     colorLocation_ = program_["aVertexColor"].location();
     texcoordLocation_ = program_["aTextureCoord"].location();
+    worldHandle_ = program_.symbolHandle("uWorld");
+    worldViewProjHandle_ = program_.symbolHandle("uWorldViewProj");
+    worldInvTransposeHandle_ = program_.symbolHandle("uWorldInvTranspose");
+    currentTimeHandle_ = program_.symbolHandle("uCurrentTime");
 
     // We need 2 buffers for our work here.  One for the vertex data.
     // and one for the index data.
@@ -564,10 +586,10 @@ JellyfishPrivate::draw()
 
     // Load up the uniforms
     program_.start();
-    program_["uWorld"] = world_.getCurrent();
-    program_["uWorldViewProj"] = worldViewProjection;
-    program_["uWorldInvTranspose"] = worldInverseTranspose;
-    program_["uCurrentTime"] = currentTime_;
+    program_[worldHandle_] = world_.getCurrent();
+    program_[worldViewProjHandle_] = worldViewProjection;
+    program_[worldInvTransposeHandle_] = worldInverseTranspose;
+    program_[currentTimeHandle_] = currentTime_;
     // Revisit making these constants rather than uniforms as they appear never
     // to change
     program_["uLightPos"] = lightPosition_;
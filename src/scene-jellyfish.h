@@ -92,6 +92,10 @@ class JellyfishPrivate
     int normalLocation_;
     int colorLocation_;
     int texcoordLocation_;
+    Program::SymbolHandle worldHandle_;
+    Program::SymbolHandle worldViewProjHandle_;
+    Program::SymbolHandle worldInvTransposeHandle_;
+    Program::SymbolHandle currentTimeHandle_;
     LibMatrix::vec2 viewport_;
     LibMatrix::Stack4 world_;
     LibMatrix::Stack4 projection_;
@@ -0,0 +1,362 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+struct SceneMRTPrivate
+{
+    struct Format {
+        const char *name;
+        GLenum internal_format;
+        GLenum format;
+        GLenum type;
+        unsigned int bytes_per_pixel;
+        /* Whether GLES needs GL_EXT_color_buffer_float to render to it */
+        bool needs_float_ext;
+    };
+
+    static const unsigned int max_targets = 8;
+    static const Format formats[];
+
+    SceneMRTPrivate() :
+        targets(0), format(0), width(0), height(0), vao(0), quad_buffer(0),
+        fbo(0)
+    {
+        for (GLuint &t : textures)
+            t = 0;
+    }
+
+    static const Format *find_format(const std::string &name)
+    {
+        for (const Format *f = formats; f->name; f++) {
+            if (name == f->name)
+                return f;
+        }
+        return 0;
+    }
+
+    /* The GLSL expression for the contents of each render target */
+    static std::string target_value(unsigned int i)
+    {
+        switch (i) {
+            case 0: return "vec4(albedo, 1.0)";
+            case 1: return "vec4(0.5 * normal + 0.5, 1.0)";
+            case 2: return "vec4(0.75 + 0.25 * height, 0.5 + 0.5 * albedo.g, 0.0, 1.0)";
+            case 3: return "vec4(velocity, 0.0, 1.0)";
+            default: return "vec4(fract(TexCoord * " + Util::toString(i) +
+                            ".0 + 0.1 * Time), albedo.b, 1.0)";
+        }
+    }
+
+    unsigned int targets;
+    const Format *format;
+    GLsizei width;
+    GLsizei height;
+    Program gbuffer_program;
+    Program resolve_program;
+    GLuint vao;
+    GLuint quad_buffer;
+    GLuint fbo;
+    GLuint textures[max_targets];
+};
+
+const SceneMRTPrivate::Format SceneMRTPrivate::formats[] = {
+    {"rgba8", GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4, false},
+    {"rgb10a2", GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, 4, false},
+    {"rgba16f", GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8, true},
+    {"r11g11b10f", GL_R11F_G11F_B10F, GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV, 4, true},
+    {0, 0, 0, 0, 0, false}
+};
+
+SceneMRT::SceneMRT(Canvas &pCanvas) :
+    Scene(pCanvas, "mrt")
+{
+    priv_ = new SceneMRTPrivate();
+    options_["targets"] = Scene::Option("targets", "4",
+                                        "The number of color attachments of the G-buffer",
+                                        "1,2,3,4,5,6,7,8");
+    options_["format"] = Scene::Option("format", "rgba8",
+                                       "The format of the color attachments",
+                                       "rgba8,rgb10a2,rgba16f,r11g11b10f");
+    options_["size"] = Scene::Option("size", "1920x1080",
+                                     "The size of the G-buffer (WxH)");
+}
+
+SceneMRT::~SceneMRT()
+{
+    delete priv_;
+}
+
+bool
+SceneMRT::supported(bool show_errors)
+{
+#if GLMARK2_USE_GLESv2
+    bool version_ok = GLExtensions::version_at_least(3, 0);
+#else
+    bool version_ok = GLExtensions::version_at_least(3, 3);
+#endif
+
+    if (!version_ok || !GLExtensions::DrawBuffers || !GLExtensions::GenVertexArrays) {
+        if (show_errors) {
+            Log::error("Multiple render targets require GL 3.3 or GLES 3.0,"
+                       " which are not supported!\n");
+        }
+        return false;
+    }
+
+    const SceneMRTPrivate::Format *format =
+        SceneMRTPrivate::find_format(options_["format"].value);
+    if (!format) {
+        if (show_errors)
+            Log::error("Unknown format '%s'\n", options_["format"].value.c_str());
+        return false;
+    }
+
+#if GLMARK2_USE_GLESv2
+    if (format->needs_float_ext && !GLExtensions::support("GL_EXT_color_buffer_float")) {
+        if (show_errors) {
+            Log::error("Rendering to %s requires GL_EXT_color_buffer_float,"
+                       " which is not supported!\n", format->name);
+        }
+        return false;
+    }
+#endif
+
+    unsigned int targets = Util::fromString<unsigned int>(options_["targets"].value);
+    GLint max_draw_buffers = 0;
+    GLint max_attachments = 0;
+    glGetIntegerv(GL_MAX_DRAW_BUFFERS, &max_draw_buffers);
+    glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &max_attachments);
+    GLint max_targets = std::min(max_draw_buffers, max_attachments);
+
+    if (targets == 0 || targets > SceneMRTPrivate::max_targets ||
+        static_cast<GLint>(targets) > max_targets)
+    {
+        if (show_errors) {
+            Log::error("Unsupported number of render targets %u (maximum is %d)\n",
+                       targets, std::min(max_targets,
+                                         static_cast<GLint>(SceneMRTPrivate::max_targets)));
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneMRT::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    priv_->targets = Util::fromString<unsigned int>(options_["targets"].value);
+    priv_->format = SceneMRTPrivate::find_format(options_["format"].value);
+
+    std::vector<std::string> size;
+    Util::split(options_["size"].value, 'x', size, Util::SplitModeNormal);
+    priv_->width = size.size() > 0 ? Util::fromString<int>(size[0]) : 0;
+    priv_->height = size.size() > 1 ? Util::fromString<int>(size[1]) : priv_->width;
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    if (priv_->width <= 0 || priv_->height <= 0 ||
+        priv_->width > max_size || priv_->height > max_size)
+    {
+        Log::error("Invalid G-buffer size %dx%d (maximum is %dx%d)\n",
+                   priv_->width, priv_->height, max_size, max_size);
+        return false;
+    }
+
+    /* Build the shaders for the requested number of targets */
+    std::stringstream writes;
+    std::stringstream reads;
+    for (unsigned int i = 0; i < priv_->targets; i++) {
+        std::string sample("texture(GBuffer[" + Util::toString(i) + "], TexCoord)");
+        writes << "    Target[" << i << "] = "
+               << SceneMRTPrivate::target_value(i) << ";" << std::endl;
+        switch (i) {
+            case 0: reads << "    albedo = " << sample << ".rgb;"; break;
+            case 1: reads << "    normal = 2.0 * " << sample << ".xyz - 1.0;"; break;
+            case 2: reads << "    material = " << sample << ";"; break;
+            default: reads << "    extra += " << sample << ".rgb;"; break;
+        }
+        reads << std::endl;
+    }
+
+    std::string num_targets(Util::toString(priv_->targets));
+    std::string version(Scene::glsl_version(330, 300));
+
+    ShaderSource vtx_source(Options::data_path + "/shaders/mrt.vert",
+                            ShaderSource::ShaderTypeVertex);
+    ShaderSource gbuffer_source(Options::data_path + "/shaders/mrt-gbuffer.frag",
+                                ShaderSource::ShaderTypeFragment);
+    ShaderSource resolve_source(Options::data_path + "/shaders/mrt-resolve.frag",
+                                ShaderSource::ShaderTypeFragment);
+
+    gbuffer_source.replace("$NUM_TARGETS$", num_targets);
+    gbuffer_source.replace("$TARGET_WRITES$", writes.str());
+    resolve_source.replace("$NUM_TARGETS$", num_targets);
+    resolve_source.replace("$GBUFFER_READS$", reads.str());
+
+    vtx_source.version(version);
+    gbuffer_source.version(version);
+    resolve_source.version(version);
+
+    if (!Scene::load_shaders_from_strings(priv_->gbuffer_program, vtx_source.str(),
+                                          gbuffer_source.str()) ||
+        !Scene::load_shaders_from_strings(priv_->resolve_program, vtx_source.str(),
+                                          resolve_source.str()))
+    {
+        return false;
+    }
+
+    /* The G-buffer */
+    glGenTextures(priv_->targets, priv_->textures);
+    for (unsigned int i = 0; i < priv_->targets; i++) {
+        glBindTexture(GL_TEXTURE_2D, priv_->textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, priv_->format->internal_format,
+                     priv_->width, priv_->height, 0, priv_->format->format,
+                     priv_->format->type, 0);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLenum draw_buffers[SceneMRTPrivate::max_targets];
+    GLExtensions::GenFramebuffers(1, &priv_->fbo);
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, priv_->fbo);
+    for (unsigned int i = 0; i < priv_->targets; i++) {
+        draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+        GLExtensions::FramebufferTexture2D(GL_FRAMEBUFFER, draw_buffers[i],
+                                           GL_TEXTURE_2D, priv_->textures[i], 0);
+    }
+    GLExtensions::DrawBuffers(priv_->targets, draw_buffers);
+    GLenum status = GLExtensions::CheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        Log::error("Failed to create a G-buffer with %u %s targets (status 0x%x)\n",
+                   priv_->targets, priv_->format->name, status);
+        return false;
+    }
+
+    /* A full screen quad, so that every G-buffer pixel is written exactly once */
+    static const GLfloat quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+
+    GLExtensions::GenVertexArrays(1, &priv_->vao);
+    GLExtensions::BindVertexArray(priv_->vao);
+
+    glGenBuffers(1, &priv_->quad_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, priv_->quad_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+    /* Both programs share the vertex shader, so the location is the same */
+    GLint position = priv_->gbuffer_program["position"].location();
+    glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(position);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    priv_->resolve_program.start();
+    for (unsigned int i = 0; i < priv_->targets; i++)
+        priv_->resolve_program["GBuffer[" + Util::toString(i) + "]"] = static_cast<int>(i);
+
+    return true;
+}
+
+void
+SceneMRT::teardown()
+{
+    /* The color attachment writes of the G-buffer pass */
+    double elapsed = realTime_.elapsed();
+    if (elapsed > 0.0 && priv_->format) {
+        double bytes = static_cast<double>(priv_->width) * priv_->height *
+                       priv_->targets * priv_->format->bytes_per_pixel;
+        add_metric("FillBandwidth", "fill_bandwidth",
+                   bytes * currentFrame_ / (1000000000.0 * elapsed), "GB/s", 2);
+    }
+
+    if (priv_->vao) {
+        GLExtensions::BindVertexArray(0);
+        GLExtensions::DeleteVertexArrays(1, &priv_->vao);
+        priv_->vao = 0;
+    }
+
+    if (priv_->quad_buffer) {
+        glDeleteBuffers(1, &priv_->quad_buffer);
+        priv_->quad_buffer = 0;
+    }
+
+    if (priv_->fbo) {
+        GLExtensions::DeleteFramebuffers(1, &priv_->fbo);
+        priv_->fbo = 0;
+    }
+
+    if (priv_->textures[0]) {
+        glDeleteTextures(priv_->targets, priv_->textures);
+        for (GLuint &t : priv_->textures)
+            t = 0;
+    }
+
+    priv_->gbuffer_program.stop();
+    priv_->gbuffer_program.release();
+    priv_->resolve_program.stop();
+    priv_->resolve_program.release();
+
+    Scene::teardown();
+}
+
+void
+SceneMRT::draw()
+{
+    /* Fill the G-buffer */
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, priv_->fbo);
+    glViewport(0, 0, priv_->width, priv_->height);
+
+    priv_->gbuffer_program.start();
+    priv_->gbuffer_program["Time"] = static_cast<float>(realTime_.elapsed());
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    /* Resolve it with a lighting pass on the canvas */
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+    glViewport(0, 0, canvas_.width(), canvas_.height());
+
+    priv_->resolve_program.start();
+    for (unsigned int i = 0; i < priv_->targets; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, priv_->textures[i]);
+    }
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    /* Unbind the G-buffer, so that the next frame doesn't sample while writing */
+    for (unsigned int i = 0; i < priv_->targets; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
@@ -0,0 +1,633 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * A fountain of particles, simulated either on the GPU with transform
+ * feedback or on the CPU. Both simulations are the same as the one in
+ * particles-update.vert.
+ *
+ * The CPU simulation is split in bands of particles, one per thread, and
+ * each thread writes the new positions of its band straight into the
+ * mapped vertex buffer. The threads other than the main one are kept for
+ * the whole benchmark, and are woken up for each frame.
+ */
+struct SceneParticlesPrivate
+{
+    static constexpr float time_step = 1.0f / 60.0f;
+    static constexpr float gravity = 2.5f;
+    static constexpr float restitution = 0.6f;
+
+    SceneParticlesPrivate() :
+        gpu(true), particles(0), threads(1), frame(0), sim_time(0.0),
+        output(0), generation(0), busy(0), stopping(false), current(0)
+    {
+        for (unsigned int i = 0; i < 2; i++) {
+            buffers[i] = 0;
+            vaos[i] = 0;
+        }
+    }
+
+    static uint32_t hash(uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    static float random(uint32_t &seed)
+    {
+        seed = hash(seed);
+        return (seed >> 8) * (1.0f / 16777216.0f);
+    }
+
+    void spawn(unsigned int i, uint32_t frame_seed);
+    void simulate_scalar(size_t first, size_t last, float *out);
+    void simulate(size_t first, size_t last, float *out);
+    void band(unsigned int index, size_t &first, size_t &last) const;
+    void start_workers();
+    void stop_workers();
+    void worker(unsigned int index);
+    void simulate_frame(float *out);
+
+    bool gpu;
+    unsigned int particles;
+    unsigned int threads;
+    unsigned int frame;
+    Program update_program;
+    Program draw_program;
+
+    /*
+     * The state of the CPU simulation, in separate arrays so that four
+     * particles can be loaded into each SIMD register
+     */
+    std::vector<float> px, py, pz, life;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> staging;
+    double sim_time;
+
+    /* The worker threads of the CPU simulation, and the frame they work on */
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    float *output;
+    unsigned int generation;
+    unsigned int busy;
+    bool stopping;
+
+    /*
+     * The state of the GPU simulation, in two buffers of interleaved
+     * positions and velocities: one is read while the other is written.
+     * The CPU simulation only uses the first buffer, for the positions.
+     */
+    unsigned int current;
+    GLuint buffers[2];
+    GLuint vaos[2];
+    LibMatrix::mat4 projection;
+};
+
+/**
+ * Respawns a particle at the emitter, with a new velocity and life.
+ */
+void
+SceneParticlesPrivate::spawn(unsigned int i, uint32_t frame_seed)
+{
+    uint32_t seed = i ^ frame_seed;
+    life[i] = 1.5f + 1.5f * random(seed);
+    px[i] = py[i] = pz[i] = 0.0f;
+    vx[i] = random(seed) - 0.5f;
+    vy[i] = 2.5f + random(seed);
+    vz[i] = random(seed) - 0.5f;
+}
+
+/**
+ * Advances the particles in the range [first, last) by one time step, and
+ * writes their positions and lives to out.
+ */
+void
+SceneParticlesPrivate::simulate_scalar(size_t first, size_t last, float *out)
+{
+    const float dt = time_step;
+    uint32_t frame_seed = hash(frame);
+
+    for (size_t i = first; i < last; i++) {
+        float nv = vy[i] - gravity * dt;
+        float ny = py[i] + nv * dt;
+
+        /* Bounce off the floor */
+        py[i] = std::fabs(ny);
+        vy[i] = ny < 0.0f ? -restitution * nv : nv;
+        px[i] += vx[i] * dt;
+        pz[i] += vz[i] * dt;
+        life[i] -= dt;
+
+        if (life[i] <= 0.0f)
+            spawn(i, frame_seed);
+
+        float *o = out + 4 * i;
+        o[0] = px[i];
+        o[1] = py[i];
+        o[2] = pz[i];
+        o[3] = life[i];
+    }
+}
+
+#if defined(__SSE2__)
+/*
+ * Processes four particles per iteration. The few that need to respawn
+ * are handled one by one, and the positions are transposed to vertices
+ * in registers.
+ */
+void
+SceneParticlesPrivate::simulate(size_t first, size_t last, float *out)
+{
+    const __m128 dt = _mm_set1_ps(time_step);
+    const __m128 dv = _mm_set1_ps(gravity * time_step);
+    const __m128 bounce = _mm_set1_ps(-restitution);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    uint32_t frame_seed = hash(frame);
+    size_t i = first;
+
+    for (; i + 4 <= last; i += 4) {
+        __m128 nv = _mm_sub_ps(_mm_loadu_ps(&vy[i]), dv);
+        __m128 y = _mm_add_ps(_mm_loadu_ps(&py[i]), _mm_mul_ps(nv, dt));
+        __m128 below = _mm_cmplt_ps(y, zero);
+        __m128 scale = _mm_or_ps(_mm_and_ps(below, bounce), _mm_andnot_ps(below, one));
+        __m128 x = _mm_add_ps(_mm_loadu_ps(&px[i]), _mm_mul_ps(_mm_loadu_ps(&vx[i]), dt));
+        __m128 z = _mm_add_ps(_mm_loadu_ps(&pz[i]), _mm_mul_ps(_mm_loadu_ps(&vz[i]), dt));
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(&life[i]), dt);
+        y = _mm_andnot_ps(sign, y);
+
+        _mm_storeu_ps(&vy[i], _mm_mul_ps(nv, scale));
+        _mm_storeu_ps(&px[i], x);
+        _mm_storeu_ps(&py[i], y);
+        _mm_storeu_ps(&pz[i], z);
+        _mm_storeu_ps(&life[i], l);
+
+        int dead = _mm_movemask_ps(_mm_cmple_ps(l, zero));
+        if (dead) {
+            for (unsigned int j = 0; j < 4; j++) {
+                if (dead & (1 << j))
+                    spawn(i + j, frame_seed);
+            }
+            x = _mm_loadu_ps(&px[i]);
+            y = _mm_loadu_ps(&py[i]);
+            z = _mm_loadu_ps(&pz[i]);
+            l = _mm_loadu_ps(&life[i]);
+        }
+
+        _MM_TRANSPOSE4_PS(x, y, z, l);
+        _mm_storeu_ps(out + 4 * i, x);
+        _mm_storeu_ps(out + 4 * i + 4, y);
+        _mm_storeu_ps(out + 4 * i + 8, z);
+        _mm_storeu_ps(out + 4 * i + 12, l);
+    }
+
+    simulate_scalar(i, last, out);
+}
+#else
+void
+SceneParticlesPrivate::simulate(size_t first, size_t last, float *out)
+{
+    simulate_scalar(first, last, out);
+}
+#endif
+
+/**
+ * Gets the particles simulated by a thread, in bands that start at
+ * multiples of four particles.
+ */
+void
+SceneParticlesPrivate::band(unsigned int index, size_t &first, size_t &last) const
+{
+    unsigned int count = workers.size() + 1;
+    size_t size = (particles / count) & ~static_cast<size_t>(3);
+
+    first = index * size;
+    last = (index == count - 1) ? particles : first + size;
+}
+
+void
+SceneParticlesPrivate::start_workers()
+{
+    unsigned int count = std::max(1u, std::min(threads, particles / 1024));
+
+    stopping = false;
+    generation = 0;
+    for (unsigned int i = 1; i < count; i++)
+        workers.emplace_back(&SceneParticlesPrivate::worker, this, i);
+}
+
+void
+SceneParticlesPrivate::stop_workers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+
+    for (auto &t : workers)
+        t.join();
+    workers.clear();
+}
+
+void
+SceneParticlesPrivate::worker(unsigned int index)
+{
+    unsigned int done = 0;
+
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        work_ready.wait(lock, [&] { return stopping || generation != done; });
+        if (stopping)
+            return;
+        done = generation;
+        lock.unlock();
+
+        size_t first, last;
+        band(index, first, last);
+        simulate(first, last, output);
+
+        lock.lock();
+        if (--busy == 0)
+            work_done.notify_one();
+    }
+}
+
+/**
+ * Advances all the particles by one time step with all the threads.
+ */
+void
+SceneParticlesPrivate::simulate_frame(float *out)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        output = out;
+        busy = workers.size();
+        generation++;
+    }
+    work_ready.notify_all();
+
+    size_t first, last;
+    band(0, first, last);
+    simulate(first, last, out);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [&] { return busy == 0; });
+}
+
+SceneParticles::SceneParticles(Canvas &pCanvas) :
+    Scene(pCanvas, "particles")
+{
+    priv_ = new SceneParticlesPrivate();
+    options_["particles"] = Scene::Option("particles", "262144",
+                                          "The number of particles");
+    options_["method"] = Scene::Option("method", "gpu",
+                                       "Where to simulate the particles: on the GPU with"
+                                       " transform feedback, or on the CPU streaming them"
+                                       " to a vertex buffer",
+                                       "gpu,cpu");
+    options_["threads"] = Scene::Option("threads", "0",
+                                        "The number of threads of the CPU simulation"
+                                        " (0: one per processor)");
+}
+
+SceneParticles::~SceneParticles()
+{
+    delete priv_;
+}
+
+bool
+SceneParticles::supported(bool show_errors)
+{
+#if GLMARK2_USE_GLESv2
+    bool version_ok = GLExtensions::version_at_least(3, 0);
+#else
+    bool version_ok = GLExtensions::version_at_least(3, 3);
+#endif
+
+    if (!version_ok || !GLExtensions::GenVertexArrays) {
+        if (show_errors) {
+            Log::error("The particles scene requires GL 3.3 or GLES 3.0,"
+                       " which are not supported!\n");
+        }
+        return false;
+    }
+
+    if (options_["method"].value == "gpu" &&
+        (!GLExtensions::BeginTransformFeedback || !GLExtensions::EndTransformFeedback ||
+         !GLExtensions::TransformFeedbackVaryings || !GLExtensions::BindBufferBase))
+    {
+        if (show_errors)
+            Log::error("Transform feedback is not supported!\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneParticles::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    priv_->gpu = options_["method"].value == "gpu";
+    priv_->particles = Util::fromString<unsigned int>(options_["particles"].value);
+    priv_->threads = Util::fromString<unsigned int>(options_["threads"].value);
+    if (priv_->threads == 0)
+        priv_->threads = std::max(1u, Util::get_num_processors());
+
+    if (priv_->particles == 0) {
+        Log::error("The number of particles must be at least 1\n");
+        return false;
+    }
+
+    /* Load the shaders */
+    std::string version(Scene::glsl_version(330, 300));
+
+    ShaderSource vtx_source(Options::data_path + "/shaders/particles.vert",
+                            ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(Options::data_path + "/shaders/particles.frag",
+                            ShaderSource::ShaderTypeFragment);
+    vtx_source.version(version);
+    frg_source.version(version);
+
+    if (!Scene::load_shaders_from_strings(priv_->draw_program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    if (priv_->gpu) {
+        ShaderSource update_vtx_source(Options::data_path + "/shaders/particles-update.vert",
+                                       ShaderSource::ShaderTypeVertex);
+        ShaderSource update_frg_source(Options::data_path + "/shaders/particles-update.frag",
+                                       ShaderSource::ShaderTypeFragment);
+        update_vtx_source.version(version);
+        update_frg_source.version(version);
+
+        priv_->update_program.feedbackVaryings({"NewPosition", "NewVelocity"});
+        if (!Scene::load_shaders_from_strings(priv_->update_program,
+                                              update_vtx_source.str(),
+                                              update_frg_source.str()))
+        {
+            return false;
+        }
+    }
+
+    /*
+     * Start with the particles at random points of their trajectories,
+     * so that they don't all respawn at once.
+     */
+    unsigned int n = priv_->particles;
+    priv_->px.resize(n);
+    priv_->py.resize(n);
+    priv_->pz.resize(n);
+    priv_->life.resize(n);
+    priv_->vx.resize(n);
+    priv_->vy.resize(n);
+    priv_->vz.resize(n);
+
+    static const float g = SceneParticlesPrivate::gravity;
+    uint32_t frame_seed = SceneParticlesPrivate::hash(~0u);
+
+    for (unsigned int i = 0; i < n; i++) {
+        priv_->spawn(i, frame_seed);
+        uint32_t seed = SceneParticlesPrivate::hash(i);
+        float age = priv_->life[i] * SceneParticlesPrivate::random(seed);
+        priv_->px[i] = priv_->vx[i] * age;
+        priv_->py[i] = std::fabs(priv_->vy[i] * age - 0.5f * g * age * age);
+        priv_->pz[i] = priv_->vz[i] * age;
+        priv_->vy[i] -= g * age;
+        priv_->life[i] -= age;
+    }
+
+    GLint position = priv_->draw_program["position"].location();
+
+    if (priv_->gpu) {
+        std::vector<float> data(8 * n);
+        for (unsigned int i = 0; i < n; i++) {
+            float *d = &data[8 * i];
+            d[0] = priv_->px[i];
+            d[1] = priv_->py[i];
+            d[2] = priv_->pz[i];
+            d[3] = priv_->life[i];
+            d[4] = priv_->vx[i];
+            d[5] = priv_->vy[i];
+            d[6] = priv_->vz[i];
+            d[7] = 0.0f;
+        }
+
+        GLint update_position = priv_->update_program["position"].location();
+        GLint update_velocity = priv_->update_program["velocity"].location();
+        static const GLsizei stride = 8 * sizeof(float);
+
+        if (position == update_velocity) {
+            Log::error("The particle programs have conflicting attribute locations\n");
+            return false;
+        }
+
+        glGenBuffers(2, priv_->buffers);
+        GLExtensions::GenVertexArrays(2, priv_->vaos);
+
+        for (unsigned int i = 0; i < 2; i++) {
+            glBindBuffer(GL_ARRAY_BUFFER, priv_->buffers[i]);
+            glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(),
+                         GL_DYNAMIC_COPY);
+        }
+
+        /*
+         * The update and draw programs are given the same VAOs, so the
+         * attributes are set for both, sharing their locations if they match
+         */
+        for (unsigned int i = 0; i < 2; i++) {
+            GLExtensions::BindVertexArray(priv_->vaos[i]);
+            glBindBuffer(GL_ARRAY_BUFFER, priv_->buffers[i]);
+            glVertexAttribPointer(update_position, 4, GL_FLOAT, GL_FALSE, stride, 0);
+            glEnableVertexAttribArray(update_position);
+            glVertexAttribPointer(update_velocity, 4, GL_FLOAT, GL_FALSE, stride,
+                                  reinterpret_cast<const GLvoid *>(4 * sizeof(float)));
+            glEnableVertexAttribArray(update_velocity);
+            if (position != update_position) {
+                glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, stride, 0);
+                glEnableVertexAttribArray(position);
+            }
+        }
+        GLExtensions::BindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        priv_->current = 0;
+    }
+    else {
+        glGenBuffers(1, priv_->buffers);
+        GLExtensions::GenVertexArrays(1, priv_->vaos);
+
+        glBindBuffer(GL_ARRAY_BUFFER, priv_->buffers[0]);
+        glBufferData(GL_ARRAY_BUFFER, 4 * sizeof(float) * n, 0, GL_STREAM_DRAW);
+        GLExtensions::BindVertexArray(priv_->vaos[0]);
+        glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, 0, 0);
+        glEnableVertexAttribArray(position);
+        GLExtensions::BindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        priv_->start_workers();
+    }
+
+    priv_->frame = 0;
+    priv_->sim_time = 0.0;
+
+    float aspect = static_cast<float>(canvas_.width()) / canvas_.height();
+    priv_->projection = LibMatrix::Mat4::perspective(45.0f, aspect, 0.1f, 50.0f);
+
+#if !GLMARK2_USE_GLESv2
+    glEnable(GL_PROGRAM_POINT_SIZE);
+#endif
+
+    return true;
+}
+
+void
+SceneParticles::teardown()
+{
+    double elapsed = realTime_.elapsed();
+    if (elapsed > 0.0 && priv_->particles > 0) {
+        add_metric("Particles", "particle_rate",
+                   static_cast<double>(priv_->particles) * currentFrame_ /
+                   (1000000.0 * elapsed), "M/s", 2);
+        if (!priv_->gpu && currentFrame_ > 0) {
+            add_metric("SimulationTime", "simulation_time",
+                       1000.0 * priv_->sim_time / currentFrame_, "ms", 3);
+        }
+    }
+
+#if !GLMARK2_USE_GLESv2
+    glDisable(GL_PROGRAM_POINT_SIZE);
+#endif
+
+    priv_->stop_workers();
+
+    for (unsigned int i = 0; i < 2; i++) {
+        if (priv_->vaos[i])
+            GLExtensions::DeleteVertexArrays(1, &priv_->vaos[i]);
+        if (priv_->buffers[i])
+            glDeleteBuffers(1, &priv_->buffers[i]);
+        priv_->vaos[i] = priv_->buffers[i] = 0;
+    }
+
+    std::vector<float> *state[] = {&priv_->px, &priv_->py, &priv_->pz, &priv_->life,
+                                   &priv_->vx, &priv_->vy, &priv_->vz, &priv_->staging};
+    for (std::vector<float> *s : state)
+        std::vector<float>().swap(*s);
+
+    priv_->update_program.stop();
+    priv_->update_program.release();
+    priv_->draw_program.stop();
+    priv_->draw_program.release();
+
+    Scene::teardown();
+}
+
+void
+SceneParticles::draw()
+{
+    unsigned int n = priv_->particles;
+
+    if (priv_->gpu) {
+        unsigned int next = 1 - priv_->current;
+
+        /* Capture the updated particles in the other buffer */
+        priv_->update_program.start();
+        priv_->update_program["Frame"] = static_cast<int>(priv_->frame);
+        priv_->update_program["TimeStep"] = SceneParticlesPrivate::time_step;
+
+        glEnable(GL_RASTERIZER_DISCARD);
+        GLExtensions::BindVertexArray(priv_->vaos[priv_->current]);
+        GLExtensions::BindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, priv_->buffers[next]);
+        GLExtensions::BeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, n);
+        GLExtensions::EndTransformFeedback();
+        GLExtensions::BindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        priv_->current = next;
+    }
+    else {
+        /* The threads write the particles straight into the vertex buffer */
+        GLsizeiptr size = 4 * sizeof(float) * n;
+        glBindBuffer(GL_ARRAY_BUFFER, priv_->buffers[0]);
+        float *out = static_cast<float *>(
+            GLExtensions::MapBufferRange(GL_ARRAY_BUFFER, 0, size,
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if (!out) {
+            priv_->staging.resize(4 * n);
+            out = priv_->staging.data();
+        }
+
+        double start = Util::get_timestamp_us() / 1000000.0;
+        priv_->simulate_frame(out);
+        priv_->sim_time += Util::get_timestamp_us() / 1000000.0 - start;
+
+        if (out == priv_->staging.data())
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, out);
+        else
+            GLExtensions::UnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    priv_->frame++;
+
+    /* Orbit slowly around the fountain */
+    float angle = 0.2f * realTime_.elapsed();
+    LibMatrix::mat4 view_projection(priv_->projection);
+    view_projection *= LibMatrix::Mat4::lookAt(5.0f * std::sin(angle), 2.0f,
+                                               5.0f * std::cos(angle),
+                                               0.0f, 1.0f, 0.0f,
+                                               0.0f, 1.0f, 0.0f);
+
+    priv_->draw_program.start();
+    priv_->draw_program["ViewProjectionMatrix"] = view_projection;
+
+    GLExtensions::BindVertexArray(priv_->vaos[priv_->gpu ? priv_->current : 0]);
+    glDrawArrays(GL_POINTS, 0, n);
+    GLExtensions::BindVertexArray(0);
+}
@@ -59,6 +59,14 @@ ScenePulsar::~ScenePulsar()
 {
 }
 
+void
+ScenePulsar::assets(const std::map<std::string, std::string> &values,
+                     Assets &assets) const
+{
+    if (values.at("texture") == "true")
+        assets.textures.push_back("crate-base");
+}
+
 bool
 ScenePulsar::load()
 {
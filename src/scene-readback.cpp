@@ -0,0 +1,243 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "async-readback.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <vector>
+
+struct SceneReadbackPrivate
+{
+    SceneReadbackPrivate(Canvas &canvas) :
+        readback(canvas), async(false), width(0), height(0),
+        texture(0), fbo(0), frame(0), sync_bytes(0), sync_latency(0) {}
+
+    /**
+     * Gets the clear color for a frame, so that each frame produces
+     * different (and easily verifiable) contents.
+     */
+    Canvas::Pixel color(unsigned int n)
+    {
+        return Canvas::Pixel((n * 37) & 0xff, (n * 101) & 0xff,
+                             (n * 211) & 0xff, 0xff);
+    }
+
+    AsyncReadback readback;
+    bool async;
+    int width;
+    int height;
+    GLuint texture;
+    GLuint fbo;
+    unsigned int frame;
+    std::vector<uint8_t> pixels;
+    uint64_t sync_bytes;
+    uint64_t sync_latency;
+};
+
+SceneReadback::SceneReadback(Canvas &pCanvas) :
+    Scene(pCanvas, "readback")
+{
+    priv_ = new SceneReadbackPrivate(pCanvas);
+    options_["size"] = Scene::Option("size", "1024x1024",
+                                     "The size of the region to read back (WxH)");
+    options_["method"] = Scene::Option("method", "async",
+                                       "How to read back the rendered frames",
+                                       "sync,async");
+    options_["buffers"] = Scene::Option("buffers", "3",
+                                        "The number of reads in flight for the async method");
+}
+
+SceneReadback::~SceneReadback()
+{
+    delete priv_;
+}
+
+bool
+SceneReadback::supported(bool show_errors)
+{
+    if (!GLExtensions::GenFramebuffers) {
+        if (show_errors)
+            Log::error("Readback requires GL framebuffer support\n");
+        return false;
+    }
+
+    if (options_["method"].value == "async" && !AsyncReadback::supported()) {
+        if (show_errors) {
+            Log::error("Requested async readback but pixel pack buffers"
+                       " (GL 2.1 or GLES 3.0) are not supported!\n");
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneReadback::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    std::vector<std::string> size;
+    Util::split(options_["size"].value, 'x', size, Util::SplitModeNormal);
+    priv_->width = size.size() > 0 ? Util::fromString<int>(size[0]) : 0;
+    priv_->height = size.size() > 1 ? Util::fromString<int>(size[1]) : priv_->width;
+    priv_->async = options_["method"].value == "async";
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    if (priv_->width <= 0 || priv_->height <= 0 ||
+        priv_->width > max_size || priv_->height > max_size)
+    {
+        Log::error("Invalid readback size %dx%d (maximum is %dx%d)\n",
+                   priv_->width, priv_->height, max_size, max_size);
+        return false;
+    }
+
+    glGenTextures(1, &priv_->texture);
+    glBindTexture(GL_TEXTURE_2D, priv_->texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, priv_->width, priv_->height, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLExtensions::GenFramebuffers(1, &priv_->fbo);
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, priv_->fbo);
+    GLExtensions::FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                       GL_TEXTURE_2D, priv_->texture, 0);
+    GLenum status = GLExtensions::CheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        Log::error("Readback framebuffer is incomplete (status: 0x%x)\n", status);
+        return false;
+    }
+
+    if (priv_->async) {
+        unsigned int buffers = Util::fromString<unsigned int>(options_["buffers"].value);
+        if (!priv_->readback.init(priv_->width, priv_->height, buffers)) {
+            Log::error("Failed to set up %u readback buffers of %dx%d\n",
+                       buffers, priv_->width, priv_->height);
+            return false;
+        }
+    }
+
+    priv_->frame = 0;
+    priv_->sync_bytes = 0;
+    priv_->sync_latency = 0;
+    priv_->pixels.clear();
+
+    return true;
+}
+
+void
+SceneReadback::teardown()
+{
+    /*
+     * Complete the reads still in flight first, so that they count towards
+     * the bytes and latency, and keep the newest frame contents around for
+     * validation
+     */
+    if (priv_->async)
+        priv_->readback.flush(&priv_->pixels);
+
+    /* Up to now, so that the time spent flushing is counted too */
+    double elapsed = Util::get_timestamp_us() / 1000000.0 - realTime_.start;
+    uint64_t bytes = priv_->async ? priv_->readback.bytes() : priv_->sync_bytes;
+    double latency = 0.0;
+
+    if (priv_->async)
+        latency = priv_->readback.average_latency();
+    else if (priv_->frame > 0)
+        latency = priv_->sync_latency / (1000000.0 * priv_->frame);
+
+    if (elapsed > 0.0) {
+        add_metric("Bandwidth", "readback_bandwidth",
+                   bytes / (1000000.0 * elapsed), "MB/s", 1);
+    }
+    add_metric("Latency", "readback_latency", 1000.0 * latency, "ms");
+
+    priv_->readback.release();
+
+    if (priv_->fbo) {
+        GLExtensions::DeleteFramebuffers(1, &priv_->fbo);
+        priv_->fbo = 0;
+    }
+    if (priv_->texture) {
+        glDeleteTextures(1, &priv_->texture);
+        priv_->texture = 0;
+    }
+
+    Scene::teardown();
+}
+
+void
+SceneReadback::draw()
+{
+    Canvas::Pixel c(priv_->color(priv_->frame));
+
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, priv_->fbo);
+    glViewport(0, 0, priv_->width, priv_->height);
+    glClearColor(c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (priv_->async) {
+        /* Copy out the oldest read before start() would drop it */
+        if (priv_->readback.pending() == priv_->readback.depth())
+            priv_->readback.finish(&priv_->pixels);
+        priv_->readback.start();
+    }
+    else {
+        uint64_t start = Util::get_timestamp_us();
+        priv_->pixels.resize(static_cast<size_t>(priv_->width) * priv_->height * 4);
+        glReadPixels(0, 0, priv_->width, priv_->height, GL_RGBA,
+                     GL_UNSIGNED_BYTE, priv_->pixels.data());
+        priv_->sync_latency += Util::get_timestamp_us() - start;
+        priv_->sync_bytes += priv_->pixels.size();
+    }
+
+    /* Show the frame color on the canvas too */
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, canvas_.fbo());
+    glViewport(0, 0, canvas_.width(), canvas_.height());
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    priv_->frame++;
+}
+
+Scene::ValidationResult
+SceneReadback::validate()
+{
+    if (priv_->frame == 0 || priv_->pixels.size() < 4)
+        return Scene::ValidationUnknown;
+
+    /* The pixels hold the contents of the newest frame */
+    Canvas::Pixel ref(priv_->color(priv_->frame - 1));
+    const uint8_t *p = priv_->pixels.data();
+    Canvas::Pixel pixel(p[0], p[1], p[2], p[3]);
+
+    if (pixel.to_le32() == ref.to_le32())
+        return Scene::ValidationSuccess;
+
+    Log::debug("Validation failed! Expected: 0x%x Actual: 0x%x\n",
+               ref.to_le32(), pixel.to_le32());
+    return Scene::ValidationFailure;
+}
@@ -0,0 +1,420 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+/*
+ * The shaders of a program in the corpus. The sources are ready to be
+ * compiled, apart from the line that makes each compiled copy unique.
+ */
+struct ShaderCompileVariant
+{
+    std::string vtx_shader;
+    std::string frg_shader;
+};
+
+struct SceneShaderCompilePrivate
+{
+    SceneShaderCompilePrivate() :
+        parallel(false), programs(0), run_id(0), next(0),
+        compile_time(0.0), failed(0) {}
+
+    bool parallel;
+    unsigned int programs;
+    std::vector<ShaderCompileVariant> corpus;
+    /* Keeps the sources unique across runs, to defeat on-disk shader caches */
+    uint64_t run_id;
+    /* The number of programs compiled so far */
+    unsigned int next;
+    /* The time spent compiling, and the latency of each program */
+    double compile_time;
+    std::vector<double> latencies;
+    unsigned int failed;
+};
+
+static const unsigned int corpus_steps[] = {1, 5, 20};
+
+/**
+ * Expands one of the templates used by the function, loop and conditionals
+ * scenes, the same way those scenes do.
+ *
+ * @param file the template, with the $MAIN$ and optional $PROCESS$ markers
+ * @param step_file the file appended to $MAIN$ for each step
+ * @param steps the number of steps
+ * @param process_file the file to replace $PROCESS$ with, if any
+ * @param nloops the replacement for the $NLOOPS$ marker of loop steps
+ */
+static std::string
+expand_template(const std::string &file, const std::string &step_file,
+                unsigned int steps, const std::string &process_file,
+                const std::string &nloops)
+{
+    ShaderSource source(Options::data_path + file);
+    ShaderSource source_main;
+
+    for (unsigned int i = 0; i < steps; i++)
+        source_main.append_file(Options::data_path + step_file);
+
+    if (!process_file.empty())
+        source.replace_with_file("$PROCESS$", Options::data_path + process_file);
+    else
+        source.replace("$PROCESS$", "");
+
+    source.replace("$MAIN$", source_main.str());
+    source.replace("$NLOOPS$", nloops);
+
+    return source.str();
+}
+
+static void
+add_template_variants(std::vector<ShaderCompileVariant> &corpus,
+                      const std::string &base, const std::string &step_file,
+                      const std::string &process_file = "",
+                      const std::string &vtx_loops = "",
+                      const std::string &frg_loops = "")
+{
+    for (unsigned int steps : corpus_steps) {
+        ShaderCompileVariant variant;
+        variant.vtx_shader = expand_template(base + ".vert", step_file, steps,
+                                             process_file,
+                                             vtx_loops.empty() ? Util::toString(steps) : vtx_loops);
+        variant.frg_shader = expand_template(base + ".frag", step_file, steps,
+                                             process_file,
+                                             frg_loops.empty() ? Util::toString(steps) : frg_loops);
+        corpus.push_back(variant);
+    }
+}
+
+/**
+ * Creates a box filter with the convolution shader of the effect-2d scene.
+ *
+ * @param size the width and height of the filter
+ */
+static ShaderCompileVariant
+create_convolution_variant(unsigned int size)
+{
+    ShaderSource vtx_source(Options::data_path + "/shaders/effect-2d.vert");
+    ShaderSource frg_source(Options::data_path + "/shaders/effect-2d-convolution.frag");
+
+    frg_source.add_const("TextureStepX", 1.0f / 1024.0f);
+    frg_source.add_const("TextureStepY", 1.0f / 1024.0f);
+
+    std::stringstream ss_def;
+    std::stringstream ss_convolution;
+
+    ss_def << std::fixed;
+    ss_convolution.precision(1);
+    ss_convolution << std::fixed;
+
+    ss_convolution << "result = ";
+
+    unsigned int count = size * size;
+    for (unsigned int i = 0; i < count; i++) {
+        ss_def << "const float Kernel" << i << " = "
+               << 1.0f / count << ";" << std::endl;
+
+        float x = static_cast<float>(i % size) - size / 2;
+        float y = static_cast<float>(size / 2) - i / size;
+        ss_convolution << "texture2D(Texture0, TextureCoord + vec2("
+                       << x << " * TextureStepX, "
+                       << y << " * TextureStepY)) * Kernel" << i;
+        if (i + 1 != count)
+            ss_convolution << " +" << std::endl;
+    }
+
+    ss_convolution << ";" << std::endl;
+
+    frg_source.add(ss_def.str());
+    frg_source.replace("$CONVOLUTION$", ss_convolution.str());
+
+    ShaderCompileVariant variant;
+    variant.vtx_shader = vtx_source.str();
+    variant.frg_shader = frg_source.str();
+    return variant;
+}
+
+static GLuint
+create_shader(GLenum type, const std::string &source)
+{
+    GLuint shader = glCreateShader(type);
+    const char *str = source.c_str();
+    glShaderSource(shader, 1, &str, 0);
+    glCompileShader(shader);
+    return shader;
+}
+
+/**
+ * Compiles and links a program without waiting for the result.
+ *
+ * The shaders are flagged for deletion right away, so that they are
+ * deleted along with the program.
+ */
+static GLuint
+submit_program(const std::string &vtx_shader, const std::string &frg_shader)
+{
+    GLuint program = glCreateProgram();
+    GLuint vtx = create_shader(GL_VERTEX_SHADER, vtx_shader);
+    GLuint frg = create_shader(GL_FRAGMENT_SHADER, frg_shader);
+
+    glAttachShader(program, vtx);
+    glAttachShader(program, frg);
+    glLinkProgram(program);
+    glDeleteShader(vtx);
+    glDeleteShader(frg);
+
+    return program;
+}
+
+SceneShaderCompile::SceneShaderCompile(Canvas &pCanvas) :
+    Scene(pCanvas, "shader-compile")
+{
+    priv_ = new SceneShaderCompilePrivate();
+    options_["mode"] = Scene::Option("mode", "serial",
+        "Whether to wait for each program before compiling the next one,"
+        " or to compile them in parallel with GL_KHR_parallel_shader_compile",
+        "serial,parallel");
+    options_["programs"] = Scene::Option("programs", "16",
+        "The number of programs to compile in each frame");
+    options_["corpus"] = Scene::Option("corpus", "all",
+        "The templates to create the programs from",
+        "all,function,loop,conditionals,effect-2d");
+}
+
+SceneShaderCompile::~SceneShaderCompile()
+{
+    delete priv_;
+}
+
+bool
+SceneShaderCompile::supported(bool show_errors)
+{
+    if (options_["mode"].value == "parallel" &&
+        (!GLExtensions::MaxShaderCompilerThreads ||
+         !(GLExtensions::support("GL_KHR_parallel_shader_compile") ||
+           GLExtensions::support("GL_ARB_parallel_shader_compile"))))
+    {
+        if (show_errors)
+            Log::error("GL_KHR_parallel_shader_compile is not supported!\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneShaderCompile::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    priv_->parallel = options_["mode"].value == "parallel";
+    priv_->programs = Util::fromString<unsigned int>(options_["programs"].value);
+    if (priv_->programs == 0) {
+        Log::error("The number of programs must be at least 1\n");
+        return false;
+    }
+
+    /* Create the corpus from the templates of the other scenes */
+    const std::string &corpus(options_["corpus"].value);
+    bool all = corpus == "all";
+    priv_->corpus.clear();
+
+    if (all || corpus == "function") {
+        for (const char *complexity : {"low", "medium"}) {
+            std::string step_file(std::string("/shaders/function-step-") +
+                                  complexity + ".all");
+            add_template_variants(priv_->corpus, "/shaders/function", step_file);
+            add_template_variants(priv_->corpus, "/shaders/function",
+                                  "/shaders/function-call.all", step_file);
+        }
+    }
+
+    if (all || corpus == "loop") {
+        add_template_variants(priv_->corpus, "/shaders/loop",
+                              "/shaders/loop-step-simple.all");
+        add_template_variants(priv_->corpus, "/shaders/loop",
+                              "/shaders/loop-step-loop.all");
+        add_template_variants(priv_->corpus, "/shaders/loop",
+                              "/shaders/loop-step-loop.all", "",
+                              "VertexLoops", "FragmentLoops");
+    }
+
+    if (all || corpus == "conditionals") {
+        add_template_variants(priv_->corpus, "/shaders/conditionals",
+                              "/shaders/conditionals-step-simple.all");
+        add_template_variants(priv_->corpus, "/shaders/conditionals",
+                              "/shaders/conditionals-step-conditional.all");
+    }
+
+    if (all || corpus == "effect-2d") {
+        for (unsigned int size = 3; size <= 9; size += 2)
+            priv_->corpus.push_back(create_convolution_variant(size));
+    }
+
+    if (priv_->corpus.empty()) {
+        Log::error("Unknown shader corpus '%s'\n", corpus.c_str());
+        return false;
+    }
+
+    Log::debug("Created a corpus of %u programs\n",
+               static_cast<unsigned int>(priv_->corpus.size()));
+
+    /* 0 disables parallel compilation, 0xffffffff lets the driver choose */
+    if (GLExtensions::MaxShaderCompilerThreads)
+        GLExtensions::MaxShaderCompilerThreads(priv_->parallel ? 0xffffffff : 0);
+
+    priv_->run_id = Util::get_timestamp_us();
+    priv_->next = 0;
+    priv_->compile_time = 0.0;
+    priv_->latencies.clear();
+    priv_->failed = 0;
+
+    return true;
+}
+
+void
+SceneShaderCompile::teardown()
+{
+    std::vector<double> &latencies(priv_->latencies);
+
+    if (priv_->compile_time > 0.0 && !latencies.empty()) {
+        add_metric("Shaders", "shader_rate",
+                   2.0 * latencies.size() / priv_->compile_time, "shaders/s", 1);
+
+        /* The latency that 99% of the programs were compiled within */
+        size_t p99 = (latencies.size() * 99 + 99) / 100 - 1;
+        std::nth_element(latencies.begin(), latencies.begin() + p99, latencies.end());
+        add_metric("LatencyP99", "latency_p99", 1000.0 * latencies[p99], "ms", 3);
+    }
+
+    if (GLExtensions::MaxShaderCompilerThreads)
+        GLExtensions::MaxShaderCompilerThreads(0xffffffff);
+
+    priv_->corpus.clear();
+
+    Scene::teardown();
+}
+
+void
+SceneShaderCompile::draw()
+{
+    /* Prepare the sources, so that only the compilation is timed */
+    std::vector<std::pair<std::string, std::string> > sources(priv_->programs);
+
+    for (auto &source : sources) {
+        const ShaderCompileVariant &variant(priv_->corpus[priv_->next % priv_->corpus.size()]);
+        std::stringstream ss;
+        ss << "#define GLMARK2_VARIANT " << priv_->run_id << "_" << priv_->next << std::endl;
+        source.first = ss.str() + variant.vtx_shader;
+        source.second = ss.str() + variant.frg_shader;
+        priv_->next++;
+    }
+
+    std::vector<GLuint> programs(priv_->programs);
+    std::vector<double> submitted(priv_->programs);
+    double start = Util::get_timestamp_us() / 1000000.0;
+
+    if (priv_->parallel) {
+        /*
+         * Submit all the programs, and then poll them, so that the driver
+         * can compile them in parallel. The latency of a program includes
+         * the time it waits for a compiler thread.
+         */
+        for (unsigned int i = 0; i < priv_->programs; i++) {
+            submitted[i] = Util::get_timestamp_us() / 1000000.0;
+            programs[i] = submit_program(sources[i].first, sources[i].second);
+        }
+
+        unsigned int pending = priv_->programs;
+        while (pending > 0) {
+            bool progress = false;
+            for (unsigned int i = 0; i < priv_->programs; i++) {
+                if (!programs[i])
+                    continue;
+
+                GLint done = GL_FALSE;
+                glGetProgramiv(programs[i], GL_COMPLETION_STATUS_KHR, &done);
+                if (done == GL_FALSE)
+                    continue;
+
+                priv_->latencies.push_back(Util::get_timestamp_us() / 1000000.0 -
+                                           submitted[i]);
+                check_program(programs[i]);
+                glDeleteProgram(programs[i]);
+                programs[i] = 0;
+                pending--;
+                progress = true;
+            }
+
+            if (!progress)
+                std::this_thread::yield();
+        }
+    }
+    else {
+        /* Querying the link status waits for the program to be ready */
+        for (unsigned int i = 0; i < priv_->programs; i++) {
+            double program_start = Util::get_timestamp_us() / 1000000.0;
+            programs[i] = submit_program(sources[i].first, sources[i].second);
+            check_program(programs[i]);
+            priv_->latencies.push_back(Util::get_timestamp_us() / 1000000.0 -
+                                       program_start);
+            glDeleteProgram(programs[i]);
+        }
+    }
+
+    priv_->compile_time += Util::get_timestamp_us() / 1000000.0 - start;
+}
+
+/**
+ * Checks that a program linked, logging the errors of the first one that
+ * didn't.
+ */
+void
+SceneShaderCompile::check_program(unsigned int program)
+{
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == GL_TRUE)
+        return;
+
+    if (priv_->failed++ == 0) {
+        char log[1024] = "";
+        glGetProgramInfoLog(program, sizeof(log), 0, log);
+        Log::error("Failed to link a program of the shader corpus: %s\n", log);
+    }
+}
+
+Scene::ValidationResult
+SceneShaderCompile::validate()
+{
+    if (priv_->latencies.empty())
+        return Scene::ValidationUnknown;
+
+    return priv_->failed == 0 ? Scene::ValidationSuccess : Scene::ValidationFailure;
+}
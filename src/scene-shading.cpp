@@ -41,7 +41,10 @@ using std::endl;
 
 SceneShading::SceneShading(Canvas &pCanvas) :
     Scene(pCanvas, "shading"),
-    orientModel_(false)
+    modelViewProjectionHandle_(0), normalMatrixHandle_(0),
+    modelViewHandle_(0), useUniformBuffer_(false),
+    modelViewProjectionOffset_(0), normalMatrixOffset_(0),
+    modelViewOffset_(0), orientModel_(false)
 {
     const ModelMap& modelMap = Model::find_models();
     std::string optionValues;
@@ -65,12 +68,34 @@ SceneShading::SceneShading(Canvas &pCanvas) :
             "The number of lights applied to the scene (phong only)");
     options_["model"] = Scene::Option("model", "cat", "Which model to use",
                                       optionValues);
+    options_["uniform-path"] = Scene::Option("uniform-path", "classic",
+                                             "How to load the per-frame matrices",
+                                             "classic,ubo");
+    options_["ubo-update"] = Scene::Option("ubo-update", "subdata",
+                                           "How to update the uniform buffer (ubo path only)",
+                                           "subdata,map");
 }
 
 SceneShading::~SceneShading()
 {
 }
 
+bool
+SceneShading::supported(bool show_errors)
+{
+    if (options_["uniform-path"].value == "ubo" &&
+        !Scene::uniform_buffers_supported())
+    {
+        if (show_errors) {
+            Log::error("Requested the ubo uniform path but uniform buffers"
+                       " (GL 3.1 or GLES 3.0) are not supported!\n");
+        }
+        return false;
+    }
+
+    return true;
+}
+
 bool
 SceneShading::load()
 {
@@ -147,8 +172,8 @@ SceneShading::setup()
     std::string vtx_shader_filename;
     std::string frg_shader_filename;
     const std::string &shading = options_["shading"].value;
-    ShaderSource vtx_source;
-    ShaderSource frg_source;
+    ShaderSource vtx_source(ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(ShaderSource::ShaderTypeFragment);
     if (shading == "gouraud") {
         vtx_shader_filename = Options::data_path + "/shaders/light-basic.vert";
         frg_shader_filename = Options::data_path + "/shaders/light-basic.frag";
@@ -181,12 +206,44 @@ SceneShading::setup()
         frg_source.append_file(frg_shader_filename);
     }
 
+    // Move the matrices into a uniform block, for the ubo uniform path
+    useUniformBuffer_ = (options_["uniform-path"].value == "ubo");
+    if (useUniformBuffer_) {
+        std::vector<std::string> members;
+        members.push_back("mat4 ModelViewProjectionMatrix");
+        members.push_back("mat4 NormalMatrix");
+        members.push_back("mat4 ModelViewMatrix");
+
+        for (ShaderSource *source : {&vtx_source, &frg_source}) {
+            source->version(Scene::glsl_version(140, 300));
+            source->modernize();
+            source->uniform_block("Transform", members);
+        }
+    }
+
     if (!Scene::load_shaders_from_strings(program_, vtx_source.str(),
                                           frg_source.str()))
     {
         return false;
     }
 
+    if (useUniformBuffer_) {
+        UniformBlockLayout layout;
+        modelViewProjectionOffset_ = layout.addMat4();
+        normalMatrixOffset_ = layout.addMat4();
+        modelViewOffset_ = layout.addMat4();
+
+        UniformBuffer::UpdateMethod method =
+            options_["ubo-update"].value == "map" ? UniformBuffer::UpdateMapRing :
+                                                    UniformBuffer::UpdateSubData;
+        if (!transformBuffer_.init(layout, 0, method) ||
+            !program_.uniformBlockBinding("Transform", 0))
+        {
+            Log::error("Failed to set up the uniform buffer\n");
+            return false;
+        }
+    }
+
     Model model;
     const std::string& whichModel(options_["model"].value);
     bool modelLoaded = model.load(whichModel);
@@ -256,6 +313,10 @@ SceneShading::setup()
     attrib_locations.push_back(program_["normal"].location());
     mesh_.set_attrib_locations(attrib_locations);
 
+    modelViewProjectionHandle_ = program_.symbolHandle("ModelViewProjectionMatrix");
+    normalMatrixHandle_ = program_.symbolHandle("NormalMatrix");
+    modelViewHandle_ = program_.symbolHandle("ModelViewMatrix");
+
     rotation_ = 0.0f;
 
     return true;
@@ -264,6 +325,7 @@ SceneShading::setup()
 void
 SceneShading::teardown()
 {
+    transformBuffer_.release();
     program_.stop();
     program_.release();
 }
@@ -279,7 +341,7 @@ SceneShading::update()
 void
 SceneShading::draw()
 {
-    // Load the ModelViewProjectionMatrix uniform in the shader
+    // Calculate the matrices to load into the shader
     LibMatrix::Stack4 model_view;
     model_view.translate(-centerVec_.x(), -centerVec_.y(), -(centerVec_.z() + 2.0 + radius_));
     model_view.rotate(rotation_, 0.0f, 1.0f, 0.0f);
@@ -290,16 +352,21 @@ SceneShading::draw()
     LibMatrix::mat4 model_view_proj(perspective_);
     model_view_proj *= model_view.getCurrent();
 
-    program_["ModelViewProjectionMatrix"] = model_view_proj;
-
-    // Load the NormalMatrix uniform in the shader. The NormalMatrix is the
-    // inverse transpose of the model view matrix.
+    // The NormalMatrix is the inverse transpose of the model view matrix.
     LibMatrix::mat4 normal_matrix(model_view.getCurrent());
     normal_matrix.inverse().transpose();
-    program_["NormalMatrix"] = normal_matrix;
 
-    // Load the modelview matrix itself
-    program_["ModelViewMatrix"] = model_view.getCurrent();
+    if (useUniformBuffer_) {
+        transformBuffer_.set(modelViewProjectionOffset_, model_view_proj);
+        transformBuffer_.set(normalMatrixOffset_, normal_matrix);
+        transformBuffer_.set(modelViewOffset_, model_view.getCurrent());
+        transformBuffer_.update();
+    }
+    else {
+        program_[modelViewProjectionHandle_] = model_view_proj;
+        program_[normalMatrixHandle_] = normal_matrix;
+        program_[modelViewHandle_] = model_view.getCurrent();
+    }
 
     mesh_.render_vbo();
 }
@@ -486,6 +486,14 @@ SceneShadow::SceneShadow(Canvas& canvas) :
                                            "false,true");
 }
 
+void
+SceneShadow::assets(const std::map<std::string, std::string> &values,
+                    Assets &assets) const
+{
+    (void)values;
+    assets.models.push_back("horse");
+}
+
 bool
 SceneShadow::supported(bool show_errors)
 {
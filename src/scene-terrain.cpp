@@ -234,6 +234,16 @@ SceneTerrain::~SceneTerrain()
     delete priv_;
 }
 
+void
+SceneTerrain::assets(const std::map<std::string, std::string> &values,
+                      Assets &assets) const
+{
+    (void)values;
+    assets.textures.push_back("terrain-grasslight-512");
+    assets.textures.push_back("terrain-backgrounddetailed6");
+    assets.textures.push_back("terrain-grasslight-512-nm");
+}
+
 bool
 SceneTerrain::supported(bool show_errors)
 {
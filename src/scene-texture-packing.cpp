@@ -0,0 +1,310 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scene.h"
+#include "texture-packer.h"
+#include "mesh.h"
+#include "options.h"
+#include "shader-source.h"
+#include "log.h"
+#include "util.h"
+#include "gl-headers.h"
+
+#include <cmath>
+#include <vector>
+
+struct SceneTexturePackingPrivate
+{
+    enum Mode {
+        ModeBinds,
+        ModeAtlas,
+        ModeArray,
+    };
+
+    SceneTexturePackingPrivate() :
+        mode(ModeAtlas), batched(true), packed_texture(0) {}
+
+    /**
+     * Creates a distinct image for a texture.
+     *
+     * The images have different sizes and checkerboard patterns, so that
+     * packing them is not trivial and mistakes are easy to spot.
+     */
+    static void create_image(unsigned int index, unsigned int &width,
+                             unsigned int &height, std::vector<uint8_t> &pixels)
+    {
+        width = 32 + (index * 7) % 33;
+        height = 32 + (index * 13) % 33;
+        unsigned int cell = 4 + index % 5;
+
+        uint8_t c0[3] = {static_cast<uint8_t>(index * 37),
+                         static_cast<uint8_t>(index * 101),
+                         static_cast<uint8_t>(index * 211)};
+        uint8_t c1[3] = {static_cast<uint8_t>(255 - c0[0]),
+                         static_cast<uint8_t>(255 - c0[1]),
+                         static_cast<uint8_t>(255 - c0[2])};
+
+        pixels.resize(static_cast<size_t>(width) * height * 4);
+
+        for (unsigned int y = 0; y < height; y++) {
+            for (unsigned int x = 0; x < width; x++) {
+                const uint8_t *c = ((x / cell + y / cell) & 1) ? c1 : c0;
+                uint8_t *p = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+                p[0] = c[0];
+                p[1] = c[1];
+                p[2] = c[2];
+                p[3] = 0xff;
+            }
+        }
+    }
+
+    static void bind_texture(size_t range, void *data)
+    {
+        SceneTexturePackingPrivate *priv =
+            static_cast<SceneTexturePackingPrivate *>(data);
+        glBindTexture(GL_TEXTURE_2D, priv->textures[range % priv->textures.size()]);
+    }
+
+    Mode mode;
+    bool batched;
+    Program program;
+    Mesh mesh;
+    std::vector<GLuint> textures;
+    GLuint packed_texture;
+};
+
+SceneTexturePacking::SceneTexturePacking(Canvas &pCanvas) :
+    Scene(pCanvas, "texture-packing")
+{
+    priv_ = new SceneTexturePackingPrivate();
+    options_["mode"] = Scene::Option("mode", "atlas",
+                                     "How to provide the textures: a separate texture"
+                                     " bound for each quad, an atlas, an array texture,"
+                                     " or whichever of the last two suits the textures",
+                                     "binds,atlas,array,auto");
+    options_["draw"] = Scene::Option("draw", "batched",
+                                     "Whether to draw all quads in one call or each"
+                                     " quad separately (atlas and array modes only)",
+                                     "batched,per-quad");
+    options_["quads"] = Scene::Option("quads", "4096",
+                                      "The number of textured quads to draw");
+    options_["textures"] = Scene::Option("textures", "256",
+                                         "The number of distinct textures");
+}
+
+SceneTexturePacking::~SceneTexturePacking()
+{
+    delete priv_;
+}
+
+bool
+SceneTexturePacking::supported(bool show_errors)
+{
+    if (options_["mode"].value == "array" && !TexturePacker::supports_array()) {
+        if (show_errors) {
+            Log::error("Requested array texture mode but array textures"
+                       " (GL 3.0 or GLES 3.0) are not supported!\n");
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SceneTexturePacking::setup()
+{
+    if (!Scene::setup())
+        return false;
+
+    const std::string &mode = options_["mode"].value;
+    bool auto_mode = mode == "auto";
+    if (mode == "binds")
+        priv_->mode = SceneTexturePackingPrivate::ModeBinds;
+    else if (mode == "array")
+        priv_->mode = SceneTexturePackingPrivate::ModeArray;
+    else
+        priv_->mode = SceneTexturePackingPrivate::ModeAtlas;
+
+    priv_->batched = priv_->mode != SceneTexturePackingPrivate::ModeBinds &&
+                     options_["draw"].value != "per-quad";
+
+    unsigned int nquads = Util::fromString<unsigned int>(options_["quads"].value);
+    unsigned int ntextures = Util::fromString<unsigned int>(options_["textures"].value);
+    if (nquads == 0 || ntextures == 0) {
+        Log::error("The number of quads and textures must be positive\n");
+        return false;
+    }
+
+    /* Create the texture images */
+    std::vector<std::vector<uint8_t> > images(ntextures);
+    std::vector<unsigned int> widths(ntextures);
+    std::vector<unsigned int> heights(ntextures);
+    for (unsigned int i = 0; i < ntextures; i++)
+        SceneTexturePackingPrivate::create_image(i, widths[i], heights[i], images[i]);
+
+    TexturePacker packer;
+
+    if (priv_->mode == SceneTexturePackingPrivate::ModeBinds) {
+        priv_->textures.resize(ntextures);
+        glGenTextures(ntextures, priv_->textures.data());
+        for (unsigned int i = 0; i < ntextures; i++) {
+            glBindTexture(GL_TEXTURE_2D, priv_->textures[i]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, widths[i], heights[i], 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, images[i].data());
+        }
+    }
+    else {
+        for (unsigned int i = 0; i < ntextures; i++)
+            packer.add(widths[i], heights[i], images[i].data());
+
+        TexturePacker::Mode packer_mode =
+            auto_mode ? TexturePacker::ModeAuto :
+            priv_->mode == SceneTexturePackingPrivate::ModeArray ?
+            TexturePacker::ModeArray : TexturePacker::ModeAtlas;
+
+        if (!packer.pack(packer_mode, &priv_->packed_texture)) {
+            Log::error("Failed to pack %u textures\n", ntextures);
+            return false;
+        }
+
+        if (packer.mode() == TexturePacker::ModeArray)
+            priv_->mode = SceneTexturePackingPrivate::ModeArray;
+
+        Log::debug("Packed %u textures in %ux%ux%u texels (%.1f%% occupied)\n",
+                   ntextures, packer.width(), packer.height(), packer.layers(),
+                   100.0 * packer.occupancy());
+    }
+
+    /* Load the shaders */
+    bool array = priv_->mode == SceneTexturePackingPrivate::ModeArray;
+    std::string shader_name(Options::data_path + "/shaders/texture-packing" +
+                            (array ? "-array" : ""));
+    ShaderSource vtx_source(shader_name + ".vert", ShaderSource::ShaderTypeVertex);
+    ShaderSource frg_source(shader_name + ".frag", ShaderSource::ShaderTypeFragment);
+
+    if (array) {
+        vtx_source.version(Scene::glsl_version(130, 300));
+        frg_source.version(Scene::glsl_version(130, 300));
+    }
+
+    if (!Scene::load_shaders_from_strings(priv_->program, vtx_source.str(),
+                                          frg_source.str()))
+    {
+        return false;
+    }
+
+    /* Create the quads, in a grid that covers the whole canvas */
+    std::vector<int> vertex_format;
+    vertex_format.push_back(3);     // Position
+    vertex_format.push_back(3);     // Texture coordinates and array layer
+    priv_->mesh.set_vertex_format(vertex_format);
+
+    unsigned int n_x = static_cast<unsigned int>(std::ceil(std::sqrt(nquads)));
+    unsigned int n_y = (nquads + n_x - 1) / n_x;
+    float cell_w = 2.0f / n_x;
+    float cell_h = 2.0f / n_y;
+    float quad_w = 0.9f * cell_w;
+    float quad_h = 0.9f * cell_h;
+
+    for (unsigned int i = 0; i < nquads; i++) {
+        float x = -1.0f + (i % n_x) * cell_w;
+        float y = 1.0f - (i / n_x + 1) * cell_h;
+        float layer = 0.0f;
+        unsigned int texture = i % ntextures;
+
+        if (array)
+            layer = packer.region(texture).layer;
+
+        LibMatrix::vec3 pos[4] = {
+            LibMatrix::vec3(x, y + quad_h, 0.0),            // upper left
+            LibMatrix::vec3(x, y, 0.0),                     // lower left
+            LibMatrix::vec3(x + quad_w, y + quad_h, 0.0),   // upper right
+            LibMatrix::vec3(x + quad_w, y, 0.0),            // lower right
+        };
+        LibMatrix::vec3 tc[4] = {
+            LibMatrix::vec3(0.0, 1.0, layer),
+            LibMatrix::vec3(0.0, 0.0, layer),
+            LibMatrix::vec3(1.0, 1.0, layer),
+            LibMatrix::vec3(1.0, 0.0, layer),
+        };
+        static const int order[6] = {0, 1, 2, 1, 3, 2};
+
+        for (int v : order) {
+            priv_->mesh.next_vertex();
+            priv_->mesh.set_attrib(0, pos[v]);
+            priv_->mesh.set_attrib(1, tc[v]);
+        }
+
+        if (priv_->mode != SceneTexturePackingPrivate::ModeBinds) {
+            const TexturePacker::Region &region = packer.region(texture);
+            priv_->mesh.remap_texcoords(1, region.offset, region.scale, 6 * i, 6);
+        }
+    }
+
+    priv_->mesh.build_vbo();
+
+    std::vector<GLint> attrib_locations;
+    attrib_locations.push_back(priv_->program["position"].location());
+    attrib_locations.push_back(priv_->program["texcoord"].location());
+    priv_->mesh.set_attrib_locations(attrib_locations);
+
+    priv_->program.start();
+    priv_->program["Texture0"] = 0;
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(array ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, priv_->packed_texture);
+
+    return true;
+}
+
+void
+SceneTexturePacking::teardown()
+{
+    priv_->mesh.reset();
+
+    priv_->program.stop();
+    priv_->program.release();
+
+    if (!priv_->textures.empty()) {
+        glDeleteTextures(priv_->textures.size(), priv_->textures.data());
+        priv_->textures.clear();
+    }
+
+    if (priv_->packed_texture) {
+        glDeleteTextures(1, &priv_->packed_texture);
+        priv_->packed_texture = 0;
+    }
+
+    Scene::teardown();
+}
+
+void
+SceneTexturePacking::draw()
+{
+    if (priv_->mode == SceneTexturePackingPrivate::ModeBinds)
+        priv_->mesh.render_vbo(6, SceneTexturePackingPrivate::bind_texture, priv_);
+    else if (priv_->batched)
+        priv_->mesh.render_vbo();
+    else
+        priv_->mesh.render_vbo(6, 0, 0);
+}
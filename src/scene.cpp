@@ -22,6 +22,7 @@
  *  Alexandros Frantzis (glmark2)
  */
 #include "scene.h"
+#include "asset-prefetcher.h"
 #include "log.h"
 #include "shader-source.h"
 #include "options.h"
@@ -33,7 +34,10 @@ using std::stringstream;
 using std::string;
 using std::map;
 
-double Scene::shaderCompilationTime_ = 0.0;
+thread_local double Scene::shaderCompilationTime_ = 0.0;
+thread_local double Scene::shaderCacheTime_ = 0.0;
+thread_local unsigned int Scene::shaderCacheHits_ = 0;
+thread_local unsigned int Scene::shaderCacheMisses_ = 0;
 
 Scene::Option::Option(const std::string &nam, const std::string &val, const std::string &desc,
                       const std::string &values) :
@@ -42,12 +46,28 @@ name(nam), value(val), default_value(val), description(desc), set(false)
     Util::split(values, ',', acceptable_values, Util::SplitModeNormal);
 }
 
+Scene::Metric::Metric(const std::string &name, const std::string &field,
+                      double value, const std::string &unit, int precision) :
+    name(name), field(field), value(Util::toString(value, precision)), unit(unit)
+{
+}
+
 Scene::Scene(Canvas &pCanvas, const string &name) :
     canvas_(pCanvas), name_(name),
-    currentFrame_(0), running_(0), duration_(0), nframes_(0)
+    currentFrame_(0), running_(0), duration_(0), nframes_(0),
+    autoDuration_(false), targetPrecision_(0), minDuration_(0), maxDuration_(0)
 {
     options_["duration"] = Scene::Option("duration", "10.0",
-                                         "The duration of each benchmark in seconds");
+                                         "The duration of each benchmark in seconds, or 'auto' "
+                                         "to run until the mean frame time is known with the "
+                                         "requested precision");
+    options_["precision"] = Scene::Option("precision", "1%",
+                                          "The relative error of the mean frame time to reach "
+                                          "with duration=auto, at 95% confidence");
+    options_["min-duration"] = Scene::Option("min-duration", "2.0",
+                                             "The minimum duration in seconds with duration=auto");
+    options_["max-duration"] = Scene::Option("max-duration", "30.0",
+                                             "The maximum duration in seconds with duration=auto");
     options_["nframes"] = Scene::Option("nframes", "",
                                          "The number of frames to render");
     options_["vertex-precision"] = Scene::Option("vertex-precision",
@@ -109,12 +129,28 @@ Scene::teardown()
 void
 Scene::update()
 {
-    realTime_.lastUpdate = Util::get_timestamp_us() / 1000000.0;
+    double now = Util::get_timestamp_us() / 1000000.0;
+
+    frameTimes_.add(now - realTime_.lastUpdate);
+    realTime_.lastUpdate = now;
 
     currentFrame_++;
 
-    if (realTime_.elapsed() >= duration_)
+    if (autoDuration_) {
+        /* Enough batches for the confidence interval to be meaningful */
+        static const unsigned int min_batches = 5;
+        double elapsed = realTime_.elapsed();
+
+        if (elapsed >= maxDuration_ ||
+            (elapsed >= minDuration_ && frameTimes_.batches >= min_batches &&
+             frameTimes_.relative_error() <= targetPrecision_))
+        {
+            running_ = false;
+        }
+    }
+    else if (realTime_.elapsed() >= duration_) {
         running_ = false;
+    }
 
     if (nframes_ > 0 && currentFrame_ >= nframes_)
         running_ = false;
@@ -147,6 +183,7 @@ Scene::stats()
     Stats stats;
     int nproc = Util::get_num_processors();
 
+    stats.elapsed_time = realTime_.elapsed();
     stats.average_frame_time = realTime_.elapsed() / currentFrame_;
     stats.average_user_time = userTime_.elapsed() / currentFrame_;
     stats.average_system_time = systemTime_.elapsed() / currentFrame_;
@@ -156,10 +193,33 @@ Scene::stats()
         stats.cpu_busy_percent = 1.0 - idleTime_.elapsed() /
                                        (nproc * realTime_.elapsed());
     stats.shader_compilation_time = shaderCompilationTime_;
+    stats.shader_cache_time = shaderCacheTime_;
+    stats.shader_cache_hits = shaderCacheHits_;
+    stats.shader_cache_misses = shaderCacheMisses_;
+    stats.metrics = metrics_;
 
     return stats;
 }
 
+void
+Scene::add_metric(const std::string &name, const std::string &field,
+                  double value, const std::string &unit, int precision)
+{
+    metrics_.push_back(Metric(name, field, value, unit, precision));
+}
+
+void
+Scene::assets(const map<string, string> &values, Assets &assets) const
+{
+    map<string, string>::const_iterator iter = values.find("model");
+    if (iter != values.end())
+        assets.models.push_back(iter->second);
+
+    iter = values.find("texture");
+    if (iter != values.end())
+        assets.textures.push_back(iter->second);
+}
+
 bool
 Scene::set_option(const string &opt, const string &val)
 {
@@ -220,8 +280,14 @@ Scene::set_option_default(const string &opt, const string &val)
 bool
 Scene::prepare()
 {
-    duration_ = Util::fromString<double>(options_["duration"].value);
+    autoDuration_ = options_["duration"].value == "auto";
+    duration_ = autoDuration_ ? 0.0 : Util::fromString<double>(options_["duration"].value);
     nframes_ = Util::fromString<unsigned>(options_["nframes"].value);
+    /* The precision is a percentage, with an optional '%' */
+    targetPrecision_ = Util::fromString<double>(options_["precision"].value) / 100.0;
+    minDuration_ = Util::fromString<double>(options_["min-duration"].value);
+    maxDuration_ = Util::fromString<double>(options_["max-duration"].value);
+    frameTimes_.reset();
 
     ShaderSource::default_precision(
             ShaderSource::Precision(options_["vertex-precision"].value),
@@ -239,6 +305,10 @@ Scene::prepare()
     userTime_.start = userTime_.lastUpdate = 0;
     systemTime_.start = systemTime_.lastUpdate = 0;
     shaderCompilationTime_ = 0.0;
+    shaderCacheTime_ = 0.0;
+    shaderCacheHits_ = 0;
+    shaderCacheMisses_ = 0;
+    metrics_.clear();
 
     if (!supported(true))
         return false;
@@ -262,6 +332,11 @@ Scene::finish()
     update_elapsed_times();
     teardown();
     unload();
+
+    if (autoDuration_ && currentFrame_ > 0) {
+        add_metric("Duration", "duration", realTime_.elapsed(), "s", 2);
+        add_metric("Precision", "precision", 100.0 * frameTimes_.relative_error(), "%", 2);
+    }
 }
 
 string
@@ -295,6 +370,33 @@ Scene::construct_title(const string &title)
 
 }
 
+std::string
+Scene::glsl_version(unsigned int gl, unsigned int gles)
+{
+#if GLMARK2_USE_GLESv2
+    static_cast<void>(gl);
+    return Util::toString(gles) + " es";
+#else
+    static_cast<void>(gles);
+    if (GLExtensions::is_core_profile())
+        gl = std::max(gl, 330u);
+    return Util::toString(gl);
+#endif
+}
+
+bool
+Scene::uniform_buffers_supported()
+{
+#if GLMARK2_USE_GLESv2
+    bool version_ok = GLExtensions::version_at_least(3, 0);
+#else
+    bool version_ok = GLExtensions::version_at_least(3, 1);
+#endif
+
+    return version_ok && GLExtensions::GetUniformBlockIndex &&
+           GLExtensions::UniformBlockBinding && GLExtensions::BindBufferRange;
+}
+
 bool
 Scene::load_shaders_from_strings(Program &program,
                                  const std::string &vtx_shader,
@@ -302,10 +404,16 @@ Scene::load_shaders_from_strings(Program &program,
                                  const std::string &vtx_shader_filename,
                                  const std::string &frg_shader_filename)
 {
-    double shaderStartTime = Util::get_timestamp_us() / 1000000.0;
+    ProgramCache::Shaders shaders{{GL_VERTEX_SHADER, vtx_shader},
+                                  {GL_FRAGMENT_SHADER, frg_shader}};
 
     program.init();
 
+    if (load_cached_program(program, shaders))
+        return true;
+
+    double shaderStartTime = Util::get_timestamp_us() / 1000000.0;
+
     Log::debug("Loading vertex shader from file %s:\n%s",
                vtx_shader_filename.c_str(), vtx_shader.c_str());
 
@@ -342,13 +450,108 @@ Scene::load_shaders_from_strings(Program &program,
 
     shaderCompilationTime_ += Util::get_timestamp_us() / 1000000.0 - shaderStartTime;
 
+    store_cached_program(program, shaders);
+
+    return true;
+}
+
+bool
+Scene::load_compute_shader_from_string(Program &program,
+                                       const std::string &shader,
+                                       const std::string &shader_filename)
+{
+    ProgramCache::Shaders shaders{{GL_COMPUTE_SHADER, shader}};
+
+    program.init();
+
+    if (load_cached_program(program, shaders))
+        return true;
+
+    double shaderStartTime = Util::get_timestamp_us() / 1000000.0;
+
+    Log::debug("Loading compute shader from file %s:\n%s",
+               shader_filename.c_str(), shader.c_str());
+
+    program.addShader(GL_COMPUTE_SHADER, shader);
+    if (!program.valid()) {
+        Log::error("Failed to add compute shader from file %s:\n  %s\n",
+                   shader_filename.c_str(),
+                   program.errorMessage().c_str());
+        program.release();
+        return false;
+    }
+
+    program.build();
+    if (!program.ready()) {
+        Log::error("Failed to link program created from file %s:  %s\n",
+                   shader_filename.c_str(),
+                   program.errorMessage().c_str());
+        program.release();
+        return false;
+    }
+
+    shaderCompilationTime_ += Util::get_timestamp_us() / 1000000.0 - shaderStartTime;
+
+    store_cached_program(program, shaders);
+
     return true;
 }
 
+/**
+ * Loads a program from the program binary cache, if the cache is enabled.
+ *
+ * The time spent in the cache is accounted separately from the shader
+ * compilation time.
+ *
+ * @return whether the program was loaded from the cache
+ */
+bool
+Scene::load_cached_program(Program &program, const ProgramCache::Shaders &shaders)
+{
+    if (!ProgramCache::enabled())
+        return false;
+
+    double startTime = Util::get_timestamp_us() / 1000000.0;
+    bool hit = ProgramCache::load(program, shaders);
+    shaderCacheTime_ += Util::get_timestamp_us() / 1000000.0 - startTime;
+
+    if (hit)
+        shaderCacheHits_++;
+    else
+        shaderCacheMisses_++;
+
+    return hit;
+}
+
+/**
+ * Stores a newly built program in the program binary cache, if the cache
+ * is enabled.
+ */
+void
+Scene::store_cached_program(Program &program, const ProgramCache::Shaders &shaders)
+{
+    if (!ProgramCache::enabled())
+        return;
+
+    double startTime = Util::get_timestamp_us() / 1000000.0;
+    ProgramCache::store(program, shaders);
+    shaderCacheTime_ += Util::get_timestamp_us() / 1000000.0 - startTime;
+}
+
 void
 Scene::update_elapsed_times()
 {
     realTime_.lastUpdate = Util::get_timestamp_us() / 1000000.0;
     Util::get_process_times(&userTime_.lastUpdate, &systemTime_.lastUpdate);
     idleTime_.lastUpdate = Util::get_idle_time();
+
+    /*
+     * Leave out the time used to prepare the assets of the next benchmark,
+     * as if the CPU had been idle instead.
+     */
+    double prefetch_user, prefetch_system;
+    AssetPrefetcher::cpu_times(&prefetch_user, &prefetch_system);
+    userTime_.lastUpdate -= prefetch_user;
+    systemTime_.lastUpdate -= prefetch_system;
+    idleTime_.lastUpdate += prefetch_user + prefetch_system;
 }
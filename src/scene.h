@@ -31,8 +31,10 @@
 #include "mesh.h"
 #include "vec.h"
 #include "program.h"
+#include "program-cache.h"
 
 #include <math.h>
+#include <cmath>
 
 #include <string>
 #include <map>
@@ -40,6 +42,8 @@
 #include <vector>
 #include "canvas.h"
 
+class ShaderSource;
+
 /**
  * A configurable scene used for creating benchmarks.
  */
@@ -64,12 +68,30 @@ public:
         bool set;
     };
 
+    /**
+     * A scene-specific result, reported along with the common statistics.
+     */
+    struct Metric {
+        Metric(const std::string &name, const std::string &field,
+               double value, const std::string &unit, int precision = 3);
+
+        std::string name;   // The name shown in the log, e.g. "Bandwidth"
+        std::string field;  // The name of the results file field
+        std::string value;
+        std::string unit;
+    };
+
     struct Stats {
+        double elapsed_time;
         double average_frame_time;
         double average_user_time;
         double average_system_time;
         double cpu_busy_percent;
         double shader_compilation_time;
+        double shader_cache_time;
+        unsigned int shader_cache_hits;
+        unsigned int shader_cache_misses;
+        std::vector<Metric> metrics;
     };
 
     /**
@@ -126,6 +148,30 @@ public:
      */
     virtual ValidationResult validate() { return ValidationUnknown; }
 
+    /**
+     * The assets that a scene loads in its setup.
+     */
+    struct Assets {
+        std::vector<std::string> models;
+        std::vector<std::string> textures;
+        /* Other data files, which only need to be read */
+        std::vector<std::string> files;
+    };
+
+    /**
+     * Gets the assets this scene loads when set up with some option values.
+     *
+     * This is used to prepare the assets in the background, before the
+     * scene runs, so it must not use the current options of the scene.
+     * The default implementation returns the models and textures chosen
+     * with the "model" and "texture" options, if the scene has them.
+     *
+     * @param values the option values to set up the scene with
+     * @param assets the assets to add to
+     */
+    virtual void assets(const std::map<std::string, std::string> &values,
+                        Assets &assets) const;
+
     /**
      * Gets whether this scene is running.
      *
@@ -209,6 +255,36 @@ public:
                                           const std::string &vtx_shader_filename = "None",
                                           const std::string &frg_shader_filename = "None");
 
+    /**
+     * Loads a shader program from a compute shader string.
+     *
+     * @return whether the operation succeeded
+     */
+    static bool load_compute_shader_from_string(Program &program,
+                                                const std::string &shader,
+                                                const std::string &shader_filename = "None");
+
+    /**
+     * Gets the GLSL version a shader should declare (see ShaderSource::version()).
+     *
+     * Desktop GL core profile contexts don't support GLSL versions before
+     * 3.30 in practice, so 3.30 is used as the minimum in such contexts.
+     *
+     * @param gl the GLSL version needed with desktop GL (e.g. 130)
+     * @param gles the GLSL ES version needed with GLES (e.g. 300)
+     *
+     * @return the version string, e.g. "130" or "300 es"
+     */
+    static std::string glsl_version(unsigned int gl, unsigned int gles);
+
+    /**
+     * Checks whether uniform buffer objects are supported (GL 3.1 or
+     * GLES 3.0).
+     *
+     * @return whether uniform buffers are supported
+     */
+    static bool uniform_buffers_supported();
+
 protected:
     Scene(Canvas &pCanvas, const std::string &name);
     std::string construct_title(const std::string &title);
@@ -262,7 +338,72 @@ protected:
         double elapsed() { return lastUpdate - start; }
     };
 
-    static double shaderCompilationTime_;
+    /**
+     * Running statistics of the frame times, using Welford's algorithm on
+     * the means of fixed-size batches of frames.
+     *
+     * Consecutive frame times are correlated, so the batch means, which
+     * are close to independent, give an honest confidence interval.
+     */
+    struct FrameTimeStats {
+        /* The number of frames in each batch */
+        static const unsigned int batch_size = 16;
+
+        unsigned int count = 0;
+        unsigned int batches = 0;
+        double batch_sum = 0.0;
+        double mean = 0.0;
+        double m2 = 0.0;
+
+        void reset() { count = 0; batches = 0; batch_sum = 0.0; mean = 0.0; m2 = 0.0; }
+
+        void add(double frame_time)
+        {
+            count++;
+            batch_sum += frame_time;
+            if (count % batch_size != 0)
+                return;
+
+            double batch_mean = batch_sum / batch_size;
+            batch_sum = 0.0;
+            batches++;
+            double delta = batch_mean - mean;
+            mean += delta / batches;
+            m2 += delta * (batch_mean - mean);
+        }
+
+        /**
+         * Gets the half-width of the 95% confidence interval of the mean
+         * frame time, relative to the mean, from the complete batches.
+         */
+        double relative_error() const
+        {
+            if (batches < 2 || mean <= 0.0)
+                return HUGE_VAL;
+
+            /* Student's t quantile, by its Cornish-Fisher expansion */
+            const double z = 1.96;
+            double df = batches - 1;
+            double t = z + (z * z * z + z) / (4.0 * df) +
+                       (5.0 * std::pow(z, 5) + 16.0 * z * z * z + 3.0 * z) / (96.0 * df * df);
+
+            return t * std::sqrt(m2 / (batches - 1) / batches) / mean;
+        }
+    };
+
+    /**
+     * Adds a scene-specific result to report for the current run.
+     *
+     * Scenes usually add their results in ::teardown().
+     */
+    void add_metric(const std::string &name, const std::string &field,
+                    double value, const std::string &unit, int precision = 3);
+
+    /* Per thread, since scenes may run concurrently with --contexts */
+    static thread_local double shaderCompilationTime_;
+    static thread_local double shaderCacheTime_;
+    static thread_local unsigned int shaderCacheHits_;
+    static thread_local unsigned int shaderCacheMisses_;
     Canvas &canvas_;
     std::string name_;
     std::map<std::string, Option> options_;
@@ -274,6 +415,16 @@ protected:
     bool running_;
     double duration_;      // Duration of run in seconds
     unsigned nframes_;
+    bool autoDuration_;    // Whether to run until the results are precise enough
+    double targetPrecision_;
+    double minDuration_;
+    double maxDuration_;
+    FrameTimeStats frameTimes_;
+    std::vector<Metric> metrics_;
+
+private:
+    static bool load_cached_program(Program &program, const ProgramCache::Shaders &shaders);
+    static void store_cached_program(Program &program, const ProgramCache::Shaders &shaders);
 };
 
 /*
@@ -354,6 +505,7 @@ class SceneShading : public Scene
 {
 public:
     SceneShading(Canvas &pCanvas);
+    bool supported(bool show_errors);
     void update();
     void draw();
     ValidationResult validate();
@@ -367,6 +519,14 @@ protected:
     void teardown();
 
     Program program_;
+    Program::SymbolHandle modelViewProjectionHandle_;
+    Program::SymbolHandle normalMatrixHandle_;
+    Program::SymbolHandle modelViewHandle_;
+    bool useUniformBuffer_;
+    UniformBuffer transformBuffer_;
+    size_t modelViewProjectionOffset_;
+    size_t normalMatrixOffset_;
+    size_t modelViewOffset_;
     float radius_;
     bool orientModel_;
     float orientationAngle_;
@@ -440,6 +600,8 @@ class SceneBump : public Scene
 {
 public:
     SceneBump(Canvas &pCanvas);
+    void assets(const std::map<std::string, std::string> &values, Assets &assets) const;
+    bool supported(bool show_errors);
     void update();
     void draw();
     ValidationResult validate();
@@ -457,7 +619,14 @@ protected:
     GLuint texture_;
     float rotation_;
     float rotationSpeed_;
+    bool useUniformBuffer_;
+    UniformBuffer transformBuffer_;
+    size_t modelViewProjectionOffset_;
+    size_t normalMatrixOffset_;
+    Program::SymbolHandle modelViewProjectionHandle_;
+    Program::SymbolHandle normalMatrixHandle_;
 private:
+    bool load_shaders(ShaderSource &vtx_source, ShaderSource &frg_source);
     bool setup_model_plain(const std::string &type);
     bool setup_model_normals();
     bool setup_model_normals_tangent();
@@ -468,6 +637,7 @@ class SceneEffect2D : public Scene
 {
 public:
     SceneEffect2D(Canvas &pCanvas);
+    void assets(const std::map<std::string, std::string> &values, Assets &assets) const;
     void update();
     void draw();
     ValidationResult validate();
@@ -489,6 +659,7 @@ class ScenePulsar : public Scene
 {
 public:
     ScenePulsar(Canvas &pCanvas);
+    void assets(const std::map<std::string, std::string> &values, Assets &assets) const;
     void update();
     void draw();
     ValidationResult validate();
@@ -519,6 +690,7 @@ class SceneDesktop : public Scene
 {
 public:
     SceneDesktop(Canvas &canvas);
+    void assets(const std::map<std::string, std::string> &values, Assets &assets) const;
     bool supported(bool show_errors);
     void update();
     void draw();
@@ -553,6 +725,241 @@ private:
     SceneBufferPrivate *priv_;
 };
 
+struct SceneReadbackPrivate;
+
+class SceneReadback : public Scene
+{
+public:
+    SceneReadback(Canvas &canvas);
+    bool supported(bool show_errors);
+    void draw();
+    ValidationResult validate();
+
+    ~SceneReadback();
+
+private:
+    bool setup();
+    void teardown();
+    SceneReadbackPrivate *priv_;
+};
+
+struct SceneTexturePackingPrivate;
+
+class SceneTexturePacking : public Scene
+{
+public:
+    SceneTexturePacking(Canvas &canvas);
+    bool supported(bool show_errors);
+    void draw();
+
+    ~SceneTexturePacking();
+
+private:
+    bool setup();
+    void teardown();
+    SceneTexturePackingPrivate *priv_;
+};
+
+struct SceneInstancingPrivate;
+
+class SceneInstancing : public Scene
+{
+public:
+    SceneInstancing(Canvas &canvas);
+    bool supported(bool show_errors);
+    void draw();
+
+    ~SceneInstancing();
+
+private:
+    bool setup();
+    void teardown();
+    SceneInstancingPrivate *priv_;
+};
+
+struct SceneDrawOverheadPrivate;
+
+class SceneDrawOverhead : public Scene
+{
+public:
+    SceneDrawOverhead(Canvas &canvas);
+    void draw();
+
+    ~SceneDrawOverhead();
+
+private:
+    bool setup();
+    void teardown();
+    SceneDrawOverheadPrivate *priv_;
+};
+
+struct SceneMRTPrivate;
+
+class SceneMRT : public Scene
+{
+public:
+    SceneMRT(Canvas &canvas);
+    bool supported(bool show_errors);
+    void draw();
+
+    ~SceneMRT();
+
+private:
+    bool setup();
+    void teardown();
+    SceneMRTPrivate *priv_;
+};
+
+struct SceneDeferredPrivate;
+
+class SceneDeferred : public Scene
+{
+public:
+    SceneDeferred(Canvas &canvas);
+    bool supported(bool show_errors);
+    void draw();
+
+    ~SceneDeferred();
+
+private:
+    bool setup();
+    void teardown();
+    SceneDeferredPrivate *priv_;
+};
+
+/**
+ * The base of the scenes that benchmark compute shaders.
+ */
+class SceneCompute : public Scene
+{
+public:
+    SceneCompute(Canvas &pCanvas, const std::string &name);
+    bool supported(bool show_errors);
+
+    ~SceneCompute();
+
+protected:
+    /* The number of work groups per dimension that all implementations support */
+    static const unsigned int max_work_groups = 65535;
+
+    /**
+     * Loads a compute shader program, declaring the GLSL version it needs.
+     *
+     * @return whether the operation succeeded
+     */
+    static bool load_compute_shader(Program &program, ShaderSource &source);
+
+    /**
+     * Gets the number of work groups needed to cover some elements.
+     */
+    static unsigned int work_groups(unsigned int elements, unsigned int group_size)
+    {
+        return (elements + group_size - 1) / group_size;
+    }
+};
+
+struct SceneComputePrefixSumPrivate;
+
+class SceneComputePrefixSum : public SceneCompute
+{
+public:
+    SceneComputePrefixSum(Canvas &canvas);
+    void draw();
+    ValidationResult validate();
+
+    ~SceneComputePrefixSum();
+
+private:
+    bool setup();
+    void teardown();
+    SceneComputePrefixSumPrivate *priv_;
+};
+
+struct SceneComputeBlurPrivate;
+
+class SceneComputeBlur : public SceneCompute
+{
+public:
+    SceneComputeBlur(Canvas &canvas);
+    void draw();
+
+    ~SceneComputeBlur();
+
+private:
+    bool setup();
+    void teardown();
+    SceneComputeBlurPrivate *priv_;
+};
+
+struct SceneComputeNBodyPrivate;
+
+class SceneComputeNBody : public SceneCompute
+{
+public:
+    SceneComputeNBody(Canvas &canvas);
+    void draw();
+
+    ~SceneComputeNBody();
+
+private:
+    bool setup();
+    void teardown();
+    SceneComputeNBodyPrivate *priv_;
+};
+
+struct SceneParticlesPrivate;
+
+class SceneParticles : public Scene
+{
+public:
+    SceneParticles(Canvas &canvas);
+    bool supported(bool show_errors);
+    void draw();
+
+    ~SceneParticles();
+
+private:
+    bool setup();
+    void teardown();
+    SceneParticlesPrivate *priv_;
+};
+
+struct SceneShaderCompilePrivate;
+
+class SceneShaderCompile : public Scene
+{
+public:
+    SceneShaderCompile(Canvas &canvas);
+    bool supported(bool show_errors);
+    void draw();
+    ValidationResult validate();
+
+    ~SceneShaderCompile();
+
+private:
+    bool setup();
+    void teardown();
+    void check_program(unsigned int program);
+    SceneShaderCompilePrivate *priv_;
+};
+
+struct SceneImageDecodePrivate;
+
+class SceneImageDecode : public Scene
+{
+public:
+    SceneImageDecode(Canvas &canvas);
+    void draw();
+    ValidationResult validate();
+
+    ~SceneImageDecode();
+
+private:
+    bool setup();
+    void teardown();
+    SceneImageDecodePrivate *priv_;
+};
+
 class SceneIdeasPrivate;
 
 class SceneIdeas : public Scene
@@ -579,6 +986,7 @@ class SceneTerrain : public Scene
 {
 public:
     SceneTerrain(Canvas &pCanvas);
+    void assets(const std::map<std::string, std::string> &values, Assets &assets) const;
     bool supported(bool show_errors);
     void update();
     void draw();
@@ -600,6 +1008,7 @@ class SceneJellyfish : public Scene
     JellyfishPrivate* priv_;
 public:
     SceneJellyfish(Canvas &pCanvas);
+    void assets(const std::map<std::string, std::string> &values, Assets &assets) const;
     ~SceneJellyfish();
     void update();
     void draw();
@@ -616,6 +1025,7 @@ class SceneShadow : public Scene
     ShadowPrivate* priv_;
 public:
     SceneShadow(Canvas& canvas);
+    void assets(const std::map<std::string, std::string> &values, Assets &assets) const;
     bool supported(bool show_errors);
     void update();
     void draw();
@@ -0,0 +1,311 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "soak-monitor.h"
+#include "gl-headers.h"
+#include "log.h"
+#include "options.h"
+#include "results-file.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+/* The most runs of each benchmark kept for the drift test */
+const size_t max_samples = 1000;
+/* The fewest runs the drift test needs */
+const size_t min_drift_samples = 8;
+/* The number of shuffles of the bootstrap, and the confidence to reach */
+const unsigned int bootstrap_count = 1000;
+const double drift_confidence = 0.99;
+
+/**
+ * Gets the range of the cumulative sums of the differences from the mean,
+ * and where their magnitude is largest.
+ */
+double
+cusum_range(const std::vector<double> &values, double mean, size_t *peak)
+{
+    double sum = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double peak_value = 0.0;
+
+    for (size_t i = 0; i < values.size(); i++) {
+        sum += values[i] - mean;
+        min = std::min(min, sum);
+        max = std::max(max, sum);
+        if (peak && std::fabs(sum) > peak_value) {
+            peak_value = std::fabs(sum);
+            *peak = i;
+        }
+    }
+
+    return max - min;
+}
+
+std::string
+mib_string(double bytes)
+{
+    return Util::toString(bytes / (1024.0 * 1024.0), 1);
+}
+
+}
+
+SoakMonitor::SoakMonitor() :
+    start_(Util::get_timestamp_us() / 1000000.0), last_summary_(start_),
+    start_rss_(0.0)
+{
+}
+
+void
+SoakMonitor::add_result(const Benchmark &benchmark, const std::string &name, double fps)
+{
+    auto iter = history_index_.find(&benchmark);
+    if (iter == history_index_.end()) {
+        /* Only count the memory growth after everything has been set up once */
+        if (histories_.empty())
+            start_rss_ = rss_bytes();
+        iter = history_index_.emplace(&benchmark, histories_.size()).first;
+        histories_.push_back(History{name, 0, 0, std::deque<Sample>()});
+    }
+
+    History &history(histories_[iter->second]);
+    history.runs++;
+
+    if (fps < 0.0) {
+        history.failures++;
+        return;
+    }
+
+    history.samples.push_back(Sample{elapsed(), fps, count_gl_objects()});
+    if (history.samples.size() > max_samples)
+        history.samples.pop_front();
+}
+
+bool
+SoakMonitor::summary_due() const
+{
+    return Util::get_timestamp_us() / 1000000.0 - last_summary_ >= Options::soak_interval;
+}
+
+void
+SoakMonitor::log_summary()
+{
+    static const std::string format_bench(Log::continuation_prefix +
+                                          " FPS: %s (stddev: %s min: %s max: %s last: %zu of %u runs)"
+                                          " GLObjects: %u Drift: %s\n");
+    ResultsFile &results_file = ResultsFile::get();
+    std::string soak_time(Util::toString(elapsed(), 0));
+    double rss = rss_bytes();
+    std::string rss_str("unknown");
+
+    if (rss >= 0.0) {
+        rss_str = mib_string(rss) + " MiB (" + (rss >= start_rss_ ? "+" : "-") +
+                  mib_string(std::fabs(rss - start_rss_)) + " MiB)";
+    }
+
+    last_summary_ = Util::get_timestamp_us() / 1000000.0;
+
+    Log::info("=======================================================\n");
+    Log::info("    Soak: %s s RSS: %s\n", soak_time.c_str(), rss_str.c_str());
+
+    for (const History &history : histories_) {
+        if (history.samples.empty()) {
+            Log::info("%s: Failed %u of %u runs\n", history.name.c_str(),
+                      history.failures, history.runs);
+            continue;
+        }
+
+        /* The statistics of the latest runs */
+        size_t window = std::min<size_t>(history.samples.size(), Options::soak_window);
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        double min = HUGE_VAL;
+        double max = 0.0;
+
+        for (size_t i = history.samples.size() - window; i < history.samples.size(); i++) {
+            double fps = history.samples[i].fps;
+            sum += fps;
+            sum_sq += fps * fps;
+            min = std::min(min, fps);
+            max = std::max(max, fps);
+        }
+
+        double mean = sum / window;
+        double stddev = window > 1 ?
+            std::sqrt(std::max(0.0, (sum_sq - sum * mean) / (window - 1))) : 0.0;
+
+        std::string drift_str("none");
+        std::string drift_time;
+        Drift drift = detect_drift(history.samples);
+        if (drift.detected) {
+            double change = 100.0 * (drift.after - drift.before) / drift.before;
+            drift_time = Util::toString(drift.time, 0);
+            drift_str = (change >= 0.0 ? "+" : "") + Util::toString(change, 1) +
+                        "% at " + drift_time + " s";
+        }
+
+        std::string mean_str(Util::toString(mean, 1));
+        std::string stddev_str(Util::toString(stddev, 1));
+        std::string min_str(Util::toString(min, 1));
+        std::string max_str(Util::toString(max, 1));
+        unsigned int gl_objects = history.samples.back().gl_objects;
+
+        Log::info("%s:", history.name.c_str());
+        Log::info(format_bench.c_str(), mean_str.c_str(), stddev_str.c_str(),
+                  min_str.c_str(), max_str.c_str(), window, history.runs, gl_objects,
+                  drift_str.c_str());
+
+        results_file.begin_benchmark();
+        results_file.add_field("name", history.name);
+        results_file.add_field("soak_time", soak_time);
+        results_file.add_field("runs", Util::toString(history.runs));
+        results_file.add_field("failures", Util::toString(history.failures));
+        results_file.add_field("fps_mean", mean_str);
+        results_file.add_field("fps_stddev", stddev_str);
+        results_file.add_field("fps_min", min_str);
+        results_file.add_field("fps_max", max_str);
+        results_file.add_field("gl_objects", Util::toString(gl_objects));
+        results_file.add_field("rss", rss >= 0.0 ? mib_string(rss) : "");
+        results_file.add_field("drift", drift.detected ?
+                               Util::toString(100.0 * (drift.after - drift.before) /
+                                              drift.before, 1) : "");
+        results_file.add_field("drift_time", drift_time);
+        results_file.add_field("status", "Summary");
+        results_file.end_benchmark();
+    }
+
+    Log::info("=======================================================\n");
+}
+
+/**
+ * Tests whether the frame rate has changed during the run, with the
+ * CUSUM change-point test, using shuffled copies of the frame rates to
+ * find how likely the observed change would be without a real one.
+ */
+SoakMonitor::Drift
+SoakMonitor::detect_drift(const std::deque<Sample> &samples)
+{
+    Drift drift = Drift();
+
+    if (samples.size() < min_drift_samples)
+        return drift;
+
+    std::vector<double> values;
+    double mean = 0.0;
+    for (const Sample &sample : samples) {
+        values.push_back(sample.fps);
+        mean += sample.fps;
+    }
+    mean /= values.size();
+
+    size_t peak = 0;
+    double range = cusum_range(values, mean, &peak);
+    if (range == 0.0 || peak + 1 >= values.size())
+        return drift;
+
+    /* A fixed seed, so that the same results give the same verdict */
+    std::mt19937 rng(values.size());
+    std::vector<double> shuffled(values);
+    unsigned int smaller = 0;
+
+    for (unsigned int i = 0; i < bootstrap_count; i++) {
+        std::shuffle(shuffled.begin(), shuffled.end(), rng);
+        if (cusum_range(shuffled, mean, nullptr) < range)
+            smaller++;
+    }
+
+    if (smaller < drift_confidence * bootstrap_count)
+        return drift;
+
+    double before = 0.0;
+    double after = 0.0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i <= peak)
+            before += values[i];
+        else
+            after += values[i];
+    }
+
+    drift.detected = true;
+    drift.time = samples[peak + 1].time;
+    drift.before = before / (peak + 1);
+    drift.after = after / (values.size() - peak - 1);
+
+    return drift;
+}
+
+/**
+ * Counts the textures, buffers, programs and shaders of the current
+ * context, by probing their names, which GL implementations allocate
+ * mostly contiguously from 1.
+ */
+unsigned int
+SoakMonitor::count_gl_objects()
+{
+    /* Stop probing after this many consecutive unused names */
+    static const GLuint max_gap = 1024;
+    static const GLuint max_name = 1 << 20;
+    unsigned int count = 0;
+    GLuint last_used = 0;
+
+    for (GLuint name = 1; name - last_used <= max_gap && name < max_name; name++) {
+        unsigned int used = (glIsTexture(name) ? 1 : 0) + (glIsBuffer(name) ? 1 : 0) +
+                            (glIsProgram(name) ? 1 : 0) + (glIsShader(name) ? 1 : 0);
+        if (used) {
+            count += used;
+            last_used = name;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Gets the resident memory of the process in bytes, or a negative value if
+ * it is not known.
+ */
+double
+SoakMonitor::rss_bytes()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    double size = 0.0;
+    double resident = 0.0;
+
+    if (statm >> size >> resident)
+        return resident * sysconf(_SC_PAGESIZE);
+#endif
+    return -1.0;
+}
+
+double
+SoakMonitor::elapsed() const
+{
+    return Util::get_timestamp_us() / 1000000.0 - start_;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_SOAK_MONITOR_H_
+#define GLMARK2_SOAK_MONITOR_H_
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+class Benchmark;
+
+/**
+ * Follows the results of the benchmarks over a long run (see --soak).
+ *
+ * After each run of a benchmark, its frame rate and the number of GL
+ * objects left after the teardown are recorded, and the resident memory of
+ * the process is compared with the one after the first run. Periodic
+ * summaries report, for each benchmark, the frame rate statistics over a
+ * rolling window of its latest runs, and whether its frame rate has
+ * drifted during the whole run, according to a bootstrap CUSUM
+ * change-point test.
+ */
+class SoakMonitor
+{
+public:
+    SoakMonitor();
+
+    /**
+     * Records the result of a run of a benchmark.
+     *
+     * This must be called right after the benchmark has been torn down,
+     * while its GL context is still current.
+     *
+     * @param benchmark the benchmark
+     * @param name the name to report the benchmark with
+     * @param fps the frame rate, or a negative value if the run failed
+     */
+    void add_result(const Benchmark &benchmark, const std::string &name, double fps);
+
+    /**
+     * Whether it is time for the next summary.
+     */
+    bool summary_due() const;
+
+    /**
+     * Reports a summary to the log and the results file.
+     */
+    void log_summary();
+
+private:
+    struct Sample {
+        double time;
+        double fps;
+        unsigned int gl_objects;
+    };
+
+    struct History {
+        std::string name;
+        unsigned int runs;
+        unsigned int failures;
+        std::deque<Sample> samples;
+    };
+
+    struct Drift {
+        bool detected;
+        double time;
+        double before;
+        double after;
+    };
+
+    static Drift detect_drift(const std::deque<Sample> &samples);
+    static unsigned int count_gl_objects();
+    static double rss_bytes();
+    double elapsed() const;
+
+    double start_;
+    double last_summary_;
+    double start_rss_;
+    std::vector<History> histories_;
+    std::map<const Benchmark *, size_t> history_index_;
+};
+
+#endif
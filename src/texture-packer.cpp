@@ -0,0 +1,372 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "texture-packer.h"
+#include "log.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace
+{
+
+/*
+ * The least fraction of an array texture that the images must cover for
+ * ModeAuto to use one: each layer is as large as the largest image, so
+ * images of very different sizes waste most of it.
+ */
+const double min_array_occupancy = 0.5;
+
+}
+
+TexturePacker::TexturePacker(unsigned int padding) :
+    padding_(padding), mode_(ModeAuto), width_(0), height_(0), layers_(0)
+{
+}
+
+bool
+TexturePacker::supports_array()
+{
+    return GLExtensions::TexImage3D && GLExtensions::version_at_least(3, 0);
+}
+
+unsigned int
+TexturePacker::add(unsigned int width, unsigned int height, const uint8_t *pixels)
+{
+    Image image = {width, height, pixels};
+    images_.push_back(image);
+    return images_.size() - 1;
+}
+
+bool
+TexturePacker::pack(Mode mode, GLuint *texture)
+{
+    if (images_.empty())
+        return false;
+
+    regions_.assign(images_.size(), Region());
+
+    if (mode == ModeArray ||
+        (mode == ModeAuto && supports_array() && similar_sizes()))
+    {
+        if (create_array(texture)) {
+            mode_ = ModeArray;
+            return true;
+        }
+        if (mode == ModeArray)
+            return false;
+    }
+
+    if (create_atlas(texture)) {
+        mode_ = ModeAtlas;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Whether the images are similar enough in size to be stored as the
+ * layers of an array texture without wasting most of it.
+ */
+bool
+TexturePacker::similar_sizes() const
+{
+    uint64_t used = 0;
+    unsigned int width = 1;
+    unsigned int height = 1;
+
+    for (auto const &image : images_) {
+        used += static_cast<uint64_t>(image.width) * image.height;
+        width = std::max(width, image.width);
+        height = std::max(height, image.height);
+    }
+
+    double array_occupancy = static_cast<double>(used) /
+                             (static_cast<uint64_t>(width) * height * images_.size());
+
+    if (array_occupancy < min_array_occupancy) {
+        Log::debug("TexturePacker: the images would only cover %.0f%% of an"
+                   " array texture, using an atlas\n", 100.0 * array_occupancy);
+        return false;
+    }
+
+    return true;
+}
+
+double
+TexturePacker::occupancy() const
+{
+    uint64_t used = 0;
+    for (auto const &image : images_)
+        used += static_cast<uint64_t>(image.width) * image.height;
+
+    uint64_t total = static_cast<uint64_t>(width_) * height_ * layers_;
+
+    return total ? static_cast<double>(used) / total : 0.0;
+}
+
+/**
+ * Finds a position for each image in an atlas of the specified size.
+ *
+ * The skyline is the list of segments that form the upper outline of the
+ * images placed so far. Images are placed, tallest first, on top of the
+ * skyline at the position where their top edge ends up lowest.
+ */
+bool
+TexturePacker::pack_atlas(unsigned int width, unsigned int height,
+                          std::vector<unsigned int> &xs, std::vector<unsigned int> &ys)
+{
+    std::vector<unsigned int> order(images_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [this](unsigned int a, unsigned int b) {
+            if (images_[a].height != images_[b].height)
+                return images_[a].height > images_[b].height;
+            return images_[a].width > images_[b].width;
+        });
+
+    std::vector<SkylineSegment> skyline(1, SkylineSegment{0, 0, width});
+
+    xs.resize(images_.size());
+    ys.resize(images_.size());
+
+    for (unsigned int idx : order) {
+        unsigned int w = images_[idx].width + 2 * padding_;
+        unsigned int h = images_[idx].height + 2 * padding_;
+        size_t best = skyline.size();
+        unsigned int best_top = UINT_MAX;
+        unsigned int best_y = 0;
+
+        for (size_t i = 0; i < skyline.size(); i++) {
+            unsigned int x = skyline[i].x;
+            if (x + w > width)
+                break;
+
+            /* The image rests on the highest segment it spans */
+            unsigned int y = 0;
+            unsigned int remaining = w;
+            for (size_t j = i; remaining > 0 && j < skyline.size(); j++) {
+                y = std::max(y, skyline[j].y);
+                remaining -= std::min(remaining, skyline[j].width);
+            }
+
+            if (y + h <= height && y + h < best_top) {
+                best = i;
+                best_top = y + h;
+                best_y = y;
+            }
+        }
+
+        if (best == skyline.size())
+            return false;
+
+        unsigned int x = skyline[best].x;
+        xs[idx] = x;
+        ys[idx] = best_y;
+
+        /* Raise the skyline over the new image */
+        skyline.insert(skyline.begin() + best, SkylineSegment{x, best_top, w});
+
+        size_t next = best + 1;
+        while (next < skyline.size() && skyline[next].x < x + w) {
+            unsigned int overlap = x + w - skyline[next].x;
+            if (skyline[next].width <= overlap) {
+                skyline.erase(skyline.begin() + next);
+            }
+            else {
+                skyline[next].x += overlap;
+                skyline[next].width -= overlap;
+                break;
+            }
+        }
+
+        for (size_t i = 0; i + 1 < skyline.size();) {
+            if (skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            }
+            else {
+                i++;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool
+TexturePacker::create_atlas(GLuint *texture)
+{
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+
+    uint64_t area = 0;
+    unsigned int min_side = 1;
+    for (auto const &image : images_) {
+        area += static_cast<uint64_t>(image.width + 2 * padding_) *
+                (image.height + 2 * padding_);
+        min_side = std::max(min_side, std::max(image.width, image.height) + 2 * padding_);
+    }
+
+    /* Start from the smallest power of two square that could fit everything */
+    unsigned int side = 1;
+    while (side < min_side || static_cast<uint64_t>(side) * side < area)
+        side *= 2;
+
+    unsigned int width = side;
+    unsigned int height = side;
+    std::vector<unsigned int> xs;
+    std::vector<unsigned int> ys;
+
+    while (!pack_atlas(width, height, xs, ys)) {
+        if (width == height)
+            width *= 2;
+        else
+            height *= 2;
+
+        if (width > static_cast<unsigned int>(max_size) ||
+            height > static_cast<unsigned int>(max_size))
+        {
+            Log::debug("TexturePacker: The images don't fit in a %dx%d atlas\n",
+                       max_size, max_size);
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+
+    for (size_t i = 0; i < images_.size(); i++) {
+        const Image &image = images_[i];
+        blit(image, pixels.data(), width, xs[i], ys[i],
+             image.width + 2 * padding_, image.height + 2 * padding_, padding_);
+
+        Region &region = regions_[i];
+        region.offset = LibMatrix::vec2(static_cast<float>(xs[i] + padding_) / width,
+                                        static_cast<float>(ys[i] + padding_) / height);
+        region.scale = LibMatrix::vec2(static_cast<float>(image.width) / width,
+                                       static_cast<float>(image.height) / height);
+        region.layer = 0;
+    }
+
+    glGenTextures(1, texture);
+    glBindTexture(GL_TEXTURE_2D, *texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    width_ = width;
+    height_ = height;
+    layers_ = 1;
+
+    return true;
+}
+
+bool
+TexturePacker::create_array(GLuint *texture)
+{
+    GLint max_size = 0;
+    GLint max_layers = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+
+    unsigned int width = 1;
+    unsigned int height = 1;
+    for (auto const &image : images_) {
+        width = std::max(width, image.width);
+        height = std::max(height, image.height);
+    }
+
+    if (width > static_cast<unsigned int>(max_size) ||
+        height > static_cast<unsigned int>(max_size) ||
+        images_.size() > static_cast<size_t>(max_layers))
+    {
+        Log::debug("TexturePacker: %zu images of up to %ux%u don't fit in an"
+                   " array texture\n", images_.size(), width, height);
+        return false;
+    }
+
+    /*
+     * Smaller images occupy the lower left corner of their layer, and the
+     * rest of the layer repeats their edges.
+     */
+    const size_t layer_size = static_cast<size_t>(width) * height * 4;
+    std::vector<uint8_t> pixels(layer_size * images_.size());
+
+    for (size_t i = 0; i < images_.size(); i++) {
+        const Image &image = images_[i];
+        blit(image, &pixels[i * layer_size], width, 0, 0, width, height, 0);
+
+        Region &region = regions_[i];
+        region.offset = LibMatrix::vec2(0.0, 0.0);
+        region.scale = LibMatrix::vec2(static_cast<float>(image.width) / width,
+                                       static_cast<float>(image.height) / height);
+        region.layer = i;
+    }
+
+    glGenTextures(1, texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, *texture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLExtensions::TexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height,
+                             images_.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                             pixels.data());
+
+    width_ = width;
+    height_ = height;
+    layers_ = images_.size();
+
+    return true;
+}
+
+/**
+ * Copies an image into a rectangle of a larger image.
+ *
+ * The image is placed @border pixels from the lower left corner of the
+ * rectangle, and any part of the rectangle not covered by the image gets
+ * the color of the nearest edge pixel of the image.
+ */
+void
+TexturePacker::blit(const Image &image, uint8_t *dst, unsigned int dst_width,
+                    unsigned int x, unsigned int y, unsigned int width,
+                    unsigned int height, unsigned int border)
+{
+    for (unsigned int row = 0; row < height; row++) {
+        int src_row = std::clamp(static_cast<int>(row) - static_cast<int>(border),
+                                 0, static_cast<int>(image.height) - 1);
+        const uint8_t *src = image.pixels + static_cast<size_t>(src_row) * image.width * 4;
+        uint8_t *d = dst + (static_cast<size_t>(y + row) * dst_width + x) * 4;
+
+        for (unsigned int col = 0; col < border; col++)
+            memcpy(d + col * 4, src, 4);
+
+        unsigned int copy = std::min(image.width, width - border);
+        memcpy(d + border * 4, src, copy * 4);
+
+        for (unsigned int col = border + copy; col < width; col++)
+            memcpy(d + col * 4, src + (image.width - 1) * 4, 4);
+    }
+}
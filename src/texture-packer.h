@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2026 Linaro Limited
+ *
+ * This file is part of the glmark2 OpenGL (ES) 2.0 benchmark.
+ *
+ * glmark2 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * glmark2 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * glmark2.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GLMARK2_TEXTURE_PACKER_H_
+#define GLMARK2_TEXTURE_PACKER_H_
+
+#include "gl-headers.h"
+#include "vec.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Packs a set of images into a single texture.
+ *
+ * The images are either packed into a 2D atlas, using a skyline bottom-left
+ * packer, or stored as the layers of a 2D array texture. In both cases the
+ * location of each image is described by a Region, which can be used to
+ * remap texture coordinates from the [0, 1] range of the individual image
+ * (see Mesh::remap_texcoords()).
+ *
+ * Images are RGBA, 8 bits per component, with rows stored bottom to top as
+ * expected by glTexImage2D().
+ */
+class TexturePacker
+{
+public:
+    enum Mode {
+        ModeAuto,
+        ModeAtlas,
+        ModeArray,
+    };
+
+    struct Region {
+        Region() : offset(0.0, 0.0), scale(1.0, 1.0), layer(0) {}
+        /** The texture coordinates of the lower left corner of the image */
+        LibMatrix::vec2 offset;
+        /** The size of the image in texture coordinates */
+        LibMatrix::vec2 scale;
+        /** The array layer holding the image (always 0 for atlases) */
+        unsigned int layer;
+    };
+
+    /**
+     * Creates a packer.
+     *
+     * @param padding the number of pixels around each image in an atlas
+     *                that are filled with the image's edge pixels, to
+     *                avoid bleeding between images when filtering
+     */
+    TexturePacker(unsigned int padding = 1);
+
+    /**
+     * Whether 2D array textures are supported by the current context.
+     */
+    static bool supports_array();
+
+    /**
+     * Adds an image to pack.
+     *
+     * @param width the width of the image
+     * @param height the height of the image
+     * @param pixels the image data, which must stay valid until pack()
+     *
+     * @return the index of the image
+     */
+    unsigned int add(unsigned int width, unsigned int height, const uint8_t *pixels);
+
+    /**
+     * Packs the added images and creates the texture.
+     *
+     * ModeAuto creates an array texture if the context supports them, the
+     * images are similar in size, so that they cover at least half of the
+     * array, and all of them fit in a single array, otherwise an atlas.
+     *
+     * @param mode how to pack the images
+     * @param texture the created texture, bound to GL_TEXTURE_2D or
+     *                GL_TEXTURE_2D_ARRAY depending on the resulting mode()
+     *
+     * @return whether packing succeeded
+     */
+    bool pack(Mode mode, GLuint *texture);
+
+    /**
+     * Gets the region of an image in the packed texture.
+     */
+    const Region &region(unsigned int image) const { return regions_[image]; }
+
+    /**
+     * Gets the mode that was actually used for packing.
+     */
+    Mode mode() const { return mode_; }
+
+    unsigned int width() const { return width_; }
+    unsigned int height() const { return height_; }
+    unsigned int layers() const { return layers_; }
+
+    /**
+     * Gets the fraction of the texture area that is covered by images.
+     */
+    double occupancy() const;
+
+private:
+    struct Image {
+        unsigned int width;
+        unsigned int height;
+        const uint8_t *pixels;
+    };
+
+    struct SkylineSegment {
+        unsigned int x;
+        unsigned int y;
+        unsigned int width;
+    };
+
+    bool similar_sizes() const;
+    bool pack_atlas(unsigned int width, unsigned int height,
+                    std::vector<unsigned int> &xs, std::vector<unsigned int> &ys);
+    bool create_atlas(GLuint *texture);
+    bool create_array(GLuint *texture);
+    void blit(const Image &image, uint8_t *dst, unsigned int dst_width,
+              unsigned int x, unsigned int y, unsigned int width,
+              unsigned int height, unsigned int border);
+
+    unsigned int padding_;
+    std::vector<Image> images_;
+    std::vector<Region> regions_;
+    Mode mode_;
+    unsigned int width_;
+    unsigned int height_;
+    unsigned int layers_;
+};
+
+#endif
@@ -29,6 +29,7 @@
 
 #include <algorithm>
 #include <cstdarg>
+#include <mutex>
 #include <vector>
 
 class ImageData {
@@ -98,40 +99,64 @@ setup_texture(GLuint *tex, ImageData &image, GLint min_filter, GLint mag_filter)
 namespace TexturePrivate
 {
 TextureMap textureMap;
-}
 
-bool
-Texture::load(const std::string &textureName, GLuint *pTexture, ...)
+/* The textures decoded ahead of time by Texture::prefetch() */
+std::map<std::string, std::shared_ptr<ImageData>> prefetched;
+std::mutex prefetchedMutex;
+
+std::shared_ptr<ImageData>
+decode(const std::string &textureName)
 {
     // Make sure the named texture is in the map.
-    TextureMap::const_iterator textureIt = TexturePrivate::textureMap.find(textureName);
-    if (textureIt == TexturePrivate::textureMap.end())
+    TextureMap::const_iterator textureIt = textureMap.find(textureName);
+    if (textureIt == textureMap.end())
     {
-        return false;
+        return nullptr;
     }
 
     // Pull the pathname out of the descriptor and use it for the PNG load.
     TextureDescriptor* desc = textureIt->second.get();
-    ImageData image;
+    std::shared_ptr<ImageData> image(new ImageData());
 
     if (desc->filetype() == TextureDescriptor::FileTypePNG) {
         PNGReader reader(desc->pathname());
-        if (!image.load(reader))
-            return false;
+        if (!image->load(reader))
+            return nullptr;
     }
     else if (desc->filetype() == TextureDescriptor::FileTypeJPEG) {
         JPEGReader reader(desc->pathname());
-        if (!image.load(reader))
-            return false;
+        if (!image->load(reader))
+            return nullptr;
+    }
+
+    return image;
+}
+}
+
+bool
+Texture::load(const std::string &textureName, GLuint *pTexture, ...)
+{
+    std::shared_ptr<ImageData> image;
+
+    {
+        std::lock_guard<std::mutex> lock(TexturePrivate::prefetchedMutex);
+        auto iter = TexturePrivate::prefetched.find(textureName);
+        if (iter != TexturePrivate::prefetched.end())
+            image = iter->second;
     }
 
+    if (!image)
+        image = TexturePrivate::decode(textureName);
+    if (!image)
+        return false;
+
     va_list ap;
     va_start(ap, pTexture);
     GLint arg;
 
     while ((arg = va_arg(ap, GLint)) != 0) {
         GLint arg2 = va_arg(ap, GLint);
-        setup_texture(pTexture, image, arg, arg2);
+        setup_texture(pTexture, *image, arg, arg2);
         pTexture++;
     }
 
@@ -140,6 +165,26 @@ Texture::load(const std::string &textureName, GLuint *pTexture, ...)
     return true;
 }
 
+bool
+Texture::prefetch(const std::string &textureName)
+{
+    std::shared_ptr<ImageData> image(TexturePrivate::decode(textureName));
+    if (!image)
+        return false;
+
+    std::lock_guard<std::mutex> lock(TexturePrivate::prefetchedMutex);
+    TexturePrivate::prefetched[textureName] = image;
+
+    return true;
+}
+
+void
+Texture::clear_prefetched()
+{
+    std::lock_guard<std::mutex> lock(TexturePrivate::prefetchedMutex);
+    TexturePrivate::prefetched.clear();
+}
+
 const TextureMap&
 Texture::find_textures()
 {
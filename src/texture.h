@@ -74,6 +74,22 @@ public:
      * @return:      true if the operation succeeded, false otherwise
      */
     static bool load(const std::string &name, GLuint *pTexture, ...);
+    /**
+     * Decodes a texture ahead of time, so that a later ::load() only needs
+     * to upload it.
+     *
+     * This doesn't use the GL, so it can be called from any thread, but
+     * Texture::find_textures() must have been called before.
+     *
+     * @name:        the texture name
+     *
+     * @return:      true if the operation succeeded, false otherwise
+     */
+    static bool prefetch(const std::string &name);
+    /**
+     * Drops the textures decoded by ::prefetch().
+     */
+    static void clear_prefetched();
     /**
      * Locate all available textures.
      *